@@ -111,7 +111,11 @@ void Configuration::ParseKovriConfig() {
     ("enable-ssu", bpo::value<bool>()->default_value(true))
     ("enable-ntcp", bpo::value<bool>()->default_value(true))
     ("reseed-from,r", bpo::value<std::string>()->default_value(""))
-    ("reseed-skip-ssl-check", bpo::value<bool>()->default_value(false));
+    ("reseed-skip-ssl-check", bpo::value<bool>()->default_value(false))
+    ("tunnel-workers", bpo::value<std::uint16_t>()->default_value(1))
+    ("transport-threads", bpo::value<std::uint16_t>()->default_value(1))
+    ("ssu-shards", bpo::value<std::uint16_t>()->default_value(1))
+    ("ntcp-send-queue-size", bpo::value<std::uint32_t>()->default_value(1024));
 
   bpo::options_description client("\nclient");
   client.add_options()
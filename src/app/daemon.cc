@@ -44,6 +44,8 @@
 
 #include "client/context.h"
 
+#include "core/crypto/elgamal.h"
+
 #include "core/router/net_db/impl.h"
 #include "core/router/transports/impl.h"
 #include "core/router/tunnel/impl.h"
@@ -110,6 +112,9 @@ bool DaemonSingleton::Start() {
         return false;
       }
     }
+    // Tunnel builds and garlic sessions need ElGamal keys as soon as we start
+    LOG(debug) << "DaemonSingleton: starting ElGamal keys supplier";
+    kovri::core::ElGamalKeysSupplier::Instance().Start();
     LOG(debug) << "DaemonSingleton: starting transports";
     kovri::core::transports.Start();
     LOG(debug) << "DaemonSingleton: starting tunnels";
@@ -143,6 +148,8 @@ bool DaemonSingleton::Stop() {
     kovri::core::tunnels.Stop();
     LOG(debug) << "DaemonSingleton: stopping transports";
     kovri::core::transports.Stop();
+    LOG(debug) << "DaemonSingleton: stopping ElGamal keys supplier";
+    kovri::core::ElGamalKeysSupplier::Instance().Stop();
     LOG(debug) << "DaemonSingleton: stopping NetDb";
     kovri::core::netdb.Stop();
   } catch (const std::exception& ex) {
@@ -33,6 +33,7 @@
 #include "app/instance.h"
 
 #include <cstdint>
+#include <limits>
 #include <stdexcept>
 #include <memory>
 #include <vector>
@@ -115,6 +116,22 @@ void Instance::InitRouterContext() {
   // Set transport options
   context.SetSupportsNTCP(map["enable-ntcp"].as<bool>());
   context.SetSupportsSSU(map["enable-ssu"].as<bool>());
+  context.SetOptionTransportThreads(
+      map["transport-threads"].as<std::uint16_t>());
+  context.SetOptionSSUShards(map["ssu-shards"].as<std::uint16_t>());
+  // Given in KB, so clamp before scaling to bytes in case size_t is 32 bits
+  const std::size_t max_send_queue_kb =
+    std::numeric_limits<std::size_t>::max() / 1024;
+  std::size_t send_queue_kb = map["ntcp-send-queue-size"].as<std::uint32_t>();
+  if (send_queue_kb > max_send_queue_kb) {
+    LOG(warning)
+      << "Instance: ntcp-send-queue-size " << send_queue_kb
+      << " KB is too large, using " << max_send_queue_kb << " KB";
+    send_queue_kb = max_send_queue_kb;
+  }
+  context.SetOptionNTCPSendQueueSize(send_queue_kb * 1024);
+  // Set tunnel options
+  context.SetOptionTunnelWorkers(map["tunnel-workers"].as<std::uint16_t>());
 }
 
 // TODO(unassigned): see TODO's for router/client context and singleton
@@ -270,6 +270,15 @@ I2PControlSession::I2PControlSession(
   m_RouterInfoHandlers[ROUTER_INFO_BW_OB_1S] =
     &I2PControlSession::HandleOutBandwidth1S;
 
+  m_RouterInfoHandlers[ROUTER_INFO_SEND_QUEUE_SIZE] =
+    &I2PControlSession::HandleSendQueueSize;
+
+  m_RouterInfoHandlers[ROUTER_INFO_SEND_QUEUE_DROPPED] =
+    &I2PControlSession::HandleSendQueueDropped;
+
+  m_RouterInfoHandlers[ROUTER_INFO_SSU_ACKS_SAVED] =
+    &I2PControlSession::HandleSSUACKsSaved;
+
   // RouterManager handlers
   m_RouterManagerHandlers[ROUTER_MANAGER_SHUTDOWN] =
     &I2PControlSession::HandleShutdown;
@@ -511,7 +520,7 @@ void I2PControlSession::HandleTunnelsParticipating(
     Response& response) {
   response.SetParam(
       ROUTER_INFO_TUNNELS_PARTICIPATING,
-      static_cast<int>(kovri::core::tunnels.GetTransitTunnels().size()));
+      static_cast<int>(kovri::core::tunnels.GetNumTransitTunnels()));
 }
 
 void I2PControlSession::HandleTunnelsCreationSuccess(
@@ -564,6 +573,27 @@ void I2PControlSession::HandleOutBandwidth1S(
       static_cast<double>(kovri::core::transports.GetOutBandwidth()));
 }
 
+void I2PControlSession::HandleSendQueueSize(
+    Response& response) {
+  response.SetParam(
+      ROUTER_INFO_SEND_QUEUE_SIZE,
+      static_cast<double>(kovri::core::transports.GetTotalQueuedBytes()));
+}
+
+void I2PControlSession::HandleSendQueueDropped(
+    Response& response) {
+  response.SetParam(
+      ROUTER_INFO_SEND_QUEUE_DROPPED,
+      static_cast<double>(kovri::core::transports.GetTotalDroppedMessages()));
+}
+
+void I2PControlSession::HandleSSUACKsSaved(
+    Response& response) {
+  response.SetParam(
+      ROUTER_INFO_SSU_ACKS_SAVED,
+      static_cast<double>(kovri::core::transports.GetTotalSavedACKPackets()));
+}
+
 void I2PControlSession::HandleShutdown(
     Response& response) {
   LOG(info) << "I2PControlSession: shutdown requested";
@@ -122,6 +122,15 @@ const char ROUTER_INFO_BW_IB_1S[] =
 const char ROUTER_INFO_BW_OB_1S[] =
   "i2p.router.net.bw.outbound.1s";
 
+const char ROUTER_INFO_SEND_QUEUE_SIZE[] =
+  "i2p.router.net.sendqueue.size";
+
+const char ROUTER_INFO_SEND_QUEUE_DROPPED[] =
+  "i2p.router.net.sendqueue.dropped";
+
+const char ROUTER_INFO_SSU_ACKS_SAVED[] =
+  "i2p.router.net.ssu.acks.saved";
+
 // RouterManager requests
 const char ROUTER_MANAGER_SHUTDOWN[] = "Shutdown";
 const char ROUTER_MANAGER_SHUTDOWN_GRACEFUL[] = "ShutdownGraceful";
@@ -301,6 +310,10 @@ class I2PControlSession
   void HandleInBandwidth1S(Response& response);
   void HandleOutBandwidth1S(Response& response);
 
+  void HandleSendQueueSize(Response& response);
+  void HandleSendQueueDropped(Response& response);
+  void HandleSSUACKsSaved(Response& response);
+
   // RouterManager handlers
   void HandleShutdown(Response& response);
   void HandleShutdownGraceful(Response& response);
@@ -33,13 +33,18 @@
 #ifndef SRC_CORE_CRYPTO_ELGAMAL_H_
 #define SRC_CORE_CRYPTO_ELGAMAL_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 
 namespace kovri {
 namespace core {
 
+const std::size_t ELGAMAL_PRECOMPUTED_KEYS_SIZE = 32;  // (k, g^k) pairs kept ready
+
 /// @class ElGamalEncryption
+/// @details Takes its ephemeral key from ElGamalKeysSupplier when available,
+///   leaving only y^k to compute on construction
 class ElGamalEncryption {
  public:
   ElGamalEncryption(
@@ -57,6 +62,41 @@ class ElGamalEncryption {
   std::unique_ptr<ElGamalEncryptionImpl> m_ElGamalEncryptionPimpl;
 };
 
+/// @class ElGamalKeysSupplier
+/// @brief Precomputes ephemeral (k, g^k) pairs for ElGamal encryption
+/// @details A background thread refills the pool as pairs are acquired.
+///   Encryption computes its own pair while the supplier is stopped or empty.
+class ElGamalKeysSupplier {
+ public:
+  ~ElGamalKeysSupplier();
+
+  static ElGamalKeysSupplier& Instance();
+
+  /// @brief Starts refilling the pool
+  /// @param size Number of pairs to keep ready
+  void Start(
+      std::size_t size = ELGAMAL_PRECOMPUTED_KEYS_SIZE);
+
+  void Stop();
+
+  /// @brief Takes a pair from the pool
+  /// @param k Ephemeral private key, 256 bytes
+  /// @param a g^k, 256 bytes
+  /// @return False if the pool is empty
+  bool Acquire(
+      std::uint8_t* k,
+      std::uint8_t* a);
+
+  /// @return Number of pairs ready
+  std::size_t GetSize();
+
+ private:
+  ElGamalKeysSupplier();
+
+  class ElGamalKeysSupplierImpl;
+  std::unique_ptr<ElGamalKeysSupplierImpl> m_ElGamalKeysSupplierPimpl;
+};
+
 bool ElGamalDecrypt(
     const std::uint8_t* key,
     const std::uint8_t* encrypted,
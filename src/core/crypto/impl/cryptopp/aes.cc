@@ -479,24 +479,57 @@ class CBCDecryption::CBCDecryptionImpl {
       CipherBlock* out) {
     if (UsingAESNI()) {
 #if defined(__x86_64__) || defined(_M_X64)  // TODO(unassigned): hack until we implement ARM AES-NI
-      __asm__(
-        "movups (%[iv]), %%xmm1 \n"
+      // Unlike encryption, CBC decryption has no dependency between blocks:
+      // keep 4 blocks in flight, then finish the remaining ones one by one.
+      // Ciphertext is loaded before plaintext is stored, so in == out is safe.
+      std::size_t num4 = num_blocks / 4, num1 = num_blocks % 4;
+      __asm__ __volatile__(
+        "movups (%[iv]), %%xmm9 \n"
+        "test %[num4], %[num4] \n"
+        "jz 2f \n"
         "1: \n"
         "movups (%[in]), %%xmm0 \n"
-        "movaps %%xmm0, %%xmm2 \n"
+        "movups 16(%[in]), %%xmm1 \n"
+        "movups 32(%[in]), %%xmm2 \n"
+        "movups 48(%[in]), %%xmm3 \n"
+        "movaps %%xmm0, %%xmm4 \n"
+        "movaps %%xmm1, %%xmm5 \n"
+        "movaps %%xmm2, %%xmm6 \n"
+        "movaps %%xmm3, %%xmm7 \n"
+        DecryptAES256x4(sched)
+        "pxor %%xmm9, %%xmm0 \n"
+        "pxor %%xmm4, %%xmm1 \n"
+        "pxor %%xmm5, %%xmm2 \n"
+        "pxor %%xmm6, %%xmm3 \n"
+        "movaps %%xmm7, %%xmm9 \n"
+        "movups %%xmm0, (%[out]) \n"
+        "movups %%xmm1, 16(%[out]) \n"
+        "movups %%xmm2, 32(%[out]) \n"
+        "movups %%xmm3, 48(%[out]) \n"
+        "add $64, %[in] \n"
+        "add $64, %[out] \n"
+        "dec %[num4] \n"
+        "jnz 1b \n"
+        "2: \n"
+        "test %[num1], %[num1] \n"
+        "jz 4f \n"
+        "3: \n"
+        "movups (%[in]), %%xmm0 \n"
+        "movaps %%xmm0, %%xmm4 \n"
         DecryptAES256(sched)
-        "pxor %%xmm1, %%xmm0 \n"
+        "pxor %%xmm9, %%xmm0 \n"
         "movups %%xmm0, (%[out]) \n"
-        "movaps %%xmm2, %%xmm1 \n"
+        "movaps %%xmm4, %%xmm9 \n"
         "add $16, %[in] \n"
         "add $16, %[out] \n"
-        "dec %[num] \n"
-        "jnz 1b \n"
-        "movups %%xmm1, (%[iv]) \n"
-        :
-        : [iv]"r"(&m_IV), [sched]"r"(m_ECBDecryption.GetKeySchedule ()),
-          [in]"r"(in), [out]"r"(out), [num]"r"(num_blocks)
-        : "%xmm0", "%xmm1", "%xmm2", "cc", "memory");
+        "dec %[num1] \n"
+        "jnz 3b \n"
+        "4: \n"
+        "movups %%xmm9, (%[iv]) \n"
+        : [in]"+r"(in), [out]"+r"(out), [num4]"+r"(num4), [num1]"+r"(num1)
+        : [iv]"r"(&m_IV), [sched]"r"(m_ECBDecryption.GetKeySchedule())
+        : "%xmm0", "%xmm1", "%xmm2", "%xmm3", "%xmm4",
+          "%xmm5", "%xmm6", "%xmm7", "%xmm8", "%xmm9", "cc", "memory");
 #endif
     } else {
       for (int i = 0; i < num_blocks; i++) {
@@ -90,6 +90,67 @@
   "aesdec 16(%["#sched"]), %%xmm0 \n" \
   "aesdeclast (%["#sched"]), %%xmm0 \n"
 
+// Decrypts four independent blocks in xmm0-xmm3 so that their rounds overlap in the pipeline
+#define DecryptAES256Round4(round, sched) \
+  "aesdec "#round"(%["#sched"]), %%xmm0 \n" \
+  "aesdec "#round"(%["#sched"]), %%xmm1 \n" \
+  "aesdec "#round"(%["#sched"]), %%xmm2 \n" \
+  "aesdec "#round"(%["#sched"]), %%xmm3 \n"
+
+#define DecryptAES256x4(sched) \
+  "movaps 224(%["#sched"]), %%xmm8 \n" \
+  "pxor %%xmm8, %%xmm0 \n" \
+  "pxor %%xmm8, %%xmm1 \n" \
+  "pxor %%xmm8, %%xmm2 \n" \
+  "pxor %%xmm8, %%xmm3 \n" \
+  DecryptAES256Round4(208, sched) \
+  DecryptAES256Round4(192, sched) \
+  DecryptAES256Round4(176, sched) \
+  DecryptAES256Round4(160, sched) \
+  DecryptAES256Round4(144, sched) \
+  DecryptAES256Round4(128, sched) \
+  DecryptAES256Round4(112, sched) \
+  DecryptAES256Round4(96, sched) \
+  DecryptAES256Round4(80, sched) \
+  DecryptAES256Round4(64, sched) \
+  DecryptAES256Round4(48, sched) \
+  DecryptAES256Round4(32, sched) \
+  DecryptAES256Round4(16, sched) \
+  "aesdeclast (%["#sched"]), %%xmm0 \n" \
+  "aesdeclast (%["#sched"]), %%xmm1 \n" \
+  "aesdeclast (%["#sched"]), %%xmm2 \n" \
+  "aesdeclast (%["#sched"]), %%xmm3 \n"
+
+// Encrypts four independent blocks in xmm0-xmm3, each with its own key schedule in r8-r11
+#define EncryptAES256Round4Lanes(round) \
+  "aesenc "#round"(%%r8), %%xmm0 \n" \
+  "aesenc "#round"(%%r9), %%xmm1 \n" \
+  "aesenc "#round"(%%r10), %%xmm2 \n" \
+  "aesenc "#round"(%%r11), %%xmm3 \n"
+
+#define EncryptAES256x4Lanes \
+  "pxor (%%r8), %%xmm0 \n" \
+  "pxor (%%r9), %%xmm1 \n" \
+  "pxor (%%r10), %%xmm2 \n" \
+  "pxor (%%r11), %%xmm3 \n" \
+  EncryptAES256Round4Lanes(16) \
+  EncryptAES256Round4Lanes(32) \
+  EncryptAES256Round4Lanes(48) \
+  EncryptAES256Round4Lanes(64) \
+  EncryptAES256Round4Lanes(80) \
+  EncryptAES256Round4Lanes(96) \
+  EncryptAES256Round4Lanes(112) \
+  EncryptAES256Round4Lanes(128) \
+  EncryptAES256Round4Lanes(144) \
+  EncryptAES256Round4Lanes(160) \
+  EncryptAES256Round4Lanes(176) \
+  EncryptAES256Round4Lanes(192) \
+  EncryptAES256Round4Lanes(208) \
+  "aesenclast 224(%%r8), %%xmm0 \n" \
+  "aesenclast 224(%%r9), %%xmm1 \n" \
+  "aesenclast 224(%%r10), %%xmm2 \n" \
+  "aesenclast 224(%%r11), %%xmm3 \n"
+
 #define CallAESIMC(offset) \
   "movaps "#offset"(%[shed]), %%xmm0 \n"  \
   "aesimc %%xmm0, %%xmm0 \n" \
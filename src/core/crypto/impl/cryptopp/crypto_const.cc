@@ -32,6 +32,8 @@
 
 #include "crypto_const.h"
 
+#include <cryptopp/gfpcrypt.h>
+
 #include <inttypes.h>
 
 namespace kovri {
@@ -94,5 +96,36 @@ const CryptoConstants& GetCryptoConstants() {
   return cryptoConstants;
 }
 
+// Powers of elgg, stored in Montgomery form, for exponents of up to 2048 bits
+const unsigned int ELGG_PRECOMPUTATION_EXPONENT_BITS = 2048,
+                   ELGG_PRECOMPUTATION_STORAGE = 64;  // 16 KB
+
+/// @return Modular arithmetic for elgp, one per thread as it uses a workspace
+const CryptoPP::ModExpPrecomputation& GetElgpGroup() {
+  struct ElgpGroup {
+    ElgpGroup() {
+      group.SetModulus(elgp);
+    }
+    CryptoPP::ModExpPrecomputation group;
+  };
+  static thread_local ElgpGroup elgp_group;
+  return elgp_group.group;
+}
+
+CryptoPP::Integer elgg_exp_mod_elgp(
+    const CryptoPP::Integer& exponent) {
+  // Built once, then only read
+  static const CryptoPP::DL_FixedBasePrecomputationImpl<CryptoPP::Integer> table = [] {
+    CryptoPP::DL_FixedBasePrecomputationImpl<CryptoPP::Integer> precomputation;
+    precomputation.SetBase(GetElgpGroup(), elgg);
+    precomputation.Precompute(
+        GetElgpGroup(),
+        ELGG_PRECOMPUTATION_EXPONENT_BITS,
+        ELGG_PRECOMPUTATION_STORAGE);
+    return precomputation;
+  }();
+  return table.Exponentiate(GetElgpGroup(), exponent);
+}
+
 }  // namespace core
 }  // namespace kovri
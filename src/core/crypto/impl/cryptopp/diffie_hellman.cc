@@ -56,7 +56,12 @@ class DiffieHellman::DiffieHellmanImpl {
   void GenerateKeyPair(
       std::uint8_t* private_key,
       std::uint8_t* public_key) {
-    m_DH.GenerateKeyPair(m_PRNG, private_key, public_key);
+    m_DH.GeneratePrivateKey(m_PRNG, private_key);
+    // Same as m_DH.GeneratePublicKey() but with precomputed powers of the generator
+    elgg_exp_mod_elgp(
+        CryptoPP::Integer(private_key, m_DH.PrivateKeyLength())).Encode(
+            public_key,
+            m_DH.PublicKeyLength());
   }
 
   /// @brief Agreed value from your private key and other party's public key
@@ -34,9 +34,16 @@
 
 #include <cryptopp/integer.h>
 #include <cryptopp/osrng.h>
+#include <cryptopp/secblock.h>
 #include <cryptopp/sha.h>
 
 #include <array>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <utility>
 
 #include "crypto_const.h"
 
@@ -48,17 +55,163 @@
 namespace kovri {
 namespace core {
 
+namespace {
+/// @brief Generates an ephemeral key and its public value
+void CreateElGamalKeys(
+    CryptoPP::Integer& k,
+    CryptoPP::Integer& a) {
+  CryptoPP::AutoSeededRandomPool prng;
+  k.Randomize(prng, CryptoPP::Integer::One(), elgp - 1);
+  a = elgg_exp_mod_elgp(k);
+}
+}  // namespace
+
+/// @class ElGamalKeysSupplierImpl
+/// @brief Pool of (k, g^k) pairs, refilled on a background thread
+class ElGamalKeysSupplier::ElGamalKeysSupplierImpl {
+ public:
+  ElGamalKeysSupplierImpl()
+      : m_Size(0),
+        m_IsRunning(false) {}
+
+  ~ElGamalKeysSupplierImpl() {
+    Stop();
+  }
+
+  void Start(
+      std::size_t size) {
+    std::unique_lock<std::mutex> l(m_Mutex);
+    if (m_IsRunning)
+      return;
+    LOG(debug) << "ElGamalKeysSupplier: starting";
+    m_Size = size;
+    m_IsRunning = true;
+    // Previous thread has given up, see Run()
+    if (m_Thread)
+      m_Thread->join();
+    m_Thread =
+      std::make_unique<std::thread>(
+          std::bind(
+              &ElGamalKeysSupplierImpl::Run,
+              this));
+  }
+
+  void Stop() {
+    {
+      std::unique_lock<std::mutex> l(m_Mutex);
+      m_IsRunning = false;
+    }
+    m_Acquired.notify_one();
+    if (m_Thread) {
+      m_Thread->join();
+      m_Thread.reset(nullptr);
+    }
+  }
+
+  bool Acquire(
+      CryptoPP::Integer& k,
+      CryptoPP::Integer& a) {
+    std::unique_lock<std::mutex> l(m_Mutex);
+    if (m_Keys.empty())
+      return false;
+    k = std::move(m_Keys.front().first);
+    a = std::move(m_Keys.front().second);
+    m_Keys.pop();
+    m_Acquired.notify_one();
+    return true;
+  }
+
+  std::size_t GetSize() {
+    std::unique_lock<std::mutex> l(m_Mutex);
+    return m_Keys.size();
+  }
+
+ private:
+  void Run() {
+    LOG(debug) << "ElGamalKeysSupplier: running";
+    std::unique_lock<std::mutex> l(m_Mutex);
+    try {
+      while (m_IsRunning) {
+        if (m_Keys.size() < m_Size) {
+          // One pair at a time, so that we neither hold the lock nor delay Stop()
+          l.unlock();
+          CryptoPP::Integer k, a;
+          CreateElGamalKeys(k, a);
+          l.lock();
+          m_Keys.emplace(std::move(k), std::move(a));
+          continue;
+        }
+        m_Acquired.wait(l);  // wait for a pair to be acquired
+      }
+    } catch (const std::exception& ex) {
+      LOG(error) << "ElGamalKeysSupplier: " << __func__ << ": " << ex.what();
+      if (!l.owns_lock())
+        l.lock();
+    }
+    // Also when giving up, so that Start() can run the supplier again
+    m_IsRunning = false;
+  }
+
+ private:
+  std::size_t m_Size;
+  bool m_IsRunning;
+  std::queue<std::pair<CryptoPP::Integer, CryptoPP::Integer> > m_Keys;
+  std::unique_ptr<std::thread> m_Thread;
+  std::condition_variable m_Acquired;
+  std::mutex m_Mutex;
+};
+
+ElGamalKeysSupplier::ElGamalKeysSupplier()
+    : m_ElGamalKeysSupplierPimpl(
+          std::make_unique<ElGamalKeysSupplierImpl>()) {}
+
+ElGamalKeysSupplier::~ElGamalKeysSupplier() {}
+
+ElGamalKeysSupplier& ElGamalKeysSupplier::Instance() {
+  static ElGamalKeysSupplier supplier;
+  return supplier;
+}
+
+void ElGamalKeysSupplier::Start(
+    std::size_t size) {
+  m_ElGamalKeysSupplierPimpl->Start(size);
+}
+
+void ElGamalKeysSupplier::Stop() {
+  m_ElGamalKeysSupplierPimpl->Stop();
+}
+
+bool ElGamalKeysSupplier::Acquire(
+    std::uint8_t* k,
+    std::uint8_t* a) {
+  CryptoPP::Integer key, value;
+  if (!m_ElGamalKeysSupplierPimpl->Acquire(key, value))
+    return false;
+  key.Encode(k, 256);
+  value.Encode(a, 256);
+  return true;
+}
+
+std::size_t ElGamalKeysSupplier::GetSize() {
+  return m_ElGamalKeysSupplierPimpl->GetSize();
+}
+
 /// @class ElGamalEncryptionImpl
 /// @brief ElGamal encryption
 class ElGamalEncryption::ElGamalEncryptionImpl {
  public:
   ElGamalEncryptionImpl(
       const std::uint8_t* key) {
-    CryptoPP::AutoSeededRandomPool prng;
-    CryptoPP::Integer
-      y(key, 256),
-      k(prng, CryptoPP::Integer::One(), elgp - 1);
-    a = a_exp_b_mod_c(elgg, k, elgp);
+    CryptoPP::Integer y(key, 256), k;
+    // Only y^k is left to compute when g^k was precomputed
+    CryptoPP::SecByteBlock k_buf(256);  // Wiped when done
+    std::array<std::uint8_t, 256> a_buf;
+    if (ElGamalKeysSupplier::Instance().Acquire(k_buf.data(), a_buf.data())) {
+      k.Decode(k_buf.data(), k_buf.size());
+      a.Decode(a_buf.data(), a_buf.size());
+    } else {
+      CreateElGamalKeys(k, a);
+    }
     b1 = a_exp_b_mod_c(y, k, elgp);
   }
 
@@ -154,10 +307,7 @@ void GenerateElGamalKeyPair(
     std::uint8_t* pub) {
 #if defined(__x86_64__) || defined(__i386__) || defined(_MSC_VER)
   RandBytes(priv, 256);
-  a_exp_b_mod_c(
-      elgg,
-      CryptoPP::Integer(priv, 256),
-      elgp).Encode(pub, 256);
+  elgg_exp_mod_elgp(CryptoPP::Integer(priv, 256)).Encode(pub, 256);
 #else
     DiffieHellman().GenerateKeyPair(priv, pub);
 #endif
@@ -30,23 +30,159 @@
 
 #include "core/crypto/rand.h"
 
+#include <cryptopp/aes.h>
+#include <cryptopp/modes.h>
 #include <cryptopp/osrng.h>
+#include <cryptopp/secblock.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
 
 namespace kovri {
 namespace core {
 
+namespace {
+/// @brief Bumped in the child of each fork, so that it doesn't replay
+///   the keystream of its parent
+std::atomic<std::uint32_t> g_ForkGeneration(0);
+
+#ifndef _WIN32
+struct ForkHandler {
+  ForkHandler() {
+    pthread_atfork(nullptr, nullptr, []() { g_ForkGeneration++; });
+  }
+} g_ForkHandler;
+#endif
+}  // namespace
+
+/// @class RandomGenerator
+/// @brief AES-256-CTR keystream generator with fast key erasure, one per
+///   thread
+/// @details Each refill of the keystream buffer starts with the key of the
+///   next refill, which then replaces the current key right away. Served
+///   bytes are wiped from the buffer, so the state of the generator never
+///   reveals what it has already returned. Seeding from the OS is what
+///   makes AutoSeededRandomPool expensive, so we only do it on first use,
+///   after a fork, after RESEED_SIZE bytes and after RESEED_INTERVAL.
+class RandomGenerator : public CryptoPP::RandomNumberGenerator {
+ public:
+  RandomGenerator()
+      : m_Buffer(BUFFER_SIZE),
+        m_Pos(BUFFER_SIZE),
+        m_NumGenerated(RESEED_SIZE),
+        m_ForkGeneration(g_ForkGeneration) {}
+
+  ~RandomGenerator() {
+    std::memset(m_Buffer, 0, m_Buffer.size());
+  }
+
+  void GenerateBlock(
+      std::uint8_t* output,
+      std::size_t size) {
+    Reseed(size);
+    if (size > BUFFER_SIZE - KEY_SIZE) {
+      // Large requests bypass the buffer, the key still changes first
+      CryptoPP::SecByteBlock key(KEY_SIZE);
+      m_Cipher.Resynchronize(ZERO_IV, IV_SIZE);
+      m_Cipher.GenerateBlock(key, key.size());
+      m_Cipher.GenerateBlock(output, size);
+      SetKey(key);
+      return;
+    }
+    while (size) {
+      if (m_Pos == BUFFER_SIZE)
+        Refill();
+      const std::size_t len = std::min(size, BUFFER_SIZE - m_Pos);
+      std::memcpy(output, m_Buffer + m_Pos, len);
+      std::memset(m_Buffer + m_Pos, 0, len);
+      m_Pos += len;
+      output += len;
+      size -= len;
+    }
+  }
+
+  static RandomGenerator& Instance() {
+    static thread_local RandomGenerator generator;
+    return generator;
+  }
+
+ private:
+  /// @brief Rekeys from the OS when due
+  void Reseed(
+      std::size_t size) {
+    auto now = std::chrono::steady_clock::now();
+    if (m_NumGenerated >= RESEED_SIZE
+        || now - m_SeedTime >= RESEED_INTERVAL
+        || m_ForkGeneration != g_ForkGeneration) {
+      CryptoPP::SecByteBlock seed(KEY_SIZE);
+      CryptoPP::OS_GenerateRandomBlock(false, seed, seed.size());
+      SetKey(seed);
+      // Buffered bytes came from the previous key
+      std::memset(m_Buffer, 0, m_Buffer.size());
+      m_Pos = BUFFER_SIZE;
+      m_NumGenerated = 0;
+      m_SeedTime = now;
+      m_ForkGeneration = g_ForkGeneration;
+    }
+    m_NumGenerated += size;
+  }
+
+  /// @brief Fills buffer with keystream, whose first bytes are the next key
+  void Refill() {
+    m_Cipher.Resynchronize(ZERO_IV, IV_SIZE);
+    m_Cipher.GenerateBlock(m_Buffer, BUFFER_SIZE);
+    SetKey(m_Buffer);
+    std::memset(m_Buffer, 0, KEY_SIZE);
+    m_Pos = KEY_SIZE;
+  }
+
+  void SetKey(
+      const std::uint8_t* key) {
+    m_Cipher.SetKeyWithIV(key, KEY_SIZE, ZERO_IV, IV_SIZE);
+  }
+
+ private:
+  static const std::size_t KEY_SIZE = CryptoPP::AES::MAX_KEYLENGTH;
+  static const std::size_t IV_SIZE = CryptoPP::AES::BLOCKSIZE;
+  static const std::size_t BUFFER_SIZE = 768;
+  static const std::size_t RESEED_SIZE = 1024 * 1024;  // 1 MB
+  static constexpr std::chrono::minutes RESEED_INTERVAL{5};
+  static const std::uint8_t ZERO_IV[IV_SIZE];
+
+  CryptoPP::CTR_Mode<CryptoPP::AES>::Encryption m_Cipher;
+  CryptoPP::SecByteBlock m_Buffer;
+  std::size_t m_Pos;  // of the next byte to serve
+  std::size_t m_NumGenerated;
+  std::chrono::steady_clock::time_point m_SeedTime;
+  std::uint32_t m_ForkGeneration;
+};
+
+constexpr std::chrono::minutes RandomGenerator::RESEED_INTERVAL;
+const std::uint8_t RandomGenerator::ZERO_IV[RandomGenerator::IV_SIZE] {};
+
 void RandBytes(
     std::uint8_t* dataptr,
     std::size_t datalen) {
-  CryptoPP::AutoSeededRandomPool prng;
-  prng.GenerateBlock(dataptr, datalen);
+  RandomGenerator::Instance().GenerateBlock(dataptr, datalen);
+}
+
+void RandBytes(
+    std::initializer_list<std::pair<std::uint8_t*, std::size_t> > buffers) {
+  auto& prng = RandomGenerator::Instance();
+  for (const auto& buffer : buffers)
+    prng.GenerateBlock(buffer.first, buffer.second);
 }
 
 std::uint32_t RandInRange32(
     std::uint32_t min,
     std::uint32_t max) {
-  CryptoPP::AutoSeededRandomPool prng;
-  return prng.GenerateWord32(min, max);
+  return RandomGenerator::Instance().GenerateWord32(min, max);
 }
 
 }  // namespace core
@@ -32,6 +32,7 @@
 
 #include "core/crypto/tunnel.h"
 
+#include <cstddef>
 #include <cstdint>
 
 #include "aesni_macros.h"
@@ -105,6 +106,97 @@ class TunnelEncryption::TunnelEncryptionImpl {
     }
   }
 
+  /// @brief Encrypts 4 tunnel messages at once, each with its own keys
+  /// @details CBC encryption is serial within a message, so independent
+  ///   messages are interleaved instead to keep the AES pipeline busy
+  /// @note Only usable with AES-NI
+  static void Encrypt4(
+      TunnelEncryptionImpl* const* impls,
+      const std::uint8_t* const* in,
+      std::uint8_t* const* out) {
+#if defined(__x86_64__) || defined(_M_X64)  // TODO(unassigned): hack until we implement ARM AES-NI
+    const std::uint8_t* sched_iv[4];
+    const std::uint8_t* sched_l[4];
+    for (std::size_t i = 0; i < 4; i++) {
+      sched_iv[i] = impls[i]->m_IVEncryption.GetKeySchedule();
+      sched_l[i] = impls[i]->m_ECBLayerEncryption.GetKeySchedule();
+    }
+    std::size_t offset = 16;
+    __asm__ __volatile__(
+        // encrypt IVs
+        "mov (%[in]), %%rax \n"
+        "movups (%%rax), %%xmm0 \n"
+        "mov 8(%[in]), %%rax \n"
+        "movups (%%rax), %%xmm1 \n"
+        "mov 16(%[in]), %%rax \n"
+        "movups (%%rax), %%xmm2 \n"
+        "mov 24(%[in]), %%rax \n"
+        "movups (%%rax), %%xmm3 \n"
+        "mov (%[sched_iv]), %%r8 \n"
+        "mov 8(%[sched_iv]), %%r9 \n"
+        "mov 16(%[sched_iv]), %%r10 \n"
+        "mov 24(%[sched_iv]), %%r11 \n"
+        EncryptAES256x4Lanes
+        "movaps %%xmm0, %%xmm4 \n"
+        "movaps %%xmm1, %%xmm5 \n"
+        "movaps %%xmm2, %%xmm6 \n"
+        "movaps %%xmm3, %%xmm7 \n"
+        // double IV encryption
+        EncryptAES256x4Lanes
+        "mov (%[out]), %%rax \n"
+        "movups %%xmm0, (%%rax) \n"
+        "mov 8(%[out]), %%rax \n"
+        "movups %%xmm1, (%%rax) \n"
+        "mov 16(%[out]), %%rax \n"
+        "movups %%xmm2, (%%rax) \n"
+        "mov 24(%[out]), %%rax \n"
+        "movups %%xmm3, (%%rax) \n"
+        // encrypt data, IVs are xmm4-xmm7
+        "mov (%[sched_l]), %%r8 \n"
+        "mov 8(%[sched_l]), %%r9 \n"
+        "mov 16(%[sched_l]), %%r10 \n"
+        "mov 24(%[sched_l]), %%r11 \n"
+        "1: \n"
+        "mov (%[in]), %%rax \n"
+        "movups (%%rax,%[offset]), %%xmm0 \n"
+        "mov 8(%[in]), %%rax \n"
+        "movups (%%rax,%[offset]), %%xmm1 \n"
+        "mov 16(%[in]), %%rax \n"
+        "movups (%%rax,%[offset]), %%xmm2 \n"
+        "mov 24(%[in]), %%rax \n"
+        "movups (%%rax,%[offset]), %%xmm3 \n"
+        "pxor %%xmm4, %%xmm0 \n"
+        "pxor %%xmm5, %%xmm1 \n"
+        "pxor %%xmm6, %%xmm2 \n"
+        "pxor %%xmm7, %%xmm3 \n"
+        EncryptAES256x4Lanes
+        "movaps %%xmm0, %%xmm4 \n"
+        "movaps %%xmm1, %%xmm5 \n"
+        "movaps %%xmm2, %%xmm6 \n"
+        "movaps %%xmm3, %%xmm7 \n"
+        "mov (%[out]), %%rax \n"
+        "movups %%xmm0, (%%rax,%[offset]) \n"
+        "mov 8(%[out]), %%rax \n"
+        "movups %%xmm1, (%%rax,%[offset]) \n"
+        "mov 16(%[out]), %%rax \n"
+        "movups %%xmm2, (%%rax,%[offset]) \n"
+        "mov 24(%[out]), %%rax \n"
+        "movups %%xmm3, (%%rax,%[offset]) \n"
+        "add $16, %[offset] \n"
+        "cmp $1024, %[offset] \n"  // 16 IV + 1008 data
+        "jne 1b \n"
+        : [offset]"+r"(offset)
+        : [in]"r"(in), [out]"r"(out),
+          [sched_iv]"r"(sched_iv), [sched_l]"r"(sched_l)
+        : "%rax", "%r8", "%r9", "%r10", "%r11",
+          "%xmm0", "%xmm1", "%xmm2", "%xmm3",
+          "%xmm4", "%xmm5", "%xmm6", "%xmm7", "cc", "memory");
+#else
+    for (std::size_t i = 0; i < 4; i++)
+      impls[i]->Encrypt(in[i], out[i]);
+#endif
+  }
+
  private:
   ECBEncryption m_IVEncryption;
   ECBEncryption m_ECBLayerEncryption;  // For AES-NI
@@ -129,6 +221,24 @@ void TunnelEncryption::Encrypt(
   m_TunnelEncryptionPimpl->Encrypt(in, out);
 }
 
+void TunnelEncryption::Encrypt(
+      TunnelEncryption* const* encryptions,
+      const std::uint8_t* const* in,
+      std::uint8_t* const* out,
+      std::size_t num) {
+  std::size_t i = 0;
+  if (UsingAESNI()) {
+    for (; i + 4 <= num; i += 4) {
+      TunnelEncryptionImpl* impls[4];
+      for (std::size_t j = 0; j < 4; j++)
+        impls[j] = encryptions[i + j]->m_TunnelEncryptionPimpl.get();
+      TunnelEncryptionImpl::Encrypt4(impls, in + i, out + i);
+    }
+  }
+  for (; i < num; i++)
+    encryptions[i]->Encrypt(in[i], out[i]);
+}
+
 /// @class TunnelDecryptionImpl
 /// @brief Tunnel decryption implementation
 class TunnelDecryption::TunnelDecryptionImpl {
@@ -151,31 +261,60 @@ class TunnelDecryption::TunnelDecryptionImpl {
       std::uint8_t* out) {
     if (UsingAESNI()) {
 #if defined(__x86_64__) || defined(_M_X64)  // TODO(unassigned): hack until we implement ARM AES-NI
-      __asm__(
+      // CBC decryption has no dependency between blocks:
+      // keep 4 blocks in flight, then finish the remaining 3 one by one
+      std::size_t num4 = 15, num1 = 3;  // 15 * 4 + 3 = 63 blocks = 1008 bytes
+      __asm__ __volatile__(
           // decrypt IV
           "movups (%[in]), %%xmm0 \n"
           DecryptAES256(sched_iv)
-          "movaps %%xmm0, %%xmm1 \n"
+          "movaps %%xmm0, %%xmm9 \n"
           // double IV encryption
           DecryptAES256(sched_iv)
           "movups %%xmm0, (%[out]) \n"
-          // decrypt data, IV is xmm1
-          "1: \n"
           "add $16, %[in] \n"
           "add $16, %[out] \n"
+          // decrypt data 4 blocks at a time, IV is xmm9
+          "1: \n"
           "movups (%[in]), %%xmm0 \n"
-          "movaps %%xmm0, %%xmm2 \n"
-          DecryptAES256(sched_l)
-          "pxor %%xmm1, %%xmm0 \n"
+          "movups 16(%[in]), %%xmm1 \n"
+          "movups 32(%[in]), %%xmm2 \n"
+          "movups 48(%[in]), %%xmm3 \n"
+          "movaps %%xmm0, %%xmm4 \n"
+          "movaps %%xmm1, %%xmm5 \n"
+          "movaps %%xmm2, %%xmm6 \n"
+          "movaps %%xmm3, %%xmm7 \n"
+          DecryptAES256x4(sched_l)
+          "pxor %%xmm9, %%xmm0 \n"
+          "pxor %%xmm4, %%xmm1 \n"
+          "pxor %%xmm5, %%xmm2 \n"
+          "pxor %%xmm6, %%xmm3 \n"
+          "movaps %%xmm7, %%xmm9 \n"
           "movups %%xmm0, (%[out]) \n"
-          "movaps %%xmm2, %%xmm1 \n"
-          "dec %[num] \n"
+          "movups %%xmm1, 16(%[out]) \n"
+          "movups %%xmm2, 32(%[out]) \n"
+          "movups %%xmm3, 48(%[out]) \n"
+          "add $64, %[in] \n"
+          "add $64, %[out] \n"
+          "dec %[num4] \n"
           "jnz 1b \n"
-          :
+          // decrypt remaining blocks
+          "2: \n"
+          "movups (%[in]), %%xmm0 \n"
+          "movaps %%xmm0, %%xmm4 \n"
+          DecryptAES256(sched_l)
+          "pxor %%xmm9, %%xmm0 \n"
+          "movups %%xmm0, (%[out]) \n"
+          "movaps %%xmm4, %%xmm9 \n"
+          "add $16, %[in] \n"
+          "add $16, %[out] \n"
+          "dec %[num1] \n"
+          "jnz 2b \n"
+          : [in]"+r"(in), [out]"+r"(out), [num4]"+r"(num4), [num1]"+r"(num1)
           : [sched_iv]"r"(m_IVDecryption.GetKeySchedule()),
-            [sched_l]"r"(m_ECBLayerDecryption.GetKeySchedule()),
-            [in]"r"(in), [out]"r"(out), [num]"r"(63)  // 63 blocks = 1008 bytes
-          : "%xmm0", "%xmm1", "%xmm2", "cc", "memory");
+            [sched_l]"r"(m_ECBLayerDecryption.GetKeySchedule())
+          : "%xmm0", "%xmm1", "%xmm2", "%xmm3", "%xmm4",
+            "%xmm5", "%xmm6", "%xmm7", "%xmm8", "%xmm9", "cc", "memory");
 #endif
     } else {
       m_IVDecryption.Decrypt(
@@ -192,6 +331,15 @@ class TunnelDecryption::TunnelDecryptionImpl {
     }
   }
 
+  void Decrypt(
+      const std::uint8_t* const* in,
+      std::uint8_t* const* out,
+      std::size_t num) {
+    // Key schedules stay hot in cache for the whole batch
+    for (std::size_t i = 0; i < num; i++)
+      Decrypt(in[i], out[i]);
+  }
+
  private:
   ECBDecryption m_IVDecryption;
   ECBDecryption m_ECBLayerDecryption;  // For AES-NI
@@ -216,5 +364,12 @@ void TunnelDecryption::Decrypt(
   m_TunnelDecryptionPimpl->Decrypt(in, out);
 }
 
+void TunnelDecryption::Decrypt(
+      const std::uint8_t* const* in,
+      std::uint8_t* const* out,
+      std::size_t num) {
+  m_TunnelDecryptionPimpl->Decrypt(in, out, num);
+}
+
 }  // namespace core
 }  // namespace kovri
@@ -32,13 +32,167 @@
 
 #include <cryptopp/adler32.h>
 
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
 #include <cstdint>
+#include <cstring>
 
 #include "core/util/log.h"
 
 namespace kovri {
 namespace core {
 
+namespace {
+
+const std::uint32_t ADLER32_MOD = 65521;  // Largest prime below 2^16
+const std::size_t ADLER32_NMAX = 5552;  // Max bytes summed before s2 can overflow 32 bits
+
+}  // namespace
+
+/// @brief Adds input to a running Adler-32, one byte at a time
+std::uint32_t Adler32Scalar(
+    std::uint32_t adler,
+    const std::uint8_t* input,
+    std::size_t length) {
+  std::uint32_t s1 = adler & 0xFFFF, s2 = adler >> 16;
+  while (length) {
+    std::size_t n = length < ADLER32_NMAX ? length : ADLER32_NMAX;
+    length -= n;
+    while (n--) {
+      s1 += *input++;
+      s2 += s1;
+    }
+    s1 %= ADLER32_MOD;
+    s2 %= ADLER32_MOD;
+  }
+  return (s2 << 16) | s1;
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+/// @brief Adds input to a running Adler-32, 32 bytes per step with SSSE3
+/// @details s1 sums bytes with SAD against zero, s2 sums bytes weighted by
+///   their distance to the end of the step with PMADDUBSW; each step also
+///   adds 32 times the previous s1 to s2, which is accumulated in ps
+__attribute__((target("ssse3")))
+std::uint32_t Adler32SSSE3(
+    std::uint32_t adler,
+    const std::uint8_t* input,
+    std::size_t length) {
+  std::uint32_t s1 = adler & 0xFFFF, s2 = adler >> 16;
+  std::size_t blocks = length / 32;
+  length -= blocks * 32;
+  const __m128i taps1 = _mm_setr_epi8(
+      32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+  const __m128i taps2 = _mm_setr_epi8(
+      16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i ones = _mm_set1_epi16(1);
+  while (blocks) {
+    std::size_t n = ADLER32_NMAX / 32;
+    if (n > blocks)
+      n = blocks;
+    blocks -= n;
+    __m128i ps = _mm_set_epi32(0, 0, 0, s1 * n);
+    __m128i v_s2 = _mm_set_epi32(0, 0, 0, s2);
+    __m128i v_s1 = zero;
+    do {
+      const __m128i bytes1 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+      const __m128i bytes2 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 16));
+      ps = _mm_add_epi32(ps, v_s1);
+      v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes1, zero));
+      v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes2, zero));
+      v_s2 = _mm_add_epi32(
+          v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes1, taps1), ones));
+      v_s2 = _mm_add_epi32(
+          v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes2, taps2), ones));
+      input += 32;
+    } while (--n);
+    v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(ps, 5));
+    // Horizontal sums
+    v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(1, 0, 3, 2)));
+    v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(1, 0, 3, 2)));
+    v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(2, 3, 0, 1)));
+    s1 = (s1 + _mm_cvtsi128_si32(v_s1)) % ADLER32_MOD;
+    s2 = _mm_cvtsi128_si32(v_s2) % ADLER32_MOD;
+  }
+  return Adler32Scalar((s2 << 16) | s1, input, length);
+}
+
+/// @brief Adds input to a running Adler-32, 32 bytes per step with AVX2
+/// @details Same as Adler32SSSE3, with one 256-bit load per step
+__attribute__((target("avx2")))
+std::uint32_t Adler32AVX2(
+    std::uint32_t adler,
+    const std::uint8_t* input,
+    std::size_t length) {
+  std::uint32_t s1 = adler & 0xFFFF, s2 = adler >> 16;
+  std::size_t blocks = length / 32;
+  length -= blocks * 32;
+  const __m256i taps = _mm256_setr_epi8(
+      32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17,
+      16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i ones = _mm256_set1_epi16(1);
+  while (blocks) {
+    std::size_t n = ADLER32_NMAX / 32;
+    if (n > blocks)
+      n = blocks;
+    blocks -= n;
+    __m256i ps = _mm256_set_epi32(0, 0, 0, 0, 0, 0, 0, s1 * n);
+    __m256i v_s2 = _mm256_set_epi32(0, 0, 0, 0, 0, 0, 0, s2);
+    __m256i v_s1 = zero;
+    do {
+      const __m256i bytes =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input));
+      ps = _mm256_add_epi32(ps, v_s1);
+      v_s1 = _mm256_add_epi32(v_s1, _mm256_sad_epu8(bytes, zero));
+      v_s2 = _mm256_add_epi32(
+          v_s2, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes, taps), ones));
+      input += 32;
+    } while (--n);
+    v_s2 = _mm256_add_epi32(v_s2, _mm256_slli_epi32(ps, 5));
+    // Horizontal sums, first across the two 128-bit halves
+    __m128i h_s1 = _mm_add_epi32(
+        _mm256_castsi256_si128(v_s1), _mm256_extracti128_si256(v_s1, 1));
+    __m128i h_s2 = _mm_add_epi32(
+        _mm256_castsi256_si128(v_s2), _mm256_extracti128_si256(v_s2, 1));
+    h_s1 = _mm_add_epi32(h_s1, _mm_shuffle_epi32(h_s1, _MM_SHUFFLE(1, 0, 3, 2)));
+    h_s2 = _mm_add_epi32(h_s2, _mm_shuffle_epi32(h_s2, _MM_SHUFFLE(1, 0, 3, 2)));
+    h_s2 = _mm_add_epi32(h_s2, _mm_shuffle_epi32(h_s2, _MM_SHUFFLE(2, 3, 0, 1)));
+    s1 = (s1 + _mm_cvtsi128_si32(h_s1)) % ADLER32_MOD;
+    s2 = _mm_cvtsi128_si32(h_s2) % ADLER32_MOD;
+  }
+  return Adler32Scalar((s2 << 16) | s1, input, length);
+}
+#endif
+
+namespace {
+
+typedef std::uint32_t (*Adler32Kernel)(std::uint32_t, const std::uint8_t*, std::size_t);
+
+/// @return Fastest kernel supported by this CPU, or nullptr to use the library
+Adler32Kernel GetAdler32Kernel() {
+#if defined(__x86_64__) || defined(_M_X64)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    LOG(debug) << "Crypto: using AVX2 Adler-32";
+    return Adler32AVX2;
+  }
+  if (__builtin_cpu_supports("ssse3")) {
+    LOG(debug) << "Crypto: using SSSE3 Adler-32";
+    return Adler32SSSE3;
+  }
+#endif
+  LOG(debug) << "Crypto: SIMD Adler-32 is not available, using library";
+  return nullptr;
+}
+
+}  // namespace
+
 /// @class Adler32Impl
 /// @brief Adler-32 implementation
 class Adler32::Adler32Impl {
@@ -50,17 +204,37 @@ class Adler32::Adler32Impl {
       std::uint8_t* digest,
       const std::uint8_t* input,
       std::size_t length) {
-    m_Adler32.CalculateDigest(digest, input, length);
+    const Adler32Kernel kernel = GetKernel();
+    if (!kernel) {
+      m_Adler32.CalculateDigest(digest, input, length);
+      return;
+    }
+    // Big-endian s2 then s1, as the library does
+    const std::uint32_t adler = kernel(1, input, length);
+    digest[0] = adler >> 24;
+    digest[1] = adler >> 16;
+    digest[2] = adler >> 8;
+    digest[3] = adler;
   }
 
   std::size_t VerifyDigest(
       std::uint8_t* digest,
       const std::uint8_t* input,
       std::size_t length) {
-    return m_Adler32.VerifyDigest(digest, input, length);
+    if (!GetKernel())
+      return m_Adler32.VerifyDigest(digest, input, length);
+    std::uint8_t computed[4];
+    CalculateDigest(computed, input, length);
+    return !std::memcmp(computed, digest, sizeof(computed));
   }
 
  private:
+  /// @note Selected once per process, on first use
+  static Adler32Kernel GetKernel() {
+    static const Adler32Kernel kernel = GetAdler32Kernel();
+    return kernel;
+  }
+
   CryptoPP::Adler32 m_Adler32;
 };
 
@@ -32,18 +32,28 @@
 #define SRC_CORE_CRYPTO_RAND_H_
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <initializer_list>
+#include <utility>
 
 namespace kovri {
 namespace core {
 
   /// @brief Generates CSPRNG bytes
+  /// @details Bytes come from a per-thread AES-CTR keystream which is
+  ///   periodically reseeded from the OS, so calls are cheap at any size
   /// @param data Buffer to store result
   /// @param length Size of buffer
   void RandBytes(
       std::uint8_t* data,
       std::size_t length);
 
+  /// @brief Fills several buffers in one pass, e.g., all keys of a record
+  /// @param buffers Pairs of buffer and size of buffer
+  void RandBytes(
+      std::initializer_list<std::pair<std::uint8_t*, std::size_t> > buffers);
+
   /// @brief Generates a random of type T
   /// @return Random value of type T
   template<class T>
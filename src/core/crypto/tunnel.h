@@ -33,6 +33,7 @@
 #ifndef SRC_CORE_CRYPTO_TUNNEL_H_
 #define SRC_CORE_CRYPTO_TUNNEL_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 
@@ -55,6 +56,18 @@ class TunnelEncryption {  // with double IV encryption
       const std::uint8_t* in,
       std::uint8_t* out);  // 1024 bytes (16 IV + 1008 data)
 
+  /// @brief Encrypts a batch of tunnel messages, each with its own keys
+  /// @details Messages of different tunnels are interleaved where possible
+  /// @param encryptions Array of pointers to the encryption of each message, may repeat
+  /// @param in Array of pointers to 1024 bytes (16 IV + 1008 data) to encrypt
+  /// @param out Array of pointers to 1024 bytes of output, may be equal to in
+  /// @param num Number of messages in batch
+  static void Encrypt(
+      TunnelEncryption* const* encryptions,
+      const std::uint8_t* const* in,
+      std::uint8_t* const* out,
+      std::size_t num);
+
  private:
   class TunnelEncryptionImpl;
   std::unique_ptr<TunnelEncryptionImpl> m_TunnelEncryptionPimpl;
@@ -74,6 +87,15 @@ class TunnelDecryption {  // with double IV encryption
       const std::uint8_t* in,
       std::uint8_t* out);  // 1024 bytes (16 IV + 1008 data)
 
+  /// @brief Decrypts a batch of tunnel messages with the same keys
+  /// @param in Array of pointers to 1024 bytes (16 IV + 1008 data) to decrypt
+  /// @param out Array of pointers to 1024 bytes of output, may be equal to in
+  /// @param num Number of messages in batch
+  void Decrypt(
+      const std::uint8_t* const* in,
+      std::uint8_t* const* out,
+      std::size_t num);
+
  private:
   class TunnelDecryptionImpl;
   std::unique_ptr<TunnelDecryptionImpl> m_TunnelDecryptionPimpl;
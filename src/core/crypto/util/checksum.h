@@ -74,6 +74,30 @@ class Adler32 {
   std::unique_ptr<Adler32Impl> m_Adler32Pimpl;
 };
 
+/// @brief Kernels which Adler32 picks from for this CPU, exposed so that
+///   each one can be tested
+/// @return Running Adler-32 of adler followed by input
+std::uint32_t Adler32Scalar(
+    std::uint32_t adler,
+    const std::uint8_t* input,
+    std::size_t length);
+
+#if defined(__x86_64__) || defined(_M_X64)
+/// @note Only call if __builtin_cpu_supports("ssse3")
+__attribute__((target("ssse3")))
+std::uint32_t Adler32SSSE3(
+    std::uint32_t adler,
+    const std::uint8_t* input,
+    std::size_t length);
+
+/// @note Only call if __builtin_cpu_supports("avx2")
+__attribute__((target("avx2")))
+std::uint32_t Adler32AVX2(
+    std::uint32_t adler,
+    const std::uint8_t* input,
+    std::size_t length);
+#endif
+
 }  // namespace core
 }  // namespace kovri
 
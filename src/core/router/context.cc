@@ -61,6 +61,10 @@ RouterContext::RouterContext()
       m_Status(eRouterStatusOK),
       m_Port(0),
       m_ReseedSkipSSLCheck(false),
+      m_TunnelWorkers(1),
+      m_TransportThreads(1),
+      m_SSUShards(1),
+      m_NTCPSendQueueSize(1024 * 1024),
       m_SupportsNTCP(true),
       m_SupportsSSU(true) {}
 
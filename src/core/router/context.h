@@ -285,6 +285,50 @@ class RouterContext : public kovri::core::GarlicDestination {
     return m_ReseedSkipSSLCheck;
   }
 
+  /// @brief Sets user-supplied number of tunnel worker threads
+  void SetOptionTunnelWorkers(
+      std::size_t num_workers) {
+    m_TunnelWorkers = num_workers;
+  }
+
+  /// @return User-supplied number of tunnel worker threads
+  std::size_t GetOptionTunnelWorkers() const {
+    return m_TunnelWorkers;
+  }
+
+  /// @brief Sets user-supplied number of transport session threads
+  void SetOptionTransportThreads(
+      std::size_t num_threads) {
+    m_TransportThreads = num_threads;
+  }
+
+  /// @return User-supplied number of transport session threads
+  std::size_t GetOptionTransportThreads() const {
+    return m_TransportThreads;
+  }
+
+  /// @brief Sets user-supplied number of SSU sockets sharing our port
+  void SetOptionSSUShards(
+      std::size_t num_shards) {
+    m_SSUShards = num_shards;
+  }
+
+  /// @return User-supplied number of SSU sockets sharing our port
+  std::size_t GetOptionSSUShards() const {
+    return m_SSUShards;
+  }
+
+  /// @brief Sets user-supplied cap of bytes queued per NTCP session
+  void SetOptionNTCPSendQueueSize(
+      std::size_t size) {
+    m_NTCPSendQueueSize = size;
+  }
+
+  /// @return User-supplied cap of bytes queued per NTCP session
+  std::size_t GetOptionNTCPSendQueueSize() const {
+    return m_NTCPSendQueueSize;
+  }
+
   /// @return root directory path
   const std::string& GetCustomDataDir() const
   {
@@ -317,6 +361,10 @@ class RouterContext : public kovri::core::GarlicDestination {
   int m_Port;
   std::string m_ReseedFrom;
   bool m_ReseedSkipSSLCheck;
+  std::size_t m_TunnelWorkers;
+  std::size_t m_TransportThreads;
+  std::size_t m_SSUShards;
+  std::size_t m_NTCPSendQueueSize;
   bool m_SupportsNTCP, m_SupportsSSU;
   std::string m_CustomDataDir;
 };
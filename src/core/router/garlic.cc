@@ -321,8 +321,10 @@ std::size_t GarlicRoutingSession::CreateGarlicPayload(
       m_LeaseSetSubmissionTime = kovri::core::GetMillisecondsSinceEpoch();
       // clove if our leaseset must be attached
       auto leaseset = CreateDatabaseStoreMsg(m_Owner->GetLeaseSet());
-      size += CreateGarlicClove(payload + size, leaseset, false);
-      (*num_cloves)++;
+      if (leaseset) {
+        size += CreateGarlicClove(payload + size, leaseset, false);
+        (*num_cloves)++;
+      }
     }
   }
   if (msg) {  // clove message ifself if presented
@@ -69,11 +69,40 @@ std::unique_ptr<I2NPMessage> NewI2NPShortMessage() {
   return std::make_unique<I2NPMessageBuffer<I2NP_MAX_SHORT_MESSAGE_SIZE>>();
 }
 
+std::unique_ptr<I2NPMessage> NewI2NPTunnelDataMessage() {
+  return std::make_unique<I2NPMessageBuffer<I2NP_MAX_TUNNEL_DATA_MESSAGE_SIZE>>();
+}
+
 std::unique_ptr<I2NPMessage> NewI2NPMessage(
     std::size_t len) {
-  return (len < I2NP_MAX_SHORT_MESSAGE_SIZE / 2) ?
-      NewI2NPShortMessage() :
-      NewI2NPMessage();
+  // Smallest size class which fits, messages which outgrow it are grown later
+  len += I2NP_MESSAGE_SIZE_CLASS_RESERVE;
+  if (len <= I2NP_MAX_TUNNEL_DATA_MESSAGE_SIZE)
+    return NewI2NPTunnelDataMessage();
+  if (len <= I2NP_MAX_SHORT_MESSAGE_SIZE)
+    return NewI2NPShortMessage();
+  return NewI2NPMessage();
+}
+
+std::shared_ptr<I2NPMessage> GrowI2NPMessage(
+    std::shared_ptr<I2NPMessage> msg,
+    std::size_t len) {
+  if (msg->len + len <= msg->max_len)
+    return msg;
+  if (msg->len + len > I2NP_MAX_MESSAGE_SIZE) {
+    LOG(error)
+      << "I2NPMessage: message size " << msg->len + len
+      << " exceeds max size " << I2NP_MAX_MESSAGE_SIZE;
+    return nullptr;
+  }
+  LOG(debug)
+    << "I2NPMessage: message size " << msg->max_len
+    << " is not enough for " << msg->len + len;
+  auto new_msg = ToSharedI2NPMessage(NewI2NPMessage(msg->len + len));
+  // Keep reserved room in front of the message
+  new_msg->offset = msg->offset;
+  *new_msg = *msg;
+  return new_msg;
 }
 
 std::shared_ptr<I2NPMessage> ToSharedI2NPMessage(
@@ -109,7 +138,7 @@ std::unique_ptr<I2NPMessage> CreateI2NPMessage(
     int len,
     std::uint32_t reply_msg_ID) {
   std::unique_ptr<I2NPMessage> msg = NewI2NPMessage(len);
-  if (msg->len + len < msg->max_len) {
+  if (msg->len + len <= msg->max_len) {
     memcpy(msg->GetPayload(), buf, len);
     msg->len += len;
   } else {
@@ -123,8 +152,8 @@ std::shared_ptr<I2NPMessage> CreateI2NPMessage(
     const std::uint8_t* buf,
     int len,
     std::shared_ptr<kovri::core::InboundTunnel> from) {
-  std::unique_ptr<I2NPMessage> msg = NewI2NPMessage();
-  if (msg->offset + len < msg->max_len) {
+  std::unique_ptr<I2NPMessage> msg = NewI2NPMessage(len);
+  if (msg->offset + len <= msg->max_len) {
     memcpy(msg->GetBuffer(), buf, len);
     msg->len = msg->offset + len;
     msg->from = from;
@@ -279,15 +308,14 @@ std::shared_ptr<I2NPMessage> CreateDatabaseStoreMsg(
     htobe16buf(buf, size);  // size
     buf += 2;
     m->len += (buf - payload);  // payload size
-    if (m->len + size > m->max_len) {
-      LOG(debug)
-        << "I2NPMessage: DatabaseStore message size is not enough for "
-        << m->len + size;
-      auto new_msg =  ToSharedI2NPMessage(NewI2NPMessage());
-      *new_msg = *m;
-      m = new_msg;
-      buf = m->buf + m->len;
+    m = GrowI2NPMessage(m, size);
+    if (!m) {
+      LOG(error)
+        << "I2NPMessage: compressed RouterInfo of " << size
+        << " bytes does not fit in a DatabaseStore message";
+      return nullptr;
     }
+    buf = m->buf + m->len;
     compressor.Get(buf, size);
     m->len += size;
     m->FillI2NPMessageHeader(I2NPDatabaseStore);
@@ -346,7 +374,9 @@ bool HandleBuildRequestRecords(
      *
      *   Total: 528 byte record
      *
-     * TODO(unassigned): implement bloom filter, see #58 + #77
+     * Replayed requests are dropped without a reply: our record is checked
+     * against recently seen records before the expensive ElGamal decryption,
+     * and its reply message ID against recently seen IDs after it.
      */
     for (int i = 0; i < num; i++) {
       std::uint8_t* record = records + i * TUNNEL_BUILD_RECORD_SIZE;
@@ -356,11 +386,20 @@ bool HandleBuildRequestRecords(
               (const std::uint8_t *)kovri::context.GetRouterInfo().GetIdentHash(),
               16)) {
         LOG(debug) << "I2NPMessage: record " << i << " is ours";
+        if (kovri::core::tunnels.IsReplayedBuildRecord(record)) {
+          LOG(debug) << "I2NPMessage: dropping replayed build request record";
+          return false;
+        }
         // Get session key from encrypted block
         kovri::core::ElGamalDecrypt(
             kovri::context.GetEncryptionPrivateKey(),
             record + BUILD_REQUEST_RECORD_ENCRYPTED_OFFSET,
             clear_text);
+        if (kovri::core::tunnels.IsReplayedBuildReplyMsgID(
+                bufbe32toh(clear_text + BUILD_REQUEST_RECORD_SEND_MSG_ID_OFFSET))) {
+          LOG(debug) << "I2NPMessage: dropping build request with replayed reply message ID";
+          return false;
+        }
         /**
          * After the current hop reads their record, we replace it with
          * a reply record stating whether or not they agree to participate
@@ -370,10 +409,11 @@ bool HandleBuildRequestRecords(
          * higher levels of rejection.
          */
         if (kovri::context.AcceptsTunnels() &&
-            kovri::core::tunnels.GetTransitTunnels().size() <=
+            kovri::core::tunnels.GetNumTransitTunnels() <=
             MAX_NUM_TRANSIT_TUNNELS &&
+            !kovri::core::tunnels.IsBuildQueueOverloaded() &&
             !kovri::core::transports.IsBandwidthExceeded()) {
-          kovri::core::TransitTunnel* transit_tunnel =
+          auto transit_tunnel =
             kovri::core::CreateTransitTunnel(
                 bufbe32toh(clear_text + BUILD_REQUEST_RECORD_RECEIVE_TUNNEL_OFFSET),
                 clear_text + BUILD_REQUEST_RECORD_NEXT_IDENT_OFFSET,
@@ -475,33 +515,40 @@ void HandleVariableTunnelBuildMsg(
       tunnel->SetState(kovri::core::e_TunnelStateBuildFailed);
     }
   } else {
-    std::uint8_t clear_text[BUILD_REQUEST_RECORD_CLEAR_TEXT_SIZE] = {};
-    if (HandleBuildRequestRecords(num, buf + 1, clear_text)) {
-      // we are endpoint of outboud tunnel
-      if (clear_text[BUILD_REQUEST_RECORD_FLAG_OFFSET] & 0x40) {
-        // So, we send it to reply tunnel
-        kovri::core::transports.SendMessage(
-            clear_text + BUILD_REQUEST_RECORD_NEXT_IDENT_OFFSET,
-            ToSharedI2NPMessage(
-                CreateTunnelGatewayMsg(
-                    bufbe32toh(
-                        clear_text + BUILD_REQUEST_RECORD_NEXT_TUNNEL_OFFSET),
-                    I2NPVariableTunnelBuildReply,
-                    buf,
-                    len,
-                    bufbe32toh(
-                        clear_text + BUILD_REQUEST_RECORD_SEND_MSG_ID_OFFSET))));
-      } else {
-        kovri::core::transports.SendMessage(
-            clear_text + BUILD_REQUEST_RECORD_NEXT_IDENT_OFFSET,
-            ToSharedI2NPMessage(
-                CreateI2NPMessage(
-                    I2NPVariableTunnelBuild,
-                    buf,
-                    len,
-                    bufbe32toh(
-                        clear_text + BUILD_REQUEST_RECORD_SEND_MSG_ID_OFFSET))));
-      }
+    HandleVariableTunnelBuildRequestMsg(buf, len);
+  }
+}
+
+void HandleVariableTunnelBuildRequestMsg(
+    std::uint8_t* buf,
+    std::size_t len) {
+  int num = buf[0];
+  std::uint8_t clear_text[BUILD_REQUEST_RECORD_CLEAR_TEXT_SIZE] = {};
+  if (HandleBuildRequestRecords(num, buf + 1, clear_text)) {
+    // we are endpoint of outboud tunnel
+    if (clear_text[BUILD_REQUEST_RECORD_FLAG_OFFSET] & 0x40) {
+      // So, we send it to reply tunnel
+      kovri::core::transports.SendMessage(
+          clear_text + BUILD_REQUEST_RECORD_NEXT_IDENT_OFFSET,
+          ToSharedI2NPMessage(
+              CreateTunnelGatewayMsg(
+                  bufbe32toh(
+                      clear_text + BUILD_REQUEST_RECORD_NEXT_TUNNEL_OFFSET),
+                  I2NPVariableTunnelBuildReply,
+                  buf,
+                  len,
+                  bufbe32toh(
+                      clear_text + BUILD_REQUEST_RECORD_SEND_MSG_ID_OFFSET))));
+    } else {
+      kovri::core::transports.SendMessage(
+          clear_text + BUILD_REQUEST_RECORD_NEXT_IDENT_OFFSET,
+          ToSharedI2NPMessage(
+              CreateI2NPMessage(
+                  I2NPVariableTunnelBuild,
+                  buf,
+                  len,
+                  bufbe32toh(
+                      clear_text + BUILD_REQUEST_RECORD_SEND_MSG_ID_OFFSET))));
     }
   }
 }
@@ -569,7 +616,7 @@ void HandleVariableTunnelBuildReplyMsg(
 
 std::unique_ptr<I2NPMessage> CreateTunnelDataMsg(
     const std::uint8_t * buf) {
-  std::unique_ptr<I2NPMessage> msg = NewI2NPShortMessage();
+  std::unique_ptr<I2NPMessage> msg = NewI2NPTunnelDataMessage();
   memcpy(msg->GetPayload(), buf, kovri::core::TUNNEL_DATA_MSG_SIZE);
   msg->len += kovri::core::TUNNEL_DATA_MSG_SIZE;
   msg->FillI2NPMessageHeader(I2NPTunnelData);
@@ -579,7 +626,7 @@ std::unique_ptr<I2NPMessage> CreateTunnelDataMsg(
 std::unique_ptr<I2NPMessage> CreateTunnelDataMsg(
     std::uint32_t tunnel_ID,
     const std::uint8_t* payload) {
-  std::unique_ptr<I2NPMessage> msg = NewI2NPShortMessage();
+  std::unique_ptr<I2NPMessage> msg = NewI2NPTunnelDataMessage();
   memcpy(msg->GetPayload() + 4, payload, kovri::core::TUNNEL_DATA_MSG_SIZE - 4);
   htobe32buf(msg->GetPayload(), tunnel_ID);
   msg->len += kovri::core::TUNNEL_DATA_MSG_SIZE;
@@ -588,7 +635,7 @@ std::unique_ptr<I2NPMessage> CreateTunnelDataMsg(
 }
 
 std::shared_ptr<I2NPMessage> CreateEmptyTunnelDataMsg() {
-  std::unique_ptr<I2NPMessage> msg = NewI2NPShortMessage();
+  std::unique_ptr<I2NPMessage> msg = NewI2NPTunnelDataMessage();
   msg->len += kovri::core::TUNNEL_DATA_MSG_SIZE;
   return ToSharedI2NPMessage(std::move(msg));
 }
@@ -33,6 +33,7 @@
 #ifndef SRC_CORE_ROUTER_I2NP_H_
 #define SRC_CORE_ROUTER_I2NP_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 
@@ -48,6 +49,7 @@
 
 #include "core/util/exception.h"
 #include "core/util/i2p_endian.h"
+#include "core/util/memory_pool.h"
 
 namespace kovri {
 namespace core {
@@ -70,6 +72,11 @@ const std::size_t I2NP_HEADER_TYPEID_OFFSET = 0,
 
              I2NP_MAX_MESSAGE_SIZE = 32768,
              I2NP_MAX_SHORT_MESSAGE_SIZE = 4096,
+             // 1028 bytes of tunnel data plus I2NP_MESSAGE_SIZE_CLASS_RESERVE
+             I2NP_MAX_TUNNEL_DATA_MESSAGE_SIZE = 1120,
+             // Room kept for NTCP prefix, nested headers and alignment
+             // when picking a size class for a payload
+             I2NP_MESSAGE_SIZE_CLASS_RESERVE = 64,
 
              // Tunnel Gateway header
              TUNNEL_GATEWAY_HEADER_TUNNELID_OFFSET = 0,
@@ -164,6 +171,9 @@ struct I2NPMessage {
         from(nullptr),
         exception(__func__) {}
 
+  // Messages are deleted through base pointers, see I2NPMessageBuffer
+  virtual ~I2NPMessage() {}
+
   // header accessors
   std::uint8_t* GetHeader() {
     return GetBuffer();
@@ -259,9 +269,9 @@ struct I2NPMessage {
 
   I2NPMessage& operator=(const I2NPMessage& other) {
     memcpy(buf + offset, other.buf + other.offset, other.GetLength());
+    // max_len describes our own buffer, so it is not copied
     len = offset + other.GetLength();
     from = other.from;
-    max_len = other.max_len;
     return *this;
   }
 
@@ -312,6 +322,26 @@ struct I2NPMessageBuffer : public I2NPMessage {
     buf = m_Buffer;
     max_len = SZ;
   }
+
+  /// @return Pool which recycles buffers of this size class
+  static auto& GetPool() {
+    return kovri::core::MemoryPool<sizeof(I2NPMessageBuffer<SZ>)>::Instance();
+  }
+
+  // Buffers are recycled when the last owner (unique_ptr or shared_ptr) drops them
+  static void* operator new(std::size_t size) {
+    if (size != sizeof(I2NPMessageBuffer<SZ>))
+      return ::operator new(size);
+    return GetPool().Allocate();
+  }
+
+  static void operator delete(void* ptr, std::size_t size) {
+    if (size != sizeof(I2NPMessageBuffer<SZ>))
+      ::operator delete(ptr);
+    else
+      GetPool().Free(ptr);
+  }
+
   std::uint8_t m_Buffer[SZ + 16] = {};
 };
 
@@ -324,6 +354,16 @@ std::unique_ptr<I2NPMessage> NewI2NPMessage(
 
 std::unique_ptr<I2NPMessage> NewI2NPShortMessage();
 
+/// @return Message sized for exactly one tunnel data message
+std::unique_ptr<I2NPMessage> NewI2NPTunnelDataMessage();
+
+/// @brief Makes room for len more bytes at the end of a message
+/// @return msg itself if it has room, otherwise a copy in a larger size class,
+///   or null if the message would outgrow the largest size class
+std::shared_ptr<I2NPMessage> GrowI2NPMessage(
+    std::shared_ptr<I2NPMessage> msg,
+    std::size_t len);
+
 std::shared_ptr<I2NPMessage> ToSharedI2NPMessage(
     std::unique_ptr<I2NPMessage> msg);
 
@@ -375,6 +415,11 @@ void HandleVariableTunnelBuildMsg(
     std::uint8_t* buf,
     std::size_t len);
 
+/// @brief Handles a VariableTunnelBuild message which is not a reply for our own tunnel
+void HandleVariableTunnelBuildRequestMsg(
+    std::uint8_t* buf,
+    std::size_t len);
+
 void HandleVariableTunnelBuildReplyMsg(
     std::uint32_t reply_msg_ID,
     std::uint8_t* buf,
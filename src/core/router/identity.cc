@@ -46,6 +46,7 @@
 #include "core/router/context.h"
 
 #include "core/util/base64.h"
+#include "core/util/byte_stream.h"
 #include "core/util/exception.h"
 #include "core/util/i2p_endian.h"
 #include "core/util/log.h"
@@ -668,31 +669,24 @@ Keys CreateRandomKeys() {
   return keys;
 }
 
-IdentHash CreateRoutingKey(
-    const IdentHash& ident) {
+IdentHash CalculateRoutingKey(
+    const IdentHash& ident,
+    std::time_t time) {
   std::uint8_t buf[41];  // ident + yyyymmdd
   memcpy(buf, (const std::uint8_t *)ident, 32);
-  time_t t = time(nullptr);
   struct tm tm;
-  // TODO(unassigned): never use sprintf, use snprintf instead.
 #ifdef _WIN32
-  gmtime_s(&tm, &t);
-  sprintf_s(
-      reinterpret_cast<char *>((buf + 32)),
-      9,
-      "%04i%02i%02i",
-      tm.tm_year + 1900,
-      tm.tm_mon + 1,
-      tm.tm_mday);
+  gmtime_s(&tm, &time);
 #else
-  gmtime_r(&t, &tm);
-  sprintf(
+  gmtime_r(&time, &tm);
+#endif
+  snprintf(
       reinterpret_cast<char *>((buf + 32)),
+      9,
       "%04i%02i%02i",
       tm.tm_year + 1900,
       tm.tm_mon + 1,
       tm.tm_mday);
-#endif
   IdentHash key;
   // TODO(anonimal): this try block should be larger or handled entirely by caller
   try {
@@ -706,6 +700,40 @@ IdentHash CreateRoutingKey(
   return key;
 }
 
+RoutingKeyCache::RoutingKeyCache()
+    : m_Day(0) {}
+
+IdentHash RoutingKeyCache::Get(
+    const IdentHash& ident,
+    std::time_t time) {
+  // POSIX time has no leap seconds, so days start at multiples of 86400
+  const std::time_t day = time / 86400;
+  {
+    std::unique_lock<std::mutex> l(m_KeysMutex);
+    if (day != m_Day) {
+      m_Keys.clear();
+      m_Day = day;
+    }
+    auto it = m_Keys.find(ident);
+    if (it != m_Keys.end())
+      return it->second;
+  }
+  IdentHash key = CalculateRoutingKey(ident, time);
+  std::unique_lock<std::mutex> l(m_KeysMutex);
+  if (day == m_Day) {
+    if (m_Keys.size() >= GetType(RoutingKeyCacheSize::MaxEntries))
+      m_Keys.clear();
+    m_Keys[ident] = key;
+  }
+  return key;
+}
+
+IdentHash CreateRoutingKey(
+    const IdentHash& ident) {
+  static RoutingKeyCache cache;
+  return cache.Get(ident, time(nullptr));
+}
+
 XORMetric operator^(
     const IdentHash& key1,
     const IdentHash& key2) {
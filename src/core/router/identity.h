@@ -37,7 +37,10 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <ctime>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "core/crypto/elgamal.h"
@@ -368,6 +371,49 @@ struct XORMetric {
   }
 };
 
+/// @brief Calculates routing key of ident, i.e., SHA-256 of ident and date
+/// @param ident Ident hash to calculate key for
+/// @param time Time within the UTC day the key is valid for
+/// @return Routing key
+IdentHash CalculateRoutingKey(
+    const IdentHash& ident,
+    std::time_t time);
+
+/// @enum RoutingKeyCacheSize
+/// @brief Bounds of the routing key cache
+enum struct RoutingKeyCacheSize : std::uint16_t {
+  /// @var MaxEntries
+  /// @brief Cache is emptied when full, as lookup keys can be chosen by peers
+  MaxEntries = 8192,
+};
+
+/// @class RoutingKeyCache
+/// @brief Caches routing keys until UTC midnight, when they all change
+class RoutingKeyCache {
+ public:
+  RoutingKeyCache();
+
+  /// @brief Gets (or calculates and caches) routing key of ident
+  /// @param ident Ident hash to get key for
+  /// @param time Current time
+  /// @return Routing key
+  IdentHash Get(
+      const IdentHash& ident,
+      std::time_t time);
+
+  std::size_t GetSize() const {
+    std::unique_lock<std::mutex> l(m_KeysMutex);
+    return m_Keys.size();
+  }
+
+ private:
+  mutable std::mutex m_KeysMutex;
+  std::time_t m_Day;  // days since epoch the cached keys are valid for
+  std::map<IdentHash, IdentHash> m_Keys;
+};
+
+/// @brief Gets routing key of ident for the current UTC day
+/// @details Keys are cached until UTC midnight
 IdentHash CreateRoutingKey(
     const IdentHash& ident);
 
@@ -38,7 +38,9 @@
 #include <string.h>
 
 #include <fstream>
+#include <limits>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -85,6 +87,18 @@ RouterInfo::RouterInfo(
   ReadFromBuffer(true);
 }
 
+RouterInfo::RouterInfo(
+    const std::uint8_t* buf,
+    std::size_t len,
+    bool verify_signature)
+    : m_BufferLen(0),
+      m_IsUpdated(false),
+      m_IsUnreachable(false),
+      m_SupportedTransports(0),
+      m_Caps(0) {
+  ReadFromBuffer(buf, len, verify_signature);
+}
+
 RouterInfo::~RouterInfo() {}
 
 void RouterInfo::Update(
@@ -137,19 +151,38 @@ void RouterInfo::ReadFromFile() {
 
 void RouterInfo::ReadFromBuffer(
     bool verify_signature) {
-  std::size_t identity_len = m_RouterIdentity.FromBuffer(m_Buffer.get(), m_BufferLen);
-  std::stringstream str(
-      std::string(
-        reinterpret_cast<char *>(m_Buffer.get()) + identity_len,
-        m_BufferLen - identity_len));
-  ReadFromStream(str);
+  ReadFromBuffer(m_Buffer.get(), m_BufferLen, verify_signature);
+}
+
+void RouterInfo::ReadFromBuffer(
+    const std::uint8_t* buf,
+    std::size_t len,
+    bool verify_signature) {
+  std::size_t identity_len = m_RouterIdentity.FromBuffer(buf, len);
+  if (!identity_len) {
+    LOG(error) << "RouterInfo: malformed identity";
+    m_IsUnreachable = true;
+    return;
+  }
+  try {
+    // The stream is only read from
+    InputByteStream s(
+        const_cast<std::uint8_t*>(buf) + identity_len,
+        len - identity_len);
+    ReadFromByteStream(s);
+  } catch (const std::length_error& ex) {
+    LOG(error) << "RouterInfo: truncated RouterInfo, " << ex.what();
+    m_IsUnreachable = true;
+    return;
+  }
   if (verify_signature) {
     // verify signature
-    int len = m_BufferLen - m_RouterIdentity.GetSignatureLen();
-    if (!m_RouterIdentity.Verify(
-          reinterpret_cast<std::uint8_t *>(m_Buffer.get()),
-          len,
-          reinterpret_cast<std::uint8_t *>(m_Buffer.get() + len))) {
+    const std::size_t signature_len = m_RouterIdentity.GetSignatureLen();
+    if (len < identity_len + signature_len
+        || !m_RouterIdentity.Verify(
+            buf,
+            len - signature_len,
+            buf + len - signature_len)) {
       LOG(error) << "RouterInfo: signature verification failed";
       m_IsUnreachable = true;
     }
@@ -157,123 +190,98 @@ void RouterInfo::ReadFromBuffer(
   }
 }
 
-void RouterInfo::ReadFromStream(
-    std::istream& s) {
-  s.read(reinterpret_cast<char *>(&m_Timestamp), sizeof(m_Timestamp));
-  m_Timestamp = be64toh(m_Timestamp);
+namespace {
+
+/// @brief Reads a length-prefixed I2P string in place
+boost::string_ref ReadString(
+    InputByteStream& s) {
+  const std::uint8_t len = s.ReadUInt8();
+  return boost::string_ref(
+      reinterpret_cast<const char*>(s.ReadBytes(len)),
+      len);
+}
+
+/// @brief Reads a key=value; option in place
+/// @return Bytes read
+std::size_t ReadOption(
+    InputByteStream& s,
+    boost::string_ref& key,
+    boost::string_ref& value) {
+  key = ReadString(s);
+  s.ConsumeData(1);  // =
+  value = ReadString(s);
+  s.ConsumeData(1);  // ;
+  return key.size() + value.size() + 4;
+}
+
+/// @brief Parses an unsigned decimal number
+/// @return False if value is empty, not a number or out of range
+template <typename Number>
+bool ParseNumber(
+    boost::string_ref value,
+    Number& number) {
+  if (value.empty() || value.size() > 10)
+    return false;
+  std::uint64_t result = 0;
+  for (char c : value) {
+    if (c < '0' || c > '9')
+      return false;
+    result = result * 10 + (c - '0');
+  }
+  if (result > std::numeric_limits<Number>::max())
+    return false;
+  number = static_cast<Number>(result);
+  return true;
+}
+
+/// @brief Parses a port into the int which addresses keep it in
+/// @return False if value is not a number from 0 to 65535
+bool ParsePort(
+    boost::string_ref value,
+    int& port) {
+  std::uint16_t result;
+  if (!ParseNumber(value, result))
+    return false;
+  port = result;
+  return true;
+}
+
+}  // namespace
+
+void RouterInfo::ReadFromByteStream(
+    InputByteStream& s) {
+  m_Timestamp = s.ReadUInt64();
   // read addresses
-  std::uint8_t num_addresses;
-  s.read(reinterpret_cast<char *>(&num_addresses), sizeof(num_addresses));
+  const std::uint8_t num_addresses = s.ReadUInt8();
   bool introducers = false;
-  for (int i = 0; i < num_addresses; i++) {
-    bool is_valid_address = true;
+  for (std::uint8_t i = 0; i < num_addresses; i++) {
     Address address;
-    s.read(reinterpret_cast<char *>(&address.cost), sizeof(address.cost));
-    s.read(reinterpret_cast<char *>(&address.date), sizeof(address.date));
-    char transport_style[5];
-    ReadString(transport_style, s);
-    if (!strcmp(transport_style, "NTCP"))
+    address.cost = s.ReadUInt8();
+    address.date = s.ReadUInt64();
+    const boost::string_ref transport_style = ReadString(s);
+    if (transport_style == "NTCP")
       address.transport_style = eTransportNTCP;
-    else if (!strcmp(transport_style, "SSU"))
+    else if (transport_style == "SSU")
       address.transport_style = eTransportSSU;
     else
       address.transport_style = eTransportUnknown;
     address.port = 0;
     address.mtu = 0;
-    std::uint16_t size, r = 0;
-    s.read(reinterpret_cast<char *>(&size), sizeof(size));
-    size = be16toh(size);
-    while (r < size) {
-      char key[500], value[500];
-      r += ReadString(key, s);
-      s.seekg(1, std::ios_base::cur);
-      r++;  // =
-      r += ReadString(value, s);
-      s.seekg(1, std::ios_base::cur);
-      r++;  // ;
-      if (!strcmp(key, "host")) {
-        boost::system::error_code ecode;
-        address.host = boost::asio::ip::address::from_string(value, ecode);
-        if (ecode) {  // no error
-          if (address.transport_style == eTransportNTCP) {
-            m_SupportedTransports |= eNTCPV4;  // TODO(unassigned): ???
-            address.address_string = value;
-          } else {
-            // TODO(unassigned): resolve address for SSU
-            LOG(warning) << "RouterInfo: unexpected SSU address " << value;
-            is_valid_address = false;
-          }
-        } else {
-          // add supported protocol
-          if (address.host.is_v4())
-            m_SupportedTransports |=
-              (address.transport_style == eTransportNTCP) ? eNTCPV4 : eSSUV4;
-          else
-            m_SupportedTransports |=
-              (address.transport_style == eTransportNTCP) ? eNTCPV6 : eSSUV6;
-        }
-      } else if (!strcmp(key, "port")) {
-        address.port = boost::lexical_cast<int>(value);
-      } else if (!strcmp(key, "mtu")) {
-        address.mtu = boost::lexical_cast<int>(value);
-      } else if (!strcmp(key, "key")) {
-        kovri::core::Base64ToByteStream(value, strlen(value), address.key, 32);
-      } else if (!strcmp(key, "caps")) {
-        ExtractCaps(value);
-      } else if (key[0] == 'i') {
-        // introducers
-        introducers = true;
-        std::size_t len = strlen(key);
-        unsigned char index = key[len - 1] - '0';  // TODO(unassigned): ???
-        key[len - 1] = 0;
-        if (index >= address.introducers.size())
-          address.introducers.resize(index + 1);
-        Introducer& introducer = address.introducers.at(index);
-        if (!strcmp(key, "ihost")) {
-          boost::system::error_code ecode;
-          introducer.host =
-            boost::asio::ip::address::from_string(value, ecode);
-        } else if (!strcmp(key, "iport")) {
-          introducer.port = boost::lexical_cast<int>(value);
-        } else if (!strcmp(key, "itag")) {
-          introducer.tag = boost::lexical_cast<std::uint32_t>(value);
-        } else if (!strcmp(key, "ikey")) {
-          kovri::core::Base64ToByteStream(
-              value,
-              strlen(value),
-              introducer.key,
-              32);
-        }
-      }
-    }
-    if (is_valid_address)
+    if (ReadAddressOptions(s, address, introducers))
       m_Addresses.push_back(address);
   }
   // read peers
-  std::uint8_t num_peers;
-  s.read(reinterpret_cast<char *>(&num_peers), sizeof(num_peers));
-  s.seekg(num_peers*32, std::ios_base::cur);  // TODO(unassigned): read peers
+  const std::uint8_t num_peers = s.ReadUInt8();
+  s.ConsumeData(num_peers * 32);  // TODO(unassigned): read peers
   // read properties
-  std::uint16_t size, r = 0;
-  s.read(reinterpret_cast<char *>(&size), sizeof(size));
-  size = be16toh(size);
+  const std::uint16_t size = s.ReadUInt16();
+  std::size_t r = 0;
   while (r < size) {
-#ifdef _WIN32
-    char key[500], value[500];
-    // TODO(unassigned): investigate why properties get read as one
-    // long string under Windows. Length should not be more than 44.
-#else
-    char key[50], value[50];
-#endif
-    r += ReadString(key, s);
-    s.seekg(1, std::ios_base::cur);
-    r++;  // =
-    r += ReadString(value, s);
-    s.seekg(1, std::ios_base::cur);
-    r++;  // ;
-    m_Properties[key] = value;
+    boost::string_ref key, value;
+    r += ReadOption(s, key, value);
+    m_Properties[key.to_string()] = value.to_string();
     // extract caps
-    if (!strcmp(key, "caps"))
+    if (key == "caps")
       ExtractCaps(value);
   }
   if (!m_SupportedTransports || !m_Addresses.size() ||
@@ -281,11 +289,88 @@ void RouterInfo::ReadFromStream(
     SetUnreachable(true);
 }
 
+bool RouterInfo::ReadAddressOptions(
+    InputByteStream& s,
+    Address& address,
+    bool& introducers) {
+  bool is_valid_address = true;
+  const std::uint16_t size = s.ReadUInt16();
+  std::size_t r = 0;
+  while (r < size) {
+    boost::string_ref key, value;
+    r += ReadOption(s, key, value);
+    if (key == "host") {
+      boost::system::error_code ecode;
+      address.host =
+        boost::asio::ip::address::from_string(value.to_string(), ecode);
+      if (ecode) {  // no error
+        if (address.transport_style == eTransportNTCP) {
+          m_SupportedTransports |= eNTCPV4;  // TODO(unassigned): ???
+          address.address_string = value.to_string();
+        } else {
+          // TODO(unassigned): resolve address for SSU
+          LOG(warning) << "RouterInfo: unexpected SSU address " << value;
+          is_valid_address = false;
+        }
+      } else {
+        // add supported protocol
+        if (address.host.is_v4())
+          m_SupportedTransports |=
+            (address.transport_style == eTransportNTCP) ? eNTCPV4 : eSSUV4;
+        else
+          m_SupportedTransports |=
+            (address.transport_style == eTransportNTCP) ? eNTCPV6 : eSSUV6;
+      }
+    } else if (key == "port") {
+      if (!ParsePort(value, address.port))
+        is_valid_address = false;
+    } else if (key == "mtu") {
+      if (!ParseNumber(value, address.mtu))
+        is_valid_address = false;
+    } else if (key == "key") {
+      kovri::core::Base64ToByteStream(
+          value.data(),
+          value.size(),
+          address.key,
+          32);
+    } else if (key == "caps") {
+      ExtractCaps(value);
+    } else if (key.size() > 1 && key.front() == 'i') {
+      // introducers, e.g., ihost0
+      if (key.back() < '0' || key.back() > '9')
+        continue;  // not an introducer option, skip it as any unknown key
+      introducers = true;
+      const std::size_t index = key.back() - '0';
+      if (index >= address.introducers.size())
+        address.introducers.resize(index + 1);
+      Introducer& introducer = address.introducers.at(index);
+      key.remove_suffix(1);
+      if (key == "ihost") {
+        boost::system::error_code ecode;
+        introducer.host =
+          boost::asio::ip::address::from_string(value.to_string(), ecode);
+      } else if (key == "iport") {
+        if (!ParsePort(value, introducer.port))
+          is_valid_address = false;
+      } else if (key == "itag") {
+        if (!ParseNumber(value, introducer.tag))
+          is_valid_address = false;
+      } else if (key == "ikey") {
+        kovri::core::Base64ToByteStream(
+            value.data(),
+            value.size(),
+            introducer.key,
+            32);
+      }
+    }
+  }
+  return is_valid_address;
+}
+
 void RouterInfo::ExtractCaps(
-    const char* value) {
-  const char* cap = value;
-  while (*cap) {
-    switch (*cap) {
+    boost::string_ref value) {
+  for (char cap : value) {
+    switch (cap) {
       case CAPS_FLAG_FLOODFILL:
         m_Caps |= Caps::eFloodfill;
         break;
@@ -315,7 +400,6 @@ void RouterInfo::ExtractCaps(
         break;
       default: {}
     }
-    cap++;
   }
 }
 
@@ -344,7 +428,8 @@ void RouterInfo::WriteToStream(
   s.write(reinterpret_cast<char *>(&num_addresses), sizeof(num_addresses));
   for (auto& address : m_Addresses) {
     s.write(reinterpret_cast<char *>(&address.cost), sizeof(address.cost));
-    s.write(reinterpret_cast<char *>(&address.date), sizeof(address.date));
+    std::uint64_t date = htobe64(address.date);
+    s.write(reinterpret_cast<char *>(&date), sizeof(date));
     std::stringstream properties;
     if (address.transport_style == eTransportNTCP) {
       WriteString("NTCP", s);
@@ -459,6 +544,19 @@ void RouterInfo::WriteToStream(
   s.write(properties.str().c_str(), properties.str().size());
 }
 
+void RouterInfo::SetBuffer(
+    const std::uint8_t* buf,
+    std::size_t len) {
+  if (len > MAX_RI_BUFFER_SIZE) {
+    LOG(error) << "RouterInfo: buffer too long, " << len << " bytes";
+    return;
+  }
+  if (!m_Buffer)
+    m_Buffer = std::make_unique<std::uint8_t[]>(MAX_RI_BUFFER_SIZE);
+  memcpy(m_Buffer.get(), buf, len);
+  m_BufferLen = len;
+}
+
 const std::uint8_t* RouterInfo::LoadBuffer() {
   if (!m_Buffer) {
     if (LoadFile())
@@ -502,16 +600,6 @@ void RouterInfo::SaveToFile(
   }
 }
 
-std::size_t RouterInfo::ReadString(
-    char* str,
-    std::istream& s) {
-  std::uint8_t len;
-  s.read(reinterpret_cast<char *>(&len), 1);
-  s.read(str, len);
-  str[len] = 0;
-  return len+1;
-}
-
 void RouterInfo::WriteString(
     const std::string& str,
     std::ostream& s) {
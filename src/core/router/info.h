@@ -34,6 +34,7 @@
 #define SRC_CORE_ROUTER_INFO_H_
 
 #include <boost/asio.hpp>
+#include <boost/utility/string_ref.hpp>
 
 #include <cstddef>
 #include <cstdint>
@@ -46,6 +47,8 @@
 #include "core/router/identity.h"
 #include "core/router/profiling.h"
 
+#include "core/util/byte_stream.h"
+
 namespace kovri {
 namespace core {
 
@@ -130,6 +133,15 @@ class RouterInfo : public RoutingDestination {
       const std::uint8_t* buf,
       int len);
 
+  /// @brief Creates RouterInfo from a buffer which is kept elsewhere,
+  ///   e.g., a stored RouterInfo
+  /// @details The buffer is parsed only: it is neither copied nor verified.
+  ///   Use SetBuffer() when it is needed again.
+  RouterInfo(
+      const std::uint8_t* buf,
+      std::size_t len,
+      bool verify_signature);
+
   RouterInfo& operator=(const RouterInfo&) = default;
 
   const IdentityEx& GetRouterIdentity() const {
@@ -253,6 +265,11 @@ class RouterInfo : public RoutingDestination {
 
   const std::uint8_t* LoadBuffer();  // load if necessary
 
+  /// @brief Sets buffer without parsing it, e.g., when loaded from a store
+  void SetBuffer(
+      const std::uint8_t* buf,
+      std::size_t len);
+
   int GetBufferLen() const {
     return m_BufferLen;
   }
@@ -305,25 +322,35 @@ class RouterInfo : public RoutingDestination {
 
   void ReadFromFile();
 
-  void ReadFromStream(
-      std::istream& s);
+  /// @brief Parses RouterInfo fields in place, without copying the buffer
+  /// @throw std::length_error if a field exceeds the buffer
+  void ReadFromByteStream(
+      InputByteStream& s);
+
+  /// @brief Parses the options of an address
+  /// @return False if address can't be used
+  bool ReadAddressOptions(
+      InputByteStream& s,
+      Address& address,
+      bool& introducers);
+
+  void ReadFromBuffer(
+      bool verify_signature);
 
   void ReadFromBuffer(
+      const std::uint8_t* buf,
+      std::size_t len,
       bool verify_signature);
 
   void WriteToStream(
       std::ostream& s);
 
-  std::size_t ReadString(
-      char* str,
-      std::istream& s);
-
   void WriteString(
       const std::string& str,
       std::ostream& s);
 
   void ExtractCaps(
-      const char* value);
+      boost::string_ref value);
 
   const Address* GetAddress(
       TransportStyle s,
@@ -38,6 +38,7 @@
 
 #include <cctype>
 #include <fstream>
+#include <iterator>
 #include <memory>
 #include <set>
 #include <string>
@@ -88,13 +89,15 @@ void NetDb::Stop() {
       it.second->SaveProfile();
     DeleteObsoleteProfiles();
     m_RouterInfos.clear();
-    m_Floodfills.clear();
+    m_RouterIndex.Clear();
+    m_Floodfills.Clear();
     if (m_Thread) {
       m_IsRunning = false;
       m_Queue.WakeUp();
       m_Thread->join();
       m_Thread.reset(nullptr);
     }
+    m_Store.Close();
     m_LeaseSets.clear();
     m_Requests.Stop();
   }
@@ -213,17 +216,29 @@ void NetDb::AddRouterInfo(
   if (r) {
     auto ts = r->GetTimestamp();
     r->Update(buf, len);
-    if (r->GetTimestamp() > ts)
+    if (r->GetTimestamp() > ts) {
       LOG(debug) << "NetDb: RouterInfo updated";
+      // caps may have changed
+      {
+        std::unique_lock<std::mutex> l(m_RouterInfosMutex);
+        m_RouterIndex.Add(r);
+      }
+      std::unique_lock<std::mutex> l(m_FloodfillsMutex);
+      if (r->IsFloodfill())
+        m_Floodfills.Add(r);
+      else
+        m_Floodfills.Remove(r);
+    }
   } else {
     LOG(debug) << "NetDb: new RouterInfo added";
     r = std::make_shared<RouterInfo> (buf, len); {
       std::unique_lock<std::mutex> l(m_RouterInfosMutex);
       m_RouterInfos[r->GetIdentHash()] = r;
+      m_RouterIndex.Add(r);
     }
     if (r->IsFloodfill()) {
       std::unique_lock<std::mutex> l(m_FloodfillsMutex);
-      m_Floodfills.push_back(r);
+      m_Floodfills.Add(r);
     }
   }
   // take care about requested destination
@@ -292,30 +307,6 @@ bool NetDb::CreateNetDb(boost::filesystem::path directory)
     {
       LOG(debug) << "NetDb: ensuring " << directory.string();
       core::EnsurePath(directory);
-// TODO(unassigned): this is a patch for #520 until we implement a database in #385
-#if defined(_WIN32) || defined(__APPLE__)
-      core::EnsurePath(directory / "uppercase");
-      core::EnsurePath(directory / "lowercase");
-#endif
-    // list of chars might appear in base64 string
-    const char* chars = kovri::core::GetBase64SubstitutionTable();  // 64 bytes
-    boost::filesystem::path suffix;
-    for (int i = 0; i < 64; i++)
-      {
-#ifdef _WIN32
-        suffix = std::string("\\r") + chars[i];
-#else
-        suffix = std::string("/r") + chars[i];
-#endif
-        // TODO(unassigned): this is a patch for #520 until we implement a database in #385
-        std::string sub_dir;
-#if defined(_WIN32) || defined(__APPLE__)
-        sub_dir = std::isupper(chars[i]) ? "uppercase" : "lowercase";
-#endif
-        const auto& path = directory / sub_dir / suffix;
-        LOG(debug) << "NetDb: ensuring " << path;
-        core::EnsurePath(path);
-      }
     }
   catch (...)
     {
@@ -325,86 +316,152 @@ bool NetDb::CreateNetDb(boost::filesystem::path directory)
   return true;
 }
 
-bool NetDb::Load()
+void NetDb::Import(const boost::filesystem::path& path)
 {
-  // Create NetDb if it does not exist
-  const auto& path = core::GetNetDbPath();
-  if (!CreateNetDb(path))
-    return false;
-  // Cleanup the database from previous attempts
-  m_RouterInfos.clear();
-  m_Floodfills.clear();
-  // Load RI's from given path
-  std::size_t num_routers = 0;
-  auto LoadRouterInfos = [&](const boost::filesystem::path& path) {
-    std::uint64_t timestamp = kovri::core::GetMillisecondsSinceEpoch();
+  // Previous versions stored one file per RI in r?/ subdirectories,
+  // named after the first base64 character of the ident hash
+  struct SubDir
+  {
+    boost::filesystem::path path;
+    std::vector<boost::filesystem::path> imported;
+    bool is_complete;
+  };
+  std::vector<SubDir> sub_dirs;
+  auto IsSubDir = [](const boost::filesystem::path& path) {
+    const std::string name = path.filename().string();
+    return name.size() == 2 && name[0] == 'r'
+           && (std::isalnum(static_cast<unsigned char>(name[1]))
+               || name[1] == '-' || name[1] == '~');
+  };
+  auto ImportRouterInfos = [&](const boost::filesystem::path& path) {
+    if (!boost::filesystem::is_directory(path))
+      return;
     boost::filesystem::directory_iterator end;
     for (boost::filesystem::directory_iterator dir(path); dir != end; ++dir)
       {
-        if (boost::filesystem::is_directory(dir->status()))
+        if (!boost::filesystem::is_directory(dir->status())
+            || !IsSubDir(dir->path()))
+          continue;
+        SubDir sub_dir {dir->path(), {}, true};
+        for (boost::filesystem::directory_iterator it(dir->path());
+             it != end;
+             ++it)
           {
-            for (boost::filesystem::directory_iterator it(dir->path());
-                 it != end;
-                 ++it)
+            std::ifstream f(it->path().string(), std::ifstream::binary);
+            std::vector<std::uint8_t> buf(
+                (std::istreambuf_iterator<char>(f)),
+                std::istreambuf_iterator<char>());
+            IdentityEx identity;
+            if (f.bad() || buf.size() > MAX_RI_BUFFER_SIZE
+                || !identity.FromBuffer(buf.data(), buf.size()))
               {
-                const std::string& full_path = it->path().string();
-                auto router = std::make_shared<RouterInfo>(full_path);
-                if (!router->IsUnreachable()
-                    && (!router->UsesIntroducer()
-                        || timestamp < router->GetTimestamp()
-                                    + GetType(NetDbTime::RouterExpiration)))
-                  {
-                    router->DeleteBuffer();
-                    router->ClearProperties();  // properties are not used for regular routers
-                    m_RouterInfos.insert(std::make_pair(router->GetIdentHash(), router));
-                    if (router->IsFloodfill())
-                      m_Floodfills.push_back(router);
-                    num_routers++;
-                  }
-                else
-                  {
-                    // Remove unreachable routers
-                    if (boost::filesystem::remove(full_path))
-                      LOG(debug) << "NetDb: " << full_path
-                                 << " unreachable router removed";
-                  }
+                LOG(warning)
+                  << "NetDb: can't import " << it->path().string();
+                sub_dir.is_complete = false;
+                continue;
               }
+            m_Store.Put(identity.GetIdentHash(), buf.data(), buf.size());
+            sub_dir.imported.push_back(it->path());
           }
+        sub_dirs.push_back(std::move(sub_dir));
       }
   };
-// TODO(unassigned): this is a patch for #520 until we implement a database in #385
+  try
+    {
 #if defined(_WIN32) || defined(__APPLE__)
-  LoadRouterInfos(path / "uppercase");
-  LoadRouterInfos(path / "lowercase");
+      ImportRouterInfos(path / "uppercase");
+      ImportRouterInfos(path / "lowercase");
 #else
-  LoadRouterInfos(path);
+      ImportRouterInfos(path);
 #endif
+      if (sub_dirs.empty())
+        return;
+      // Only remove the old layout once its RI's are safely stored
+      if (!m_Store.Flush())
+        return;
+      for (const auto& sub_dir : sub_dirs)
+        {
+          if (sub_dir.is_complete)
+            {
+              boost::filesystem::remove_all(sub_dir.path);
+              continue;
+            }
+          // Keep what failed to import, but don't import the rest again
+          for (const auto& file : sub_dir.imported)
+            boost::filesystem::remove(file);
+          LOG(warning)
+            << "NetDb: kept RouterInfos that failed to import in "
+            << sub_dir.path.string();
+        }
+      LOG(info)
+        << "NetDb: imported " << m_Store.GetSize() << " RouterInfos into "
+        << m_Store.GetPath().string();
+    }
+  catch (...)
+    {
+      m_Exception.Dispatch(__func__);
+    }
+}
+
+bool NetDb::Load()
+{
+  // Create NetDb if it does not exist
+  const auto& path = core::GetNetDbPath();
+  if (!CreateNetDb(path))
+    return false;
+  // Cleanup the database from previous attempts
+  m_RouterInfos.clear();
+  m_RouterIndex.Clear();
+  m_Floodfills.Clear();
+  if (!m_Store.Open(path / NETDB_STORE_FILE))
+    return false;
+  Import(path);
+  // Parse RI's in place from the mapped store, buffers are loaded on demand
+  std::size_t num_routers = 0;
+  std::vector<IdentHash> expired;
+  std::uint64_t timestamp = kovri::core::GetMillisecondsSinceEpoch();
+  m_Store.ForEach([&](const std::uint8_t* buf, std::size_t len) {
+    auto router = std::make_shared<RouterInfo>(buf, len, false);
+    if (!router->IsUnreachable()
+        && (!router->UsesIntroducer()
+            || timestamp < router->GetTimestamp()
+                        + GetType(NetDbTime::RouterExpiration)))
+      {
+        router->ClearProperties();  // properties are not used for regular routers
+        m_RouterInfos.insert(std::make_pair(router->GetIdentHash(), router));
+        m_RouterIndex.Add(router);
+        if (router->IsFloodfill())
+          m_Floodfills.Add(router);
+        num_routers++;
+      }
+    else
+      {
+        // Remove unreachable routers
+        expired.push_back(router->GetIdentHash());
+      }
+  });
+  for (const auto& ident : expired)
+    m_Store.Erase(ident);
+  m_Store.Flush();
   LOG(debug) << "NetDb: " << num_routers << " routers loaded";
-  LOG(debug) << "NetDb: " << m_Floodfills.size() << " floodfills loaded";
+  LOG(debug) << "NetDb: " << expired.size() << " unreachable routers removed";
+  LOG(debug) << "NetDb: " << m_Floodfills.GetSize() << " floodfills loaded";
   return true;
 }
 
 void NetDb::SaveUpdated() {
-  auto GetFilePath = [](
-      const boost::filesystem::path& directory,
-      const RouterInfo* router_info) {
-    const std::string base64(router_info->GetIdentHashBase64());
-    // TODO(unassigned): this is a patch for #520 until we implement a database in #385
-    std::string sub_dir;
-#if defined(_WIN32) || defined(__APPLE__)
-    sub_dir = std::isupper(base64[0]) ? "uppercase" : "lowercase";
-#endif
-    return directory / sub_dir / (std::string("r") + base64[0]) / ("router_info_" + base64 + ".dat");
-  };
-  boost::filesystem::path full_directory(kovri::core::GetNetDbPath());
   int count = 0, deleted_count = 0;
   auto total = GetNumRouters();
   std::uint64_t ts = kovri::core::GetMillisecondsSinceEpoch();
   for (auto it : m_RouterInfos) {
     if (it.second->IsUpdated()) {
-      std::string f = GetFilePath(full_directory, it.second.get()).string();
-      LOG(debug) << "NetDb: " << __func__ << " saving " << f;
-      it.second->SaveToFile(f);
+      LOG(debug)
+        << "NetDb: " << __func__ << " saving "
+        << it.second->GetIdentHashAbbreviation();
+      m_Store.Put(
+          it.first,
+          it.second->GetBuffer(),
+          it.second->GetBufferLen());
       it.second->SetUpdated(false);
       it.second->SetUnreachable(false);
       it.second->DeleteBuffer();
@@ -450,20 +507,18 @@ void NetDb::SaveUpdated() {
       }
       if (it.second->IsUnreachable()) {
         total--;
-        // delete RI file
-        bool is_removed =
-	  boost::filesystem::remove(
-	      GetFilePath(full_directory, it.second.get()));
-	 if (is_removed)
-	   deleted_count++;
+        m_Store.Erase(it.first);
+        deleted_count++;
         // delete from floodfills list
         if (it.second->IsFloodfill()) {
           std::unique_lock<std::mutex> l(m_FloodfillsMutex);
-          m_Floodfills.remove(it.second);
+          m_Floodfills.Remove(it.second);
         }
       }
     }
   }
+  // Updates are written in one batch
+  m_Store.Flush();
   if (count > 0)
     LOG(debug) << "NetDb: " << count << " new/updated routers saved";
   if (deleted_count > 0) {
@@ -473,6 +528,7 @@ void NetDb::SaveUpdated() {
     for (auto it = m_RouterInfos.begin(); it != m_RouterInfos.end();) {
       if (it->second->IsUnreachable()) {
         it->second->SaveProfile();
+        m_RouterIndex.Remove(it->second);
         it = m_RouterInfos.erase(it);
       } else {
         it++;
@@ -615,13 +671,15 @@ void NetDb::HandleDatabaseSearchReplyMsg(
                 dest->GetExcludedPeers());
             if (next_floodfill) {
               // tell floodfill about us
-              msgs.push_back(
-                  kovri::core::TunnelMessageBlock {
-                  kovri::core::e_DeliveryTypeRouter,
-                  next_floodfill->GetIdentHash(),
-                  0,
-                  CreateDatabaseStoreMsg()
-                  });
+              auto database_store = CreateDatabaseStoreMsg();
+              if (database_store)
+                msgs.push_back(
+                    kovri::core::TunnelMessageBlock {
+                    kovri::core::e_DeliveryTypeRouter,
+                    next_floodfill->GetIdentHash(),
+                    0,
+                    database_store
+                    });
               // request destination
               LOG(debug)
                 << "NetDb: trying " << key.data()
@@ -731,7 +789,11 @@ void NetDb::HandleDatabaseLookupMsg(
       auto router = FindRouter(ident);
       if (router) {
         LOG(debug) << "NetDb: requested RouterInfo " << key.data() << " found";
-        router->LoadBuffer();
+        if (!router->GetBuffer()) {
+          auto stored = m_Store.Get(router->GetIdentHash());
+          if (!stored.empty())
+            router->SetBuffer(stored.data(), stored.size());
+        }
         if (router->GetBuffer())
           reply_msg = CreateDatabaseStoreMsg(router);
       }
@@ -821,13 +883,16 @@ void NetDb::Explore(
       if (kovri::core::transports.IsConnected(floodfill->GetIdentHash()))
         through_tunnels = false;
       if (through_tunnels) {
-        msgs.push_back(
-            kovri::core::TunnelMessageBlock {
-            kovri::core::e_DeliveryTypeRouter,
-            floodfill->GetIdentHash(),
-            0,
-            CreateDatabaseStoreMsg()  // tell floodfill about us
-          });
+        // tell floodfill about us
+        auto database_store = CreateDatabaseStoreMsg();
+        if (database_store)
+          msgs.push_back(
+              kovri::core::TunnelMessageBlock {
+              kovri::core::e_DeliveryTypeRouter,
+              floodfill->GetIdentHash(),
+              0,
+              database_store
+            });
         msgs.push_back(
             kovri::core::TunnelMessageBlock  {
             kovri::core::e_DeliveryTypeRouter,
@@ -863,11 +928,14 @@ void NetDb::Publish() {
         << "NetDb: publishing our RouterInfo to "
         << floodfill->GetIdentHashAbbreviation()
         << ". reply token=" << reply_token;
+      auto database_store = CreateDatabaseStoreMsg(
+          kovri::context.GetSharedRouterInfo(),
+          reply_token);
+      if (!database_store)
+        return;  // our RouterInfo won't fit, no floodfill will take it
       kovri::core::transports.SendMessage(
           floodfill->GetIdentHash(),
-          CreateDatabaseStoreMsg(
-              kovri::context.GetSharedRouterInfo(),
-              reply_token));
+          database_store);
       excluded.insert(floodfill->GetIdentHash());
     }
   }
@@ -875,72 +943,59 @@ void NetDb::Publish() {
 
 std::shared_ptr<const RouterInfo> NetDb::GetRandomRouter() const {
   return GetRandomRouter(
-      [](std::shared_ptr<const RouterInfo> router)->bool {
-      return !router->IsHidden();
+      RouterIndexSet::Reachable,
+      [](std::shared_ptr<const RouterInfo>)->bool {
+      return true;
     });
 }
 
 std::shared_ptr<const RouterInfo> NetDb::GetRandomRouter(
     std::shared_ptr<const RouterInfo> compatible_with) const {
   return GetRandomRouter(
+      RouterIndex::GetCompatibleSet(*compatible_with),
       [compatible_with](std::shared_ptr<const RouterInfo> router)->bool {
-      return !router->IsHidden() && router != compatible_with &&
+      return router != compatible_with &&
         router->IsCompatible(*compatible_with);
     });
 }
 
 std::shared_ptr<const RouterInfo> NetDb::GetRandomPeerTestRouter() const {
   return GetRandomRouter(
-    [](std::shared_ptr<const RouterInfo> router)->bool {
-      return !router->IsHidden() && router->IsPeerTesting();
+    RouterIndexSet::PeerTesting,
+    [](std::shared_ptr<const RouterInfo>)->bool {
+      return true;
     });
 }
 
 std::shared_ptr<const RouterInfo> NetDb::GetRandomIntroducer() const {
   return GetRandomRouter(
-      [](std::shared_ptr<const RouterInfo> router)->bool {
-      return !router->IsHidden() && router->IsIntroducer();
+      RouterIndexSet::Introducer,
+      [](std::shared_ptr<const RouterInfo>)->bool {
+      return true;
     });
 }
 
 std::shared_ptr<const RouterInfo> NetDb::GetHighBandwidthRandomRouter(
     std::shared_ptr<const RouterInfo> compatible_with) const {
   return GetRandomRouter(
+    RouterIndexSet::HighBandwidth,
     [compatible_with](std::shared_ptr<const RouterInfo> router)->bool {
-      return !router->IsHidden() &&
-      router != compatible_with &&
-      router->IsCompatible(*compatible_with) &&
-      (router->GetCaps() & RouterInfo::eHighBandwidth);
+      return router != compatible_with &&
+      router->IsCompatible(*compatible_with);
     });
 }
 
 template<typename Filter>
 std::shared_ptr<const RouterInfo> NetDb::GetRandomRouter(
+    RouterIndexSet set,
     Filter filter) const {
-
-  // Lock RI's
+  // Hidden routers are never indexed, unreachable ones are rejected here
   std::unique_lock<std::mutex> l(m_RouterInfosMutex);
-
-  // Instead of using expensive map copying (in an attempt to shuffle),
-  // we'll create a vector of pointers to map's key, randomize, then iterate
-  // to ensure that a random RI will be selected for test-case
-  std::vector<std::unique_ptr<IdentHash>> idents;
-
-  // Save pointers to keys
-  for (auto const& ri : m_RouterInfos)
-    idents.push_back(std::make_unique<IdentHash>(ri.first));
-
-  // Randomize they keys for selection
-  kovri::core::Shuffle(idents.begin(), idents.end());
-
-  // Use keys for test-case
-  for (auto const& i : idents) {
-    if (!m_RouterInfos.at(*i)->IsUnreachable() && filter(m_RouterInfos.at(*i)))
-      return m_RouterInfos.at(*i);
-  }
-
-  // We don't have enough routers which fit criteria
-  return nullptr;
+  return m_RouterIndex.GetRandom(
+      set,
+      [&filter](const std::shared_ptr<RouterInfo>& router)->bool {
+      return !router->IsUnreachable() && filter(router);
+    });
 }
 
 void NetDb::PostI2NPMsg(
@@ -952,62 +1007,33 @@ void NetDb::PostI2NPMsg(
 std::shared_ptr<const RouterInfo> NetDb::GetClosestFloodfill(
     const IdentHash& destination,
     const std::set<IdentHash>& excluded) const {
-  std::shared_ptr<const RouterInfo> r;
-  XORMetric min_metric;
   IdentHash dest_key = CreateRoutingKey(destination);
-  min_metric.SetMax();
   std::unique_lock<std::mutex> l(m_FloodfillsMutex);
-  for (auto it : m_Floodfills) {
-    if (!it->IsUnreachable()) {
-      XORMetric m = dest_key ^ it->GetIdentHash();
-      if (m < min_metric && !excluded.count(it->GetIdentHash())) {
-        min_metric = m;
-        r = it;
-      }
-    }
-  }
-  return r;
+  auto closest = m_Floodfills.GetClosest(
+      dest_key,
+      1,
+      [&excluded](const std::shared_ptr<RouterInfo>& floodfill)->bool {
+      return !floodfill->IsUnreachable() &&
+        !excluded.count(floodfill->GetIdentHash());
+    });
+  return closest.empty() ? nullptr : closest.front();
 }
 
 std::vector<IdentHash> NetDb::GetClosestFloodfills(
     const IdentHash& destination,
     std::size_t num,
     std::set<IdentHash>& excluded) const {
-  struct Sorted {
-    std::shared_ptr<const RouterInfo> r;
-    XORMetric metric;
-    bool operator<(const Sorted& other) const {
-      return metric < other.metric;
-    }
-  };
-  std::set<Sorted> sorted;
-  IdentHash dest_key = CreateRoutingKey(destination); {
-    std::unique_lock<std::mutex> l(m_FloodfillsMutex);
-    for (auto it : m_Floodfills) {
-      if (!it->IsUnreachable()) {
-        XORMetric m = dest_key ^ it->GetIdentHash();
-        if (sorted.size() < num) {
-          sorted.insert({it, m});
-        } else if (m < sorted.rbegin()->metric) {
-          sorted.insert({it, m});
-          sorted.erase(std::prev(sorted.end()));
-        }
-      }
-    }
-  }
+  IdentHash dest_key = CreateRoutingKey(destination);
   std::vector<IdentHash> res;
-  std::size_t i = 0;
-  for (auto it : sorted) {
-    if (i < num) {
-      auto& ident = it.r->GetIdentHash();
-      if (!excluded.count(ident)) {
-        res.push_back(ident);
-        i++;
-      }
-    } else {
-      break;
-    }
-  }
+  std::unique_lock<std::mutex> l(m_FloodfillsMutex);
+  for (const auto& floodfill : m_Floodfills.GetClosest(
+           dest_key,
+           num,
+           [&excluded](const std::shared_ptr<RouterInfo>& floodfill)->bool {
+           return !floodfill->IsUnreachable() &&
+             !excluded.count(floodfill->GetIdentHash());
+         }))
+    res.push_back(floodfill->GetIdentHash());
   return res;
 }
 
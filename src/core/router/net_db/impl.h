@@ -35,7 +35,6 @@
 
 #include <cstddef>
 #include <cstdint>
-#include <list>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -47,7 +46,9 @@
 #include "core/router/i2np.h"
 #include "core/router/info.h"
 #include "core/router/lease_set.h"
+#include "core/router/net_db/index.h"
 #include "core/router/net_db/requests.h"
+#include "core/router/net_db/store.h"
 #include "core/router/tunnel/pool.h"
 #include "core/router/tunnel/impl.h"
 
@@ -237,7 +238,7 @@ class NetDb {
 
   // TODO(unassigned): std::size_t refactor
   int GetNumFloodfills() const {
-    return m_Floodfills.size();
+    return m_Floodfills.GetSize();
   }
 
   // TODO(unassigned): std::size_t refactor
@@ -250,6 +251,8 @@ class NetDb {
 
  private:
   bool CreateNetDb(boost::filesystem::path directory);
+  /// @brief Moves RI's stored one file per RI into the store
+  void Import(const boost::filesystem::path& path);
   /// @brief Loads RI's from disk
   /// @return False on failure
   bool Load();
@@ -262,23 +265,27 @@ class NetDb {
 
   /// @brief Randomly selects a router from stored RI's according to filter
   ///   (and other criteria determined internally)
+  /// @param set Capability set to sample from
   /// @param filter Template type which serves as filter for criteria
   template<typename Filter>
   std::shared_ptr<const RouterInfo> GetRandomRouter(
+      RouterIndexSet set,
       Filter filter) const;
 
  private:
   std::map<IdentHash, std::shared_ptr<LeaseSet>> m_LeaseSets;
   mutable std::mutex m_RouterInfosMutex;
   std::map<IdentHash, std::shared_ptr<RouterInfo>> m_RouterInfos;
+  RouterIndex m_RouterIndex;  // guarded by m_RouterInfosMutex
   mutable std::mutex m_FloodfillsMutex;
-  std::list<std::shared_ptr<RouterInfo>> m_Floodfills;
+  FloodfillIndex m_Floodfills;
+  NetDbStore m_Store;
 
   bool m_IsRunning;
   std::unique_ptr<std::thread> m_Thread;
 
   // of I2NPDatabaseStoreMsg
-  kovri::core::Queue<std::shared_ptr<const I2NPMessage>> m_Queue;
+  kovri::core::MPSCQueue<std::shared_ptr<const I2NPMessage>> m_Queue;
 
   friend class NetDbRequests;
   NetDbRequests m_Requests;
@@ -0,0 +1,158 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#include "core/router/net_db/index.h"
+
+namespace kovri {
+namespace core {
+
+void RouterIndex::Add(
+    std::shared_ptr<RouterInfo> router) {
+  const std::uint8_t sets = GetSets(*router);
+  auto it = m_Entries.find(router.get());
+  if (it != m_Entries.end()) {
+    if (it->second.sets == sets)
+      return;  // caps unchanged
+    Erase(router.get());
+  }
+  if (sets)
+    Insert(router, sets);
+}
+
+void RouterIndex::Remove(
+    const std::shared_ptr<RouterInfo>& router) {
+  if (m_Entries.count(router.get()))
+    Erase(router.get());
+}
+
+void RouterIndex::Clear() {
+  for (auto& routers : m_Sets)
+    routers.clear();
+  m_Entries.clear();
+}
+
+RouterIndexSet RouterIndex::GetCompatibleSet(
+    const RouterInfo& router) {
+  const bool ntcp = router.IsNTCP(false), ssu = router.IsSSU(false);
+  if (ntcp && !ssu)
+    return RouterIndexSet::NTCP;
+  if (ssu && !ntcp)
+    return RouterIndexSet::SSU;
+  return RouterIndexSet::Reachable;
+}
+
+std::uint8_t RouterIndex::GetSets(
+    const RouterInfo& router) {
+  if (router.IsHidden())
+    return 0;
+  std::uint8_t sets = 1 << GetType(RouterIndexSet::Reachable);
+  if (router.IsHighBandwidth())
+    sets |= 1 << GetType(RouterIndexSet::HighBandwidth);
+  if (router.IsIntroducer())
+    sets |= 1 << GetType(RouterIndexSet::Introducer);
+  if (router.IsPeerTesting())
+    sets |= 1 << GetType(RouterIndexSet::PeerTesting);
+  if (router.IsNTCP(false))
+    sets |= 1 << GetType(RouterIndexSet::NTCP);
+  if (router.IsSSU(false))
+    sets |= 1 << GetType(RouterIndexSet::SSU);
+  return sets;
+}
+
+void RouterIndex::Insert(
+    std::shared_ptr<RouterInfo> router,
+    std::uint8_t sets) {
+  Entry entry {};
+  entry.sets = sets;
+  for (std::uint8_t i = 0; i < GetType(RouterIndexSet::Count); i++) {
+    if (sets & (1 << i)) {
+      entry.positions[i] = m_Sets[i].size();
+      m_Sets[i].push_back(router);
+    }
+  }
+  m_Entries[router.get()] = entry;
+}
+
+void RouterIndex::Erase(
+    const RouterInfo* router) {
+  auto it = m_Entries.find(router);
+  const Entry entry = it->second;
+  m_Entries.erase(it);
+  for (std::uint8_t i = 0; i < GetType(RouterIndexSet::Count); i++) {
+    if (!(entry.sets & (1 << i)))
+      continue;
+    auto& routers = m_Sets[i];
+    const std::size_t position = entry.positions[i];
+    // Fill the hole with the last router of the set
+    if (position != routers.size() - 1) {
+      routers[position] = std::move(routers.back());
+      m_Entries.at(routers[position].get()).positions[i] = position;
+    }
+    routers.pop_back();
+  }
+}
+
+void FloodfillIndex::Add(
+    std::shared_ptr<RouterInfo> floodfill) {
+  auto it = LowerBound(floodfill->GetIdentHash());
+  for (; it != m_Floodfills.end()
+         && (*it)->GetIdentHash() == floodfill->GetIdentHash(); ++it)
+    if (*it == floodfill)
+      return;  // already indexed
+  m_Floodfills.insert(it, floodfill);
+}
+
+void FloodfillIndex::Remove(
+    const std::shared_ptr<RouterInfo>& floodfill) {
+  auto it = LowerBound(floodfill->GetIdentHash());
+  for (; it != m_Floodfills.end()
+         && (*it)->GetIdentHash() == floodfill->GetIdentHash(); ++it) {
+    if (*it == floodfill) {
+      m_Floodfills.erase(it);
+      return;
+    }
+  }
+}
+
+std::vector<std::shared_ptr<RouterInfo>>::const_iterator
+FloodfillIndex::LowerBound(
+    const IdentHash& ident) const {
+  return std::lower_bound(
+      m_Floodfills.begin(),
+      m_Floodfills.end(),
+      ident,
+      [](const std::shared_ptr<RouterInfo>& floodfill, const IdentHash& ident) {
+        return floodfill->GetIdentHash() < ident;
+      });
+}
+
+}  // namespace core
+}  // namespace kovri
@@ -0,0 +1,257 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#ifndef SRC_CORE_ROUTER_NET_DB_INDEX_H_
+#define SRC_CORE_ROUTER_NET_DB_INDEX_H_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "core/crypto/rand.h"
+#include "core/router/info.h"
+#include "core/util/byte_stream.h"
+
+namespace kovri {
+namespace core {
+
+/// @enum RouterIndexSet
+/// @brief Capability sets a router can be sampled from.
+///   Hidden routers are never indexed.
+enum struct RouterIndexSet : std::uint8_t {
+  Reachable,
+  HighBandwidth,
+  Introducer,
+  PeerTesting,
+  NTCP,
+  SSU,
+  Count,
+};
+
+/// @enum RouterIndexSize
+/// @brief Sampling limits
+enum struct RouterIndexSize : std::uint8_t {
+  /// @var MaxSampleAttempts
+  /// @brief Random draws before falling back to a scan of the set
+  MaxSampleAttempts = 32,
+};
+
+/// @class RouterIndex
+/// @brief Capability-indexed, contiguous arrays of routers which allow
+///   constant-time random selection
+/// @details Removal swaps the last router into the freed slot, so every
+///   operation is O(1). Criteria which are not indexed (reachability flags,
+///   transport compatibility) are handled by rejection sampling.
+/// @note Not thread-safe, callers must hold the owning container's lock
+class RouterIndex {
+ public:
+  /// @brief Indexes router, or re-indexes it if its caps have changed
+  void Add(
+      std::shared_ptr<RouterInfo> router);
+
+  /// @brief Removes router from all sets
+  void Remove(
+      const std::shared_ptr<RouterInfo>& router);
+
+  /// @brief Removes all routers
+  void Clear();
+
+  /// @return Smallest set holding every router compatible with given router
+  static RouterIndexSet GetCompatibleSet(
+      const RouterInfo& router);
+
+  /// @return Number of routers in given set
+  std::size_t GetSize(
+      RouterIndexSet set) const {
+    return m_Sets.at(GetType(set)).size();
+  }
+
+  /// @brief Randomly selects a router from given set which passes filter
+  /// @details Draws up to MaxSampleAttempts random routers, then scans
+  ///   the set from a random offset so that a rare match is still found
+  /// @param set Set to sample from
+  /// @param filter Template type which serves as filter for criteria
+  /// @return Router or nullptr if no router in set passes filter
+  template<typename Filter>
+  std::shared_ptr<RouterInfo> GetRandom(
+      RouterIndexSet set,
+      Filter filter) const {
+    const auto& routers = m_Sets.at(GetType(set));
+    if (routers.empty())
+      return nullptr;
+    const std::uint32_t last = routers.size() - 1;
+    for (std::uint8_t i = 0;
+         i < GetType(RouterIndexSize::MaxSampleAttempts);
+         i++) {
+      const auto& router = routers[RandInRange32(0, last)];
+      if (filter(router))
+        return router;
+    }
+    const std::size_t offset = RandInRange32(0, last);
+    for (std::size_t i = 0; i < routers.size(); i++) {
+      const auto& router = routers[(offset + i) % routers.size()];
+      if (filter(router))
+        return router;
+    }
+    return nullptr;
+  }
+
+ private:
+  /// @return Bitmask of sets router belongs to
+  static std::uint8_t GetSets(
+      const RouterInfo& router);
+
+  void Insert(
+      std::shared_ptr<RouterInfo> router,
+      std::uint8_t sets);
+
+  void Erase(
+      const RouterInfo* router);
+
+ private:
+  struct Entry {
+    std::uint8_t sets;
+    std::array<std::size_t, GetType(RouterIndexSet::Count)> positions;
+  };
+
+  std::array<
+      std::vector<std::shared_ptr<RouterInfo>>,
+      GetType(RouterIndexSet::Count)> m_Sets;
+  std::unordered_map<const RouterInfo*, Entry> m_Entries;
+};
+
+/// @class FloodfillIndex
+/// @brief Floodfills sorted by ident hash, answering k-closest queries
+///   in XOR metric without scanning every floodfill
+/// @details A sorted array is an implicit binary trie: all hashes sharing
+///   a prefix form a contiguous range, which splits in two where the next
+///   bit changes. Descending into the half whose bit matches the key first
+///   visits floodfills in increasing XOR distance, so a query costs about
+///   O(log^2 n + k) comparisons for uniformly distributed hashes.
+/// @note Not thread-safe, callers must hold the owning container's lock
+class FloodfillIndex {
+ public:
+  /// @brief Adds floodfill unless it is already indexed
+  void Add(
+      std::shared_ptr<RouterInfo> floodfill);
+
+  /// @brief Removes floodfill if it is indexed
+  void Remove(
+      const std::shared_ptr<RouterInfo>& floodfill);
+
+  void Clear() {
+    m_Floodfills.clear();
+  }
+
+  std::size_t GetSize() const {
+    return m_Floodfills.size();
+  }
+
+  /// @brief Finds floodfills closest to key which pass filter
+  /// @param key Routing key to measure XOR distance from
+  /// @param num Maximum number of floodfills to return
+  /// @param filter Template type which serves as filter for criteria
+  /// @return Floodfills ordered by increasing distance from key
+  template<typename Filter>
+  std::vector<std::shared_ptr<RouterInfo>> GetClosest(
+      const IdentHash& key,
+      std::size_t num,
+      Filter filter) const {
+    std::vector<std::shared_ptr<RouterInfo>> closest;
+    if (!num)
+      return closest;
+    // Ranges [begin, end) whose hashes share their first `bit` bits
+    std::vector<std::tuple<std::size_t, std::size_t, std::uint16_t>> ranges;
+    ranges.emplace_back(0, m_Floodfills.size(), 0);
+    while (!ranges.empty()) {
+      std::size_t begin, end;
+      std::uint16_t bit;
+      std::tie(begin, end, bit) = ranges.back();
+      ranges.pop_back();
+      if (end - begin == 1 || bit == MaxBits) {
+        // Leaf: a single floodfill, or duplicates of the same hash
+        for (std::size_t i = begin; i < end; i++) {
+          if (filter(m_Floodfills[i])) {
+            closest.push_back(m_Floodfills[i]);
+            if (closest.size() == num)
+              return closest;
+          }
+        }
+        continue;
+      }
+      // Hashes are sorted, so those with the bit set come last
+      const std::size_t split = std::partition_point(
+          m_Floodfills.begin() + begin,
+          m_Floodfills.begin() + end,
+          [bit](const std::shared_ptr<RouterInfo>& floodfill) {
+            return !GetBit(floodfill->GetIdentHash(), bit);
+          }) - m_Floodfills.begin();
+      // Push the far half first so that the near half is visited first
+      const bool is_set = GetBit(key, bit);
+      const std::size_t near_begin = is_set ? split : begin;
+      const std::size_t near_end = is_set ? end : split;
+      const std::size_t far_begin = is_set ? begin : split;
+      const std::size_t far_end = is_set ? split : end;
+      if (far_begin != far_end)
+        ranges.emplace_back(far_begin, far_end, bit + 1);
+      if (near_begin != near_end)
+        ranges.emplace_back(near_begin, near_end, bit + 1);
+    }
+    return closest;
+  }
+
+ private:
+  static const std::uint16_t MaxBits = 256;
+
+  /// @return Bit of hash at given position, most significant first
+  static bool GetBit(
+      const IdentHash& hash,
+      std::uint16_t bit) {
+    return (hash()[bit / 8] >> (7 - bit % 8)) & 1;
+  }
+
+  /// @return Position of first floodfill whose hash is not less than ident
+  std::vector<std::shared_ptr<RouterInfo>>::const_iterator LowerBound(
+      const IdentHash& ident) const;
+
+ private:
+  std::vector<std::shared_ptr<RouterInfo>> m_Floodfills;
+};
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_ROUTER_NET_DB_INDEX_H_
@@ -0,0 +1,449 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#include "core/router/net_db/store.h"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+#include <fstream>
+
+#include "core/crypto/util/checksum.h"
+
+#include "core/util/byte_stream.h"
+#include "core/util/i2p_endian.h"
+#include "core/util/log.h"
+
+namespace kovri {
+namespace core {
+
+namespace {
+const std::uint8_t STORE_MAGIC[4] { 'K', 'N', 'D', 'B' };
+const std::uint32_t STORE_VERSION = 1;
+
+/// @brief Writes given file through to disk
+bool SyncFile(
+    const boost::filesystem::path& path) {
+#ifdef _WIN32
+  const int fd = _open(path.string().c_str(), _O_RDWR | _O_BINARY);
+  if (fd < 0)
+    return false;
+  const bool synced = !_commit(fd);
+  _close(fd);
+#else
+  const int fd = open(path.string().c_str(), O_RDWR);
+  if (fd < 0)
+    return false;
+  const bool synced = !fsync(fd);
+  close(fd);
+#endif
+  return synced;
+}
+}  // namespace
+
+NetDbStore::NetDbStore()
+    : m_FileSize(0),
+      m_LiveBytes(0) {}
+
+NetDbStore::~NetDbStore() {
+  Close();
+}
+
+bool NetDbStore::Open(
+    const boost::filesystem::path& path) {
+  std::unique_lock<std::mutex> l(m_Mutex);
+  m_Path = path;
+  boost::system::error_code ec;
+  if (!boost::filesystem::exists(m_Path, ec)
+      || boost::filesystem::file_size(m_Path, ec)
+          < GetType(NetDbStoreSize::FileHeader)) {
+    if (!Create())
+      return false;
+  }
+  if (!Map())
+    return false;
+  if (!IsValid()) {
+    // Move unknown file out of the way rather than refusing to start,
+    // the netdb is refilled by reseed
+    const boost::filesystem::path bad_path(m_Path.string() + ".bad");
+    LOG(warning)
+      << "NetDbStore: " << m_Path.string() << " is not a netdb store, "
+      << "moving it to " << bad_path.string();
+    Unmap();
+    boost::filesystem::rename(m_Path, bad_path, ec);
+    if (ec) {
+      LOG(error)
+        << "NetDbStore: can't move " << m_Path.string() << ": "
+        << ec.message();
+      return false;
+    }
+    if (!Create() || !Map())
+      return false;
+  }
+  return Index();
+}
+
+void NetDbStore::Close() {
+  std::unique_lock<std::mutex> l(m_Mutex);
+  if (!m_Pending.empty())
+    FlushPending();
+  Unmap();
+  m_Index.clear();
+  m_LiveBytes = 0;
+}
+
+void NetDbStore::ForEach(
+    std::function<void(const std::uint8_t*, std::size_t)> handler) const {
+  std::unique_lock<std::mutex> l(m_Mutex);
+  if (!m_Region)
+    return;
+  auto data = static_cast<const std::uint8_t*>(m_Region->get_address());
+  for (const auto& record : m_Index)
+    handler(data + record.second.offset, record.second.len);
+}
+
+std::vector<std::uint8_t> NetDbStore::Get(
+    const IdentHash& ident) const {
+  std::unique_lock<std::mutex> l(m_Mutex);
+  auto it = m_Index.find(ident);
+  if (it == m_Index.end() || !m_Region)
+    return {};
+  auto data = static_cast<const std::uint8_t*>(m_Region->get_address());
+  return std::vector<std::uint8_t>(
+      data + it->second.offset,
+      data + it->second.offset + it->second.len);
+}
+
+void NetDbStore::Put(
+    const IdentHash& ident,
+    const std::uint8_t* buf,
+    std::size_t len) {
+  if (len > GetType(NetDbStoreSize::MaxPayload)) {
+    LOG(error) << "NetDbStore: RouterInfo too long, " << len << " bytes";
+    return;
+  }
+  std::unique_lock<std::mutex> l(m_Mutex);
+  AppendRecord(m_Pending, NetDbStoreRecord::RouterInfo, ident, buf, len);
+}
+
+void NetDbStore::Erase(
+    const IdentHash& ident) {
+  std::unique_lock<std::mutex> l(m_Mutex);
+  AppendRecord(m_Pending, NetDbStoreRecord::Erased, ident, nullptr, 0);
+}
+
+bool NetDbStore::Flush() {
+  std::unique_lock<std::mutex> l(m_Mutex);
+  if (!m_Pending.empty() && !FlushPending())
+    return false;
+  if (IsStale())
+    return Rewrite();
+  return true;
+}
+
+bool NetDbStore::Compact() {
+  std::unique_lock<std::mutex> l(m_Mutex);
+  if (!m_Pending.empty() && !FlushPending())
+    return false;
+  return Rewrite();
+}
+
+std::size_t NetDbStore::GetSize() const {
+  std::unique_lock<std::mutex> l(m_Mutex);
+  return m_Index.size();
+}
+
+std::size_t NetDbStore::GetFileSize() const {
+  std::unique_lock<std::mutex> l(m_Mutex);
+  return m_FileSize;
+}
+
+bool NetDbStore::Create() {
+  LOG(debug) << "NetDbStore: creating " << m_Path.string();
+  std::uint8_t header[GetType(NetDbStoreSize::FileHeader)];
+  memcpy(header, STORE_MAGIC, sizeof(STORE_MAGIC));
+  htobe32buf(header + sizeof(STORE_MAGIC), STORE_VERSION);
+  std::ofstream f(
+      m_Path.string(),
+      std::ofstream::binary | std::ofstream::trunc);
+  if (!f.write(reinterpret_cast<const char*>(header), sizeof(header))) {
+    LOG(error) << "NetDbStore: can't create " << m_Path.string();
+    return false;
+  }
+  return true;
+}
+
+bool NetDbStore::Map() {
+  try {
+    m_FileSize = boost::filesystem::file_size(m_Path);
+    m_File = std::make_unique<boost::interprocess::file_mapping>(
+        m_Path.string().c_str(),
+        boost::interprocess::read_only);
+    m_Region = std::make_unique<boost::interprocess::mapped_region>(
+        *m_File,
+        boost::interprocess::read_only,
+        0,
+        m_FileSize);
+  } catch (const std::exception& ex) {
+    LOG(error)
+      << "NetDbStore: can't map " << m_Path.string() << ": " << ex.what();
+    Unmap();
+    return false;
+  }
+  return true;
+}
+
+void NetDbStore::Unmap() {
+  // Region must go before the file it maps
+  m_Region.reset(nullptr);
+  m_File.reset(nullptr);
+}
+
+bool NetDbStore::IsValid() const {
+  auto data = static_cast<const std::uint8_t*>(m_Region->get_address());
+  return m_FileSize >= GetType(NetDbStoreSize::FileHeader)
+    && !memcmp(data, STORE_MAGIC, sizeof(STORE_MAGIC))
+    && bufbe32toh(data + sizeof(STORE_MAGIC)) == STORE_VERSION;
+}
+
+bool NetDbStore::Index() {
+  m_Index.clear();
+  m_LiveBytes = 0;
+  const std::size_t end =
+    IndexRecords(GetType(NetDbStoreSize::FileHeader), true);
+  if (end != m_FileSize) {
+    LOG(warning)
+      << "NetDbStore: dropping " << m_FileSize - end
+      << " bytes of torn records from " << m_Path.string();
+    Unmap();
+    boost::system::error_code ec;
+    boost::filesystem::resize_file(m_Path, end, ec);
+    if (ec || !Map()) {
+      LOG(error) << "NetDbStore: can't truncate " << m_Path.string();
+      return false;
+    }
+  }
+  LOG(debug)
+    << "NetDbStore: " << m_Index.size() << " RouterInfos in "
+    << m_FileSize << " bytes";
+  return true;
+}
+
+std::size_t NetDbStore::IndexRecords(
+    std::size_t begin,
+    bool verify) {
+  const std::size_t header = GetType(NetDbStoreSize::RecordHeader);
+  auto data = static_cast<const std::uint8_t*>(m_Region->get_address());
+  std::size_t pos = begin;
+  while (pos + header <= m_FileSize) {
+    const std::uint8_t* record = data + pos;
+    const std::size_t len = bufbe32toh(record);
+    if (verify && !IsRecord(pos)) {
+      // Skip a damaged record: by its length if that still leads somewhere
+      // sensible, else by searching for the next intact record
+      std::size_t next = pos + header + len;
+      if (len > GetType(NetDbStoreSize::MaxPayload)
+          || next > m_FileSize
+          || (next < m_FileSize && !IsRecord(next)))
+        next = FindRecord(pos + 1);
+      if (next == m_FileSize && pos + header + len > m_FileSize
+          && len <= GetType(NetDbStoreSize::MaxPayload))
+        break;  // torn tail, nothing intact after it
+      LOG(warning)
+        << "NetDbStore: skipping " << next - pos
+        << " damaged bytes at offset " << pos << " of " << m_Path.string();
+      pos = next;
+      continue;
+    }
+    const IdentHash ident(record + 9);
+    auto it = m_Index.find(ident);
+    if (it != m_Index.end()) {
+      m_LiveBytes -= header + it->second.len;
+      m_Index.erase(it);
+    }
+    if (record[8] == GetType(NetDbStoreRecord::RouterInfo)) {
+      m_Index[ident] = {pos + header, len};
+      m_LiveBytes += header + len;
+    }
+    pos += header + len;
+  }
+  return pos;
+}
+
+bool NetDbStore::IsRecord(
+    std::size_t pos) const {
+  const std::size_t header = GetType(NetDbStoreSize::RecordHeader);
+  if (pos + header > m_FileSize)
+    return false;
+  auto record = static_cast<const std::uint8_t*>(m_Region->get_address()) + pos;
+  const std::size_t len = bufbe32toh(record);
+  if (len > GetType(NetDbStoreSize::MaxPayload)
+      || pos + header + len > m_FileSize)
+    return false;
+  const bool is_known =
+    (record[8] == GetType(NetDbStoreRecord::RouterInfo) && len)
+    || (record[8] == GetType(NetDbStoreRecord::Erased) && !len);
+  if (!is_known)
+    return false;
+  // Checksum covers type, ident and payload
+  std::uint8_t checksum[4];
+  Adler32().CalculateDigest(checksum, record + 8, header - 8 + len);
+  return !memcmp(checksum, record + 4, sizeof(checksum));
+}
+
+std::size_t NetDbStore::FindRecord(
+    std::size_t begin) const {
+  for (std::size_t pos = begin;
+       pos + GetType(NetDbStoreSize::RecordHeader) <= m_FileSize;
+       pos++)
+    if (IsRecord(pos))
+      return pos;
+  return m_FileSize;
+}
+
+void NetDbStore::AppendRecord(
+    std::vector<std::uint8_t>& buf,
+    NetDbStoreRecord type,
+    const IdentHash& ident,
+    const std::uint8_t* payload,
+    std::size_t len) {
+  const std::size_t pos = buf.size();
+  buf.resize(pos + GetType(NetDbStoreSize::RecordHeader) + len);
+  std::uint8_t* record = buf.data() + pos;
+  htobe32buf(record, len);
+  record[8] = GetType(type);
+  memcpy(record + 9, ident(), 32);
+  if (len)
+    memcpy(record + GetType(NetDbStoreSize::RecordHeader), payload, len);
+  Adler32().CalculateDigest(
+      record + 4,
+      record + 8,
+      GetType(NetDbStoreSize::RecordHeader) - 8 + len);
+}
+
+bool NetDbStore::FlushPending() {
+  if (!m_Region) {
+    LOG(error) << "NetDbStore: " << m_Path.string() << " is not open";
+    return false;
+  }
+  const std::size_t begin = m_FileSize;
+  // Unmapped first, as some platforms can't grow a mapped file
+  Unmap();
+  bool is_written;
+  {
+    std::ofstream f(
+        m_Path.string(),
+        std::ofstream::binary | std::ofstream::app);
+    is_written = f.write(
+        reinterpret_cast<const char*>(m_Pending.data()),
+        m_Pending.size()).flush().good();
+  }
+  if (!is_written) {
+    // Cut off whatever part was written, so that a retry appends
+    // right after the last intact record
+    LOG(error) << "NetDbStore: can't append to " << m_Path.string();
+    boost::system::error_code ec;
+    boost::filesystem::resize_file(m_Path, begin, ec);
+    if (ec)
+      LOG(error)
+        << "NetDbStore: can't truncate " << m_Path.string() << ": "
+        << ec.message();
+    Map();
+    return false;
+  }
+  LOG(debug)
+    << "NetDbStore: flushed " << m_Pending.size() << " bytes to "
+    << m_Path.string();
+  m_Pending.clear();
+  if (!Map())
+    return false;
+  // Records were just written by us, no need to verify them
+  IndexRecords(begin, false);
+  return true;
+}
+
+bool NetDbStore::Rewrite() {
+  if (!m_Region)
+    return false;
+  const boost::filesystem::path tmp_path(m_Path.string() + ".tmp");
+  auto data = static_cast<const std::uint8_t*>(m_Region->get_address());
+  std::vector<std::uint8_t> buf(
+      data, data + GetType(NetDbStoreSize::FileHeader));
+  buf.reserve(GetType(NetDbStoreSize::FileHeader) + m_LiveBytes);
+  for (const auto& record : m_Index)
+    AppendRecord(
+        buf,
+        NetDbStoreRecord::RouterInfo,
+        record.first,
+        data + record.second.offset,
+        record.second.len);
+  {
+    std::ofstream f(
+        tmp_path.string(),
+        std::ofstream::binary | std::ofstream::trunc);
+    if (!f.write(reinterpret_cast<const char*>(buf.data()), buf.size())
+             .flush()) {
+      LOG(error) << "NetDbStore: can't write " << tmp_path.string();
+      return false;
+    }
+  }
+  // Must be on disk before it replaces the store, else a crash could
+  // leave an empty or partial store behind
+  if (!SyncFile(tmp_path)) {
+    LOG(error) << "NetDbStore: can't sync " << tmp_path.string();
+    return false;
+  }
+  LOG(debug)
+    << "NetDbStore: compacted " << m_Path.string() << " from "
+    << m_FileSize << " to " << buf.size() << " bytes";
+  Unmap();
+  boost::system::error_code ec;
+  boost::filesystem::rename(tmp_path, m_Path, ec);
+  if (ec)
+    LOG(error) << "NetDbStore: can't replace " << m_Path.string();
+  return Map() && Index() && !ec;
+}
+
+bool NetDbStore::IsStale() const {
+  const std::size_t stale =
+    m_FileSize - GetType(NetDbStoreSize::FileHeader) - m_LiveBytes;
+  return stale >= GetType(NetDbStoreSize::MinCompaction)
+    && stale > m_LiveBytes;
+}
+
+}  // namespace core
+}  // namespace kovri
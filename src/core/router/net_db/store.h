@@ -0,0 +1,204 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#ifndef SRC_CORE_ROUTER_NET_DB_STORE_H_
+#define SRC_CORE_ROUTER_NET_DB_STORE_H_
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "core/router/identity.h"
+
+namespace kovri {
+namespace core {
+
+/// @brief Name of the store file within the netdb directory
+const char NETDB_STORE_FILE[] = "router_infos.dat";
+
+/// @enum NetDbStoreSize
+/// @brief Layout and limits of the store file
+enum struct NetDbStoreSize : std::uint32_t {
+  /// @var FileHeader
+  /// @brief Magic and version
+  FileHeader = 8,
+  /// @var RecordHeader
+  /// @brief Payload length, checksum, record type and ident hash
+  RecordHeader = 4 + 4 + 1 + 32,
+  /// @var MaxPayload
+  /// @brief Largest RouterInfo accepted, see MAX_RI_BUFFER_SIZE
+  MaxPayload = 2048,
+  /// @var MinCompaction
+  /// @brief Stale bytes needed before the file is compacted
+  MinCompaction = 1 << 20,
+};
+
+/// @enum NetDbStoreRecord
+/// @brief Record types
+enum struct NetDbStoreRecord : std::uint8_t {
+  RouterInfo = 1,
+  Erased = 2,
+};
+
+/// @class NetDbStore
+/// @brief Single-file, append-only store of RouterInfos
+/// @details Records are only ever appended: an update appends a new copy and
+///   a removal appends an erase record, the latest record of an ident wins.
+///   The file is memory-mapped once when opened and read in place. Updates
+///   are batched in memory and written with a single append by Flush(),
+///   which also compacts the file once stale records outweigh live ones.
+///   A torn record at the end of the file (e.g., after a crash) is dropped,
+///   a damaged record elsewhere is skipped. A file that isn't a store is
+///   moved aside and replaced by an empty one.
+class NetDbStore {
+ public:
+  NetDbStore();
+
+  ~NetDbStore();
+
+  /// @brief Maps store file (creating it if needed) and indexes its records
+  /// @param path Store file
+  /// @return False on failure
+  bool Open(
+      const boost::filesystem::path& path);
+
+  /// @brief Flushes pending records and unmaps store file
+  void Close();
+
+  /// @brief Calls handler with the payload of each stored RouterInfo,
+  ///   in place from the mapped file
+  void ForEach(
+      std::function<void(const std::uint8_t*, std::size_t)> handler) const;
+
+  /// @brief Copies stored RouterInfo of ident
+  /// @return Payload, or empty if ident is not stored
+  std::vector<std::uint8_t> Get(
+      const IdentHash& ident) const;
+
+  /// @brief Queues RouterInfo of ident for storage
+  void Put(
+      const IdentHash& ident,
+      const std::uint8_t* buf,
+      std::size_t len);
+
+  /// @brief Queues removal of ident
+  void Erase(
+      const IdentHash& ident);
+
+  /// @brief Appends queued records in one write, then compacts if needed
+  /// @return False on failure
+  bool Flush();
+
+  /// @brief Rewrites store file with live records only
+  /// @return False on failure
+  bool Compact();
+
+  /// @return Number of stored RouterInfos
+  std::size_t GetSize() const;
+
+  /// @return Size of store file
+  std::size_t GetFileSize() const;
+
+  const boost::filesystem::path& GetPath() const {
+    return m_Path;
+  }
+
+ private:
+  struct Record {
+    std::size_t offset;  // of payload within file
+    std::size_t len;
+  };
+
+  /// @brief Creates empty store file
+  bool Create();
+
+  /// @brief Maps current file
+  bool Map();
+
+  void Unmap();
+
+  /// @return True if mapped file has a known header
+  bool IsValid() const;
+
+  /// @brief Rebuilds index from mapped file, dropping a torn tail
+  bool Index();
+
+  /// @brief Applies records at given position of mapped file to index
+  /// @return Position after the last valid record
+  std::size_t IndexRecords(
+      std::size_t begin,
+      bool verify);
+
+  /// @return True if an intact record starts at given position
+  bool IsRecord(
+      std::size_t pos) const;
+
+  /// @return Position of the next intact record, or file size if none
+  std::size_t FindRecord(
+      std::size_t begin) const;
+
+  /// @brief Serializes a record into given buffer
+  static void AppendRecord(
+      std::vector<std::uint8_t>& buf,
+      NetDbStoreRecord type,
+      const IdentHash& ident,
+      const std::uint8_t* payload,
+      std::size_t len);
+
+  bool FlushPending();
+
+  bool Rewrite();
+
+  /// @return True if stale records are worth a compaction
+  bool IsStale() const;
+
+ private:
+  mutable std::mutex m_Mutex;
+  boost::filesystem::path m_Path;
+  std::unique_ptr<boost::interprocess::file_mapping> m_File;
+  std::unique_ptr<boost::interprocess::mapped_region> m_Region;
+  std::size_t m_FileSize, m_LiveBytes;
+  std::map<IdentHash, Record> m_Index;
+  std::vector<std::uint8_t> m_Pending;  // serialized records
+};
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_ROUTER_NET_DB_STORE_H_
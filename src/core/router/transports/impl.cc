@@ -155,6 +155,7 @@ Transports transports;
 Transports::Transports()
     : m_IsRunning(false),
       m_Thread(nullptr),
+      m_NextSessionService(0),
       m_Work(m_Service),
       m_PeerCleanupTimer(m_Service),
       m_NTCPServer(nullptr),
@@ -163,6 +164,9 @@ Transports::Transports()
       m_DHKeysPairSupplier(5),  // 5 pre-generated keys
       m_TotalSentBytes(0),
       m_TotalReceivedBytes(0),
+      m_TotalQueuedBytes(0),
+      m_TotalDroppedMessages(0),
+      m_TotalSavedACKPackets(0),
       m_InBandwidth(0),
       m_OutBandwidth(0),
       m_LastInBandwidthUpdateBytes(0),
@@ -181,7 +185,29 @@ void Transports::Start() {
 #endif
   m_DHKeysPairSupplier.Start();
   m_IsRunning = true;
+  m_Service.reset();  // In case of a restart
   m_Thread = std::make_unique<std::thread>(std::bind(&Transports::Run, this));
+  // With more than one thread, sessions run on their own services,
+  //  leaving the transports thread to accept and to dispatch to peers
+  const std::size_t num_threads = kovri::context.GetOptionTransportThreads();
+  if (num_threads > 1 && m_SessionServices.empty()) {
+    LOG(debug) << "Transports: starting " << num_threads << " session threads";
+    for (std::size_t i = 0; i < num_threads; i++) {
+      m_SessionServices.push_back(std::make_unique<boost::asio::io_service>());
+      m_SessionWorks.push_back(
+          std::make_unique<boost::asio::io_service::work>(
+              *m_SessionServices.back()));
+    }
+  }
+  for (auto& service : m_SessionServices) {
+    service->reset();
+    m_SessionThreads.push_back(
+        std::make_unique<std::thread>(
+            std::bind(
+                &Transports::RunSessionService,
+                this,
+                std::ref(*service))));
+  }
   // create acceptors
   const auto addresses = context.GetRouterInfo().GetAddresses();
   for (const auto& address : addresses) {
@@ -224,6 +250,20 @@ void Transports::Stop() {
 #endif
   m_PeerCleanupTimer.cancel();
   m_Peers.clear();
+  // Handlers on any of our services may refer to the servers,
+  //  so stop every thread running them before the servers go away
+  m_IsRunning = false;
+  m_Service.stop();
+  if (m_Thread) {
+    m_Thread->join();
+    m_Thread.reset(nullptr);
+  }
+  // Session services are kept until destruction, as sockets refer to them
+  for (auto& service : m_SessionServices)
+    service->stop();
+  for (auto& thread : m_SessionThreads)
+    thread->join();
+  m_SessionThreads.clear();
   if (m_SSUServer) {
     m_SSUServer->Stop();
     m_SSUServer.reset(nullptr);
@@ -233,12 +273,6 @@ void Transports::Stop() {
     m_NTCPServer.reset(nullptr);
   }
   m_DHKeysPairSupplier.Stop();
-  m_IsRunning = false;
-  m_Service.stop();
-  if (m_Thread) {
-    m_Thread->join();
-    m_Thread.reset(nullptr);
-  }
 }
 
 void Transports::Run() {
@@ -252,6 +286,23 @@ void Transports::Run() {
   }
 }
 
+void Transports::RunSessionService(
+    boost::asio::io_service& service) {
+  while (m_IsRunning) {
+    try {
+      service.run();
+    } catch (std::exception& ex) {
+      LOG(error) << "Transports: " << __func__ << ": '" << ex.what() << "'";
+    }
+  }
+}
+
+boost::asio::io_service& Transports::GetSessionService() {
+  if (m_SessionServices.empty())
+    return m_Service;
+  return *m_SessionServices[m_NextSessionService++ % m_SessionServices.size()];
+}
+
 void Transports::UpdateBandwidth() {
   LOG(debug) << "Transports: updating bandwidth";
   const std::uint64_t ts = kovri::core::GetMillisecondsSinceEpoch();
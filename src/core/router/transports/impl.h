@@ -137,6 +137,12 @@ class Transports {
     return m_Service;
   }
 
+  /// @return Service to pin a new session to, picked round-robin from
+  ///   the session threads, or the transports service if there are none
+  /// @note All handlers of a session run on its service, so a session
+  ///   never runs on two threads at once
+  boost::asio::io_service& GetSessionService();
+
   /// @return a pointer to a Diffie-Hellman pair
   std::unique_ptr<kovri::core::DHKeysPair> GetNextDHKeysPair();
 
@@ -199,6 +205,38 @@ class Transports {
     return m_TotalReceivedBytes;
   }
 
+  /// @brief Accounts for bytes entering (positive) or leaving (negative)
+  ///   session send queues
+  void UpdateQueuedBytes(
+      std::int64_t num_bytes) {
+    m_TotalQueuedBytes += num_bytes;
+  }
+
+  /// @return Number of bytes currently waiting in session send queues
+  std::uint64_t GetTotalQueuedBytes() const {
+    return m_TotalQueuedBytes;
+  }
+
+  void UpdateDroppedMessages(
+      std::uint64_t num_msgs) {
+    m_TotalDroppedMessages += num_msgs;
+  }
+
+  /// @return Number of messages dropped because a send queue was full
+  std::uint64_t GetTotalDroppedMessages() const {
+    return m_TotalDroppedMessages;
+  }
+
+  void UpdateSavedACKPackets(
+      std::uint64_t num_packets) {
+    m_TotalSavedACKPackets += num_packets;
+  }
+
+  /// @return Number of SSU ACK packets avoided by bundling and piggybacking
+  std::uint64_t GetTotalSavedACKPackets() const {
+    return m_TotalSavedACKPackets;
+  }
+
   // bytes per second
   std::uint32_t GetInBandwidth() const {
     return m_InBandwidth;
@@ -224,6 +262,9 @@ class Transports {
  private:
   void Run();
 
+  void RunSessionService(
+      boost::asio::io_service& service);
+
   void RequestComplete(
       std::shared_ptr<const kovri::core::RouterInfo> router,
       const kovri::core::IdentHash& ident);
@@ -268,6 +309,13 @@ class Transports {
   bool m_IsRunning;
 
   std::unique_ptr<std::thread> m_Thread;
+
+  // Declared before m_Service so they outlive handlers it may still hold
+  std::vector<std::unique_ptr<boost::asio::io_service>> m_SessionServices;
+  std::vector<std::unique_ptr<boost::asio::io_service::work>> m_SessionWorks;
+  std::vector<std::unique_ptr<std::thread>> m_SessionThreads;
+  std::atomic<std::size_t> m_NextSessionService;
+
   boost::asio::io_service m_Service;
   boost::asio::io_service::work m_Work;
   boost::asio::deadline_timer m_PeerCleanupTimer;
@@ -275,11 +323,15 @@ class Transports {
   std::unique_ptr<NTCPServer> m_NTCPServer;
   std::unique_ptr<SSUServer> m_SSUServer;
 
+  // Only modified on the transports thread: sessions on other threads
+  //  report to it through PeerConnected/PeerDisconnected, which post
   std::map<kovri::core::IdentHash, Peer> m_Peers;
 
   DHKeysPairSupplier m_DHKeysPairSupplier;
 
   std::atomic<uint64_t> m_TotalSentBytes, m_TotalReceivedBytes;
+  std::atomic<uint64_t> m_TotalQueuedBytes, m_TotalDroppedMessages;
+  std::atomic<uint64_t> m_TotalSavedACKPackets;
 
   std::uint32_t m_InBandwidth, m_OutBandwidth;
   std::uint64_t m_LastInBandwidthUpdateBytes, m_LastOutBandwidthUpdateBytes;
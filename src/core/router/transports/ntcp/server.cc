@@ -105,20 +105,14 @@ void NTCPServer::HandleAccept(
     auto ep = conn->GetSocket().remote_endpoint(ec);
     if (!ec) {
       LOG(debug) << "NTCPServer: connected from " << ep;
-      auto it = m_BanList.find(ep.address());
-      if (it != m_BanList.end()) {
-        std::uint32_t ts = kovri::core::GetSecondsSinceEpoch();
-        if (ts < it->second) {
-          LOG(debug)
-            << "NTCPServer: " << ep.address() << " is banned for "
-            << it->second - ts << " more seconds";
-          conn = nullptr;
-        } else {
-          m_BanList.erase(it);
-        }
-      }
+      if (IsBanned(ep.address()))
+        conn = nullptr;
+      // Login runs on the service the session is pinned to
       if (conn)
-        conn->ServerLogin();
+        conn->GetService().post(
+            std::bind(
+                &NTCPSession::ServerLogin,
+                conn));
     } else {
       LOG(error)
         << "NTCPServer: " << __func__ << " remote endpoint: " << ec.message();
@@ -147,20 +141,14 @@ void NTCPServer::HandleAcceptV6(
     auto ep = conn->GetSocket().remote_endpoint(ec);
     if (!ec) {
       LOG(debug) << "NTCPServer: V6 connected from " << ep;
-      auto it = m_BanList.find(ep.address());
-      if (it != m_BanList.end()) {
-        std::uint32_t ts = kovri::core::GetSecondsSinceEpoch();
-        if (ts < it->second) {
-          LOG(debug)
-            << "NTCPServer: " << ep.address() << " is banned for "
-            << it->second - ts << " more seconds";
-          conn = nullptr;
-        } else {
-          m_BanList.erase(it);
-        }
-      }
+      if (IsBanned(ep.address()))
+        conn = nullptr;
+      // Login runs on the service the session is pinned to
       if (conn)
-        conn->ServerLogin();
+        conn->GetService().post(
+            std::bind(
+                &NTCPSession::ServerLogin,
+                conn));
     } else {
       LOG(error)
           << "NTCPServer: " << __func__ << " remote endpoint: " << ec.message();
@@ -258,16 +246,39 @@ std::shared_ptr<NTCPSession> NTCPServer::FindNTCPSession(
 void NTCPServer::Ban(
     const std::shared_ptr<NTCPSession>& session) {
   std::uint32_t ts = kovri::core::GetSecondsSinceEpoch();
-  m_BanList[session->GetRemoteEndpoint().address()] =
-    ts + GetType(NTCPTimeoutLength::BanExpiration);
+  {
+    std::lock_guard<std::mutex> lock(m_BanListMutex);
+    m_BanList[session->GetRemoteEndpoint().address()] =
+      ts + GetType(NTCPTimeoutLength::BanExpiration);
+  }
   LOG(warning)
     << "NTCPServer:" << session->GetFormattedSessionInfo() << "has been banned for "
     << GetType(NTCPTimeoutLength::BanExpiration) << " seconds";
 }
 
+bool NTCPServer::IsBanned(
+    const boost::asio::ip::address& address) {
+  std::lock_guard<std::mutex> lock(m_BanListMutex);
+  auto it = m_BanList.find(address);
+  if (it == m_BanList.end())
+    return false;
+  std::uint32_t ts = kovri::core::GetSecondsSinceEpoch();
+  if (ts < it->second) {
+    LOG(debug)
+      << "NTCPServer: " << address << " is banned for "
+      << it->second - ts << " more seconds";
+    return true;
+  }
+  m_BanList.erase(it);
+  return false;
+}
+
 void NTCPServer::Stop() {
   LOG(debug) << "NTCPServer: stopping";
-  m_NTCPSessions.clear();
+  {
+    std::unique_lock<std::mutex> l(m_NTCPSessionsMutex);
+    m_NTCPSessions.clear();
+  }
   if (m_IsRunning) {
     m_IsRunning = false;
     m_NTCPAcceptor.reset(nullptr);
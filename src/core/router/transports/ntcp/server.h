@@ -81,10 +81,16 @@ class NTCPServer {
     return m_Service;
   }
 
+  /// @brief Bans the session's remote address for a while
+  /// @note Called from the threads running sessions
   void Ban(
       const std::shared_ptr<NTCPSession>& session);
 
  private:
+  /// @return True if address is banned, expired bans are removed
+  bool IsBanned(
+      const boost::asio::ip::address& address);
+
   void HandleAccept(
       std::shared_ptr<NTCPSession> conn,
       const boost::system::error_code& ecode);
@@ -109,6 +115,7 @@ class NTCPServer {
   std::map<kovri::core::IdentHash, std::shared_ptr<NTCPSession>> m_NTCPSessions;
 
   // IP -> ban expiration time in seconds
+  std::mutex m_BanListMutex;
   std::map<boost::asio::ip::address, std::uint32_t> m_BanList;
 
  public:
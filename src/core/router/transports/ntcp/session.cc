@@ -35,6 +35,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <vector>
@@ -64,14 +65,17 @@ NTCPSession::NTCPSession(
     std::shared_ptr<const kovri::core::RouterInfo> remote_router)
     : TransportSession(remote_router),
       m_Server(server),
-      m_Socket(m_Server.GetService()),
-      m_TerminationTimer(m_Server.GetService()),
+      m_Service(transports.GetSessionService()),
+      m_Socket(m_Service),
+      m_TerminationTimer(m_Service),
       m_IsEstablished(false),
       m_IsTerminated(false),
       m_ReceiveBufferOffset(0),
       m_NextMessage(nullptr),
       m_NextMessageOffset(0),
       m_IsSending(false),
+      m_SendQueueSize(0),
+      m_NumDroppedMessages(0),
       m_Exception(__func__) {
   m_DHKeysPair = transports.GetNextDHKeysPair();
   m_Establisher = std::make_unique<Establisher>();
@@ -841,41 +845,77 @@ void NTCPSession::Connected() {
   m_IsEstablished = true;
   m_Establisher.reset(nullptr);
   m_DHKeysPair.reset(nullptr);
-  SendTimeSyncMessage();
-  // We tell immediately who we are
-  m_SendQueue.push_back(CreateDatabaseStoreMsg());
+  // Time sync first, then we tell immediately who we are
+  LOG(debug)
+    << "NTCPSession:" << GetFormattedSessionInfo() << "<-- sending TimeSyncMessage";
+  QueueMessage(nullptr);
+  auto database_store = CreateDatabaseStoreMsg();
+  if (database_store)
+    QueueMessage(database_store);
+  SendPayload();
   transports.PeerConnected(shared_from_this());
 }
 
 // Send
 
-void NTCPSession::SendTimeSyncMessage() {
-  LOG(debug)
-    << "NTCPSession:" << GetFormattedSessionInfo() << "<-- sending TimeSyncMessage";
-  SendPayload(nullptr);
+bool NTCPSession::QueueMessage(
+    std::shared_ptr<I2NPMessage> msg) {
+  const std::size_t size = GetFrameSize(msg);
+  // Never drop into an empty queue, so that a single message larger than
+  //  the cap still gets through
+  if (!m_SendQueue.empty()
+      && m_SendQueueSize + size > kovri::context.GetOptionNTCPSendQueueSize()) {
+    m_NumDroppedMessages++;
+    transports.UpdateDroppedMessages(1);
+    return false;
+  }
+  m_SendQueue.push_back(msg);
+  m_SendQueueSize += size;
+  transports.UpdateQueuedBytes(size);
+  return true;
 }
 
-void NTCPSession::SendPayload(
-    std::shared_ptr<kovri::core::I2NPMessage> msg) {
+void NTCPSession::SendPayload() {
+  // Pack as many queued frames as fit into the send buffer (at least one)
+  std::size_t len = 0, num_msgs = 0;
+  for (const auto& msg : m_SendQueue) {
+    const std::size_t size = GetFrameSize(msg);
+    if (num_msgs && len + size > NTCPSize::SendBuffer)
+      break;
+    len += size;
+    num_msgs++;
+  }
+  if (!num_msgs)
+    return;
   LOG(debug)
-    << "NTCPSession:" << GetFormattedSessionInfo() << "<-- sending I2NP message";
+    << "NTCPSession:" << GetFormattedSessionInfo()
+    << "<-- sending " << num_msgs << " I2NP messages";
   m_IsSending = true;
+  if (m_SendBuffer.size() < len)
+    m_SendBuffer.resize(len);
+  std::uint8_t* buf = m_SendBuffer.data();
+  for (std::size_t i = 0; i < num_msgs; i++) {
+    buf += PackFrame(m_SendQueue.front(), buf);
+    m_SendQueue.pop_front();
+  }
+  m_SendQueueSize -= len;
+  transports.UpdateQueuedBytes(-static_cast<std::int64_t>(len));
+  // All frames are encrypted in one pass and written at once
+  m_Encryption.Encrypt(m_SendBuffer.data(), len, m_SendBuffer.data());
   boost::asio::async_write(
       m_Socket,
-      CreateMsgBuffer(msg),
+      boost::asio::buffer(m_SendBuffer.data(), len),
       boost::asio::transfer_all(),
       std::bind(
           &NTCPSession::HandleSentPayload,
           shared_from_this(),
           std::placeholders::_1,
-          std::placeholders::_2,
-          std::vector<std::shared_ptr<I2NPMessage> >{ msg }));
+          std::placeholders::_2));
 }
 
 void NTCPSession::HandleSentPayload(
     const boost::system::error_code& ecode,
-    std::size_t bytes_transferred,
-    std::vector<std::shared_ptr<I2NPMessage>> /*msgs*/) {
+    std::size_t bytes_transferred) {
   m_IsSending = false;
   if (ecode) {
     LOG(warning)
@@ -893,78 +933,52 @@ void NTCPSession::HandleSentPayload(
     << "<-- " << bytes_transferred << " bytes transferred << "
     << GetNumSentBytes() << " total bytes sent";
   kovri::core::transports.UpdateSentBytes(bytes_transferred);
-  if (!m_SendQueue.empty()) {
-    SendPayload(m_SendQueue);
-    m_SendQueue.clear();
-  } else {
+  if (!m_SendQueue.empty())
+    SendPayload();
+  else
     ScheduleTermination();  // Reset termination timer
-  }
 }
 
-void NTCPSession::SendPayload(
-    const std::vector<std::shared_ptr<I2NPMessage>>& msgs) {
-  LOG(debug)
-    << "NTCPSession:" << GetFormattedSessionInfo() << "<-- sending I2NP messages";
-  m_IsSending = true;
-  std::vector<boost::asio::const_buffer> bufs;
-  for (auto it : msgs)
-    bufs.push_back(CreateMsgBuffer(it));
-  boost::asio::async_write(
-      m_Socket,
-      bufs,
-      boost::asio::transfer_all(),
-      std::bind(
-          &NTCPSession::HandleSentPayload,
-          shared_from_this(),
-          std::placeholders::_1,
-          std::placeholders::_2,
-          msgs));
+std::size_t NTCPSession::GetFrameSize(
+    const std::shared_ptr<I2NPMessage>& msg) const {
+  const std::size_t len = NTCPSize::Phase3AliceRI
+    + (msg ? msg->GetLength() : std::size_t(NTCPSize::Phase3AliceTS))
+    + NTCPSize::Adler32;
+  return len + (NTCPSize::IV - len % NTCPSize::IV) % NTCPSize::IV;
 }
 
-boost::asio::const_buffers_1 NTCPSession::CreateMsgBuffer(
-    std::shared_ptr<I2NPMessage> msg) {
-  std::uint8_t* send_buffer;
-  // TODO(anonimal): no signed integers
-  int len{}, encrypted_len{};
+std::size_t NTCPSession::PackFrame(
+    const std::shared_ptr<I2NPMessage>& msg,
+    std::uint8_t* buf) {
   // TODO(anonimal): this try block should be handled entirely by caller
   try {
+    std::size_t len;
     if (msg) {
       // Regular I2NP
-      if (msg->offset < NTCPSize::Phase3AliceRI) {
-        LOG(error)
-          << "NTCPSession:" << GetFormattedSessionInfo()
-          << "!!! malformed I2NP message";  // TODO(unassigned): Error handling
-      }
-      send_buffer = msg->GetBuffer() - NTCPSize::Phase3AliceRI;
       len = msg->GetLength();
-      htobe16buf(send_buffer, len);
+      htobe16buf(buf, len);
+      std::memcpy(buf + NTCPSize::Phase3AliceRI, msg->GetBuffer(), len);
     } else {
-      // Prepare timestamp
-      send_buffer = m_TimeSyncBuffer;
+      // Timestamp
       len = NTCPSize::Phase3AliceTS;
-      htobuf16(send_buffer, 0);
-      htobe32buf(send_buffer + NTCPSize::Phase3AliceTS, time(0));
-    }
-    int rem = (len + 6) & 0x0F;  // %16
-    int padding = 0;
-    if (rem) {
-      padding = NTCPSize::IV - rem;
-      kovri::core::RandBytes(
-          send_buffer + len + NTCPSize::Phase3AliceTS,
-          padding);
+      htobuf16(buf, 0);
+      htobe32buf(buf + NTCPSize::Phase3AliceRI, time(0));
     }
+    const std::size_t frame_len = GetFrameSize(msg);
+    const std::size_t padding =
+      frame_len - NTCPSize::Phase3AliceRI - len - NTCPSize::Adler32;
+    if (padding)
+      kovri::core::RandBytes(buf + NTCPSize::Phase3AliceRI + len, padding);
     kovri::core::Adler32().CalculateDigest(
-        send_buffer + len + NTCPSize::Phase3AliceRI + padding,
-        send_buffer,
-        len + NTCPSize::Phase3AliceRI + padding);
-    encrypted_len = len + padding + 6;
-    m_Encryption.Encrypt(send_buffer, encrypted_len, send_buffer);
+        buf + frame_len - NTCPSize::Adler32,
+        buf,
+        frame_len - NTCPSize::Adler32);
+    return frame_len;
   } catch (...) {
     m_Exception.Dispatch(__func__);
     // TODO(anonimal): review if we need to safely break control, ensure exception handling by callers
     throw;
   }
-  return boost::asio::buffer(static_cast<const std::uint8_t *>(send_buffer), encrypted_len);
 }
 
 // Receive
@@ -1015,19 +1029,17 @@ void NTCPSession::HandleReceivedPayload(
     << GetNumReceivedBytes() << " total bytes received";
   kovri::core::transports.UpdateReceivedBytes(bytes_transferred);
   m_ReceiveBufferOffset += bytes_transferred;
-  // Decrypt as many 16 byte blocks as possible
-  std::uint8_t* next_block = m_ReceiveBuffer;
-  while(m_ReceiveBufferOffset >= block_size) {
-    // Try to decrypt one block
-    if (!DecryptNextBlock(next_block)) {
-      Terminate();
-      return;
-    }
-    next_block += block_size;
-    m_ReceiveBufferOffset -= block_size;
+  // Decrypt all complete 16 byte blocks in place with one bulk CBC call,
+  //  then parse frames directly out of the plaintext
+  const std::size_t len = m_ReceiveBufferOffset - m_ReceiveBufferOffset % block_size;
+  m_Decryption.Decrypt(m_ReceiveBuffer, len, m_ReceiveBuffer);
+  if (!HandleDecryptedPayload(m_ReceiveBuffer, len)) {
+    Terminate();
+    return;
   }
+  m_ReceiveBufferOffset -= len;
   if (m_ReceiveBufferOffset) // Do we have an incomplete block?
-    std::memcpy(m_ReceiveBuffer, next_block, m_ReceiveBufferOffset);
+    std::memcpy(m_ReceiveBuffer, m_ReceiveBuffer + len, m_ReceiveBufferOffset);
   // Flush and reset termination timer if a full message was read
   if (m_NextMessage == nullptr) {
     m_Handler.Flush();
@@ -1042,52 +1054,49 @@ void NTCPSession::HandleReceivedPayload(
     ReceivePayload();
 }
 
-bool NTCPSession::DecryptNextBlock(
-    const std::uint8_t* encrypted) {  // 16 bytes
+bool NTCPSession::HandleDecryptedPayload(
+    const std::uint8_t* buf,
+    std::size_t len) {  // multiple of 16 bytes
   // TODO(anonimal): this try block should be larger or handled entirely by caller
   try {
-    // New message, header expected
-    if (!m_NextMessage) {
-      // Decrypt header and extract length
-      std::array<std::uint8_t, NTCPSize::IV> buf;
-      m_Decryption.Decrypt(encrypted, buf.data());
-      std::uint16_t data_size = bufbe16toh(buf.data());
-      if (data_size) {
-        // New message
+    const std::uint8_t* const end = buf + len;
+    while (buf < end) {
+      // New message, header expected
+      if (!m_NextMessage) {
+        std::uint16_t data_size = bufbe16toh(buf);
+        if (!data_size) {
+          // Timestamp
+          LOG(debug)
+            << "NTCPSession:" << GetFormattedSessionInfo() << "*** timestamp";
+          buf += NTCPSize::IV;
+          continue;
+        }
         if (data_size > NTCPSize::MaxMessage) {
           LOG(error)
             << "NTCPSession:" << GetFormattedSessionInfo()
             << "!!! data block size '" << data_size << "' exceeds max size";
           return false;
         }
-        auto msg =
-          data_size <=
-            I2NP_MAX_SHORT_MESSAGE_SIZE -
-            NTCPSize::Phase3AliceRI
-              ? NewI2NPShortMessage()
-              : NewI2NPMessage();
-        m_NextMessage = ToSharedI2NPMessage(std::move(msg));
-        memcpy(m_NextMessage->buf, buf.data(), NTCPSize::IV);
-        m_NextMessageOffset = NTCPSize::IV;
+        m_NextMessage = ToSharedI2NPMessage(NewI2NPMessage(data_size));
+        m_NextMessageOffset = 0;
         m_NextMessage->offset = NTCPSize::Phase3AliceRI;  // size field
         m_NextMessage->len = data_size + NTCPSize::Phase3AliceRI;
-      } else {
-        // Timestamp
-        LOG(debug)
-          << "NTCPSession:" << GetFormattedSessionInfo() << "*** timestamp";
-        return true;
       }
-    } else {  // Message continues
-      m_Decryption.Decrypt(encrypted, m_NextMessage->buf + m_NextMessageOffset);
-      m_NextMessageOffset += NTCPSize::IV;
-    }
-    if (m_NextMessageOffset >=
-        m_NextMessage->len + NTCPSize::Adler32) {
+      // Frame is size field + data + padding + checksum, padded to 16 bytes
+      std::size_t frame_len = m_NextMessage->len + NTCPSize::Adler32;
+      frame_len += (NTCPSize::IV - frame_len % NTCPSize::IV) % NTCPSize::IV;
+      std::size_t size =
+          std::min<std::size_t>(frame_len - m_NextMessageOffset, end - buf);
+      std::memcpy(m_NextMessage->buf + m_NextMessageOffset, buf, size);
+      m_NextMessageOffset += size;
+      buf += size;
+      if (m_NextMessageOffset < frame_len)
+        break;  // Message continues in the next read
       // We have a complete I2NP message
       if (kovri::core::Adler32().VerifyDigest(
-            m_NextMessage->buf + m_NextMessageOffset - NTCPSize::Adler32,
+            m_NextMessage->buf + frame_len - NTCPSize::Adler32,
             m_NextMessage->buf,
-            m_NextMessageOffset - NTCPSize::Adler32))
+            frame_len - NTCPSize::Adler32))
         m_Handler.PutNextMessage(m_NextMessage);
       else
         LOG(warning)
@@ -1107,7 +1116,7 @@ bool NTCPSession::DecryptNextBlock(
 
 void NTCPSession::SendI2NPMessages(
     const std::vector<std::shared_ptr<I2NPMessage>>& msgs) {
-  m_Server.GetService().post(
+  m_Service.post(
       std::bind(
           &NTCPSession::PostI2NPMessages,
           shared_from_this(),
@@ -1118,12 +1127,16 @@ void NTCPSession::PostI2NPMessages(
     std::vector<std::shared_ptr<I2NPMessage>> msgs) {
   if (m_IsTerminated)
     return;
-  if (m_IsSending) {
-    for (auto it : msgs)
-      m_SendQueue.push_back(it);
-  } else {
-    SendPayload(msgs);
-  }
+  std::size_t num_dropped = 0;
+  for (const auto& msg : msgs)
+    if (!QueueMessage(msg))
+      num_dropped++;
+  if (num_dropped)
+    LOG(warning)
+      << "NTCPSession:" << GetFormattedSessionInfo()
+      << "!!! send queue is full, dropped " << num_dropped << " I2NP messages";
+  if (!m_IsSending)
+    SendPayload();
 }
 
 /**
@@ -1164,7 +1177,7 @@ void NTCPSession::HandleTerminationTimer(
 void NTCPSession::Done() {
   LOG(debug)
     << "NTCPSession:" << GetFormattedSessionInfo() << "*** done with session";
-  m_Server.GetService().post(
+  m_Service.post(
       std::bind(
           &NTCPSession::Terminate,
           shared_from_this()));
@@ -1181,6 +1194,8 @@ void NTCPSession::Terminate() {
     transports.PeerDisconnected(shared_from_this());
     m_Server.RemoveNTCPSession(shared_from_this());
     m_SendQueue.clear();
+    transports.UpdateQueuedBytes(-static_cast<std::int64_t>(m_SendQueueSize));
+    m_SendQueueSize = 0;
     m_NextMessage = nullptr;
     m_TerminationTimer.cancel();
     LOG(debug)
@@ -36,6 +36,7 @@
 #include <boost/asio.hpp>
 
 #include <cstdint>
+#include <deque>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -83,6 +84,11 @@ class NTCPSession
     return m_Socket;
   }
 
+  /// @return Service which runs all handlers of this session
+  boost::asio::io_service& GetService() {
+    return m_Service;
+  }
+
   bool IsEstablished() const {
     return m_IsEstablished;
   }
@@ -102,6 +108,16 @@ class NTCPSession
     return m_NumReceivedBytes;
   }
 
+  /// @return Number of bytes waiting in the send queue
+  std::size_t GetSendQueueSize() const {
+    return m_SendQueueSize;
+  }
+
+  /// @return Number of messages dropped because the send queue was full
+  std::size_t GetNumDroppedMessages() const {
+    return m_NumDroppedMessages;
+  }
+
   /// @brief Sets peer abbreviated ident hash
   void SetRemoteIdentHashAbbreviation() {
     m_RemoteIdentHashAbbreviation =
@@ -144,8 +160,6 @@ class NTCPSession
 
   void Connected();
 
-  void SendTimeSyncMessage();
-
   void SetIsEstablished(
       bool is_established) {
     m_IsEstablished = is_established;
@@ -218,26 +232,41 @@ class NTCPSession
       const boost::system::error_code& ecode,
       std::size_t bytes_transferred);
 
-  bool DecryptNextBlock(
-      const std::uint8_t* encrypted);
-
-  /// @brief Send payload (I2NP message)
-  /// @param msg shared pointer to payload (I2NPMessage)
-  void SendPayload(
-      std::shared_ptr<kovri::core::I2NPMessage> msg);
-
-  /// @brief Send payload (I2NP messages)
-  /// @param msg shared pointer to payload (I2NPMessages)
-  void SendPayload(
-      const std::vector<std::shared_ptr<I2NPMessage>>& msgs);
-
-  boost::asio::const_buffers_1 CreateMsgBuffer(
+  /// @brief Parses NTCP frames out of decrypted payload
+  /// @param buf Decrypted payload
+  /// @param len Length of payload, a multiple of 16 bytes
+  /// @return False if the payload is malformed and the session must be terminated
+  bool HandleDecryptedPayload(
+      const std::uint8_t* buf,
+      std::size_t len);
+
+  /// @brief Appends message to the send queue unless it would exceed the cap
+  /// @param msg I2NP message, or nullptr for a timestamp
+  /// @return False if the message was dropped
+  bool QueueMessage(
       std::shared_ptr<I2NPMessage> msg);
 
+  /// @brief Packs queued messages into the send buffer,
+  ///   encrypts it in one pass and writes it out
+  void SendPayload();
+
   void HandleSentPayload(
       const boost::system::error_code& ecode,
-      std::size_t bytes_transferred,
-      std::vector<std::shared_ptr<I2NPMessage>> msgs);
+      std::size_t bytes_transferred);
+
+  /// @return Size of the encrypted frame carrying given message
+  /// @param msg I2NP message, or nullptr for a timestamp
+  std::size_t GetFrameSize(
+      const std::shared_ptr<I2NPMessage>& msg) const;
+
+  /// @brief Writes the unencrypted frame of given message
+  ///   (size, data, padding and checksum)
+  /// @param msg I2NP message, or nullptr for a timestamp
+  /// @param buf Destination, at least GetFrameSize(msg) bytes
+  /// @return Number of bytes written
+  std::size_t PackFrame(
+      const std::shared_ptr<I2NPMessage>& msg,
+      std::uint8_t* buf);
 
   // Timer
   void ScheduleTermination();
@@ -256,6 +285,7 @@ class NTCPSession
   std::string m_RemoteIdentHashAbbreviation;
 
   NTCPServer& m_Server;
+  boost::asio::io_service& m_Service;
   boost::asio::ip::tcp::socket m_Socket;
   boost::asio::ip::tcp::endpoint m_RemoteEndpoint;
   boost::asio::deadline_timer m_TerminationTimer;
@@ -290,6 +320,7 @@ class NTCPSession
       Phase3Signature,  // Total = 448
     MaxMessage = 16384,
     Buffer = 4160,  // fits 4 tunnel messages (4 * 1028)
+    SendBuffer = 32768,  // max bytes packed into one write, unless a single frame is larger
   };
 
   // TODO(unassigned): is packing necessary?
@@ -318,7 +349,6 @@ class NTCPSession
   std::unique_ptr<Establisher> m_Establisher;
 
   kovri::core::AESAlignedBuffer<NTCPSize::Buffer + NTCPSize::IV> m_ReceiveBuffer;
-  kovri::core::AESAlignedBuffer<NTCPSize::IV> m_TimeSyncBuffer;
 
   std::size_t m_ReceiveBufferOffset;
 
@@ -327,7 +357,10 @@ class NTCPSession
   kovri::core::I2NPMessagesHandler m_Handler;
 
   bool m_IsSending;
-  std::vector<std::shared_ptr<I2NPMessage>> m_SendQueue;
+  std::deque<std::shared_ptr<I2NPMessage>> m_SendQueue;
+  std::size_t m_SendQueueSize;  // Bytes of encrypted frames waiting in the queue
+  std::size_t m_NumDroppedMessages;
+  std::vector<std::uint8_t> m_SendBuffer;  // Frames of the write in flight
 
   kovri::core::Exception m_Exception;
 };
@@ -0,0 +1,91 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#include "core/router/transports/ssu/congestion.h"
+
+#include <algorithm>
+
+#include "core/util/byte_stream.h"
+
+namespace kovri {
+namespace core {
+
+SSUCongestionControl::SSUCongestionControl()
+    : m_SRTT(0),
+      m_RTTVar(0),
+      m_RTO(GetType(SSUCongestion::InitialRTO)),
+      m_Window(GetType(SSUCongestion::InitialWindow)),
+      m_SlowStartThreshold(GetType(SSUCongestion::MaxWindow)),
+      m_NumACKedFragments(0) {}
+
+void SSUCongestionControl::UpdateRTT(
+    std::uint64_t rtt) {
+  if (!m_SRTT) {
+    // first sample
+    m_SRTT = std::max<std::uint64_t>(rtt, 1);
+    m_RTTVar = rtt / 2;
+  } else {
+    // RTTVAR = 3/4 RTTVAR + 1/4 |SRTT - R|, SRTT = 7/8 SRTT + 1/8 R
+    const std::uint64_t delta = m_SRTT > rtt ? m_SRTT - rtt : rtt - m_SRTT;
+    m_RTTVar = (3 * m_RTTVar + delta) / 4;
+    m_SRTT = std::max<std::uint64_t>((7 * m_SRTT + rtt) / 8, 1);
+  }
+  m_RTO = std::min<std::uint64_t>(
+      std::max<std::uint64_t>(
+          m_SRTT + 4 * m_RTTVar,
+          GetType(SSUCongestion::MinRTO)),
+      GetType(SSUCongestion::MaxRTO));
+}
+
+void SSUCongestionControl::OnACK(
+    std::size_t num_fragments) {
+  if (m_Window < m_SlowStartThreshold) {
+    m_Window += num_fragments;
+  } else {
+    m_NumACKedFragments += num_fragments;
+    if (m_NumACKedFragments >= m_Window) {
+      m_NumACKedFragments -= m_Window;
+      m_Window++;
+    }
+  }
+  m_Window = std::min<std::size_t>(m_Window, GetType(SSUCongestion::MaxWindow));
+}
+
+void SSUCongestionControl::OnTimeout() {
+  m_SlowStartThreshold =
+    std::max<std::size_t>(m_Window / 2, GetType(SSUCongestion::MinWindow));
+  m_Window = m_SlowStartThreshold;
+  m_NumACKedFragments = 0;
+  m_RTO = std::min<std::uint64_t>(m_RTO * 2, GetType(SSUCongestion::MaxRTO));
+}
+
+}  // namespace core
+}  // namespace kovri
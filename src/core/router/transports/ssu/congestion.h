@@ -0,0 +1,108 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#ifndef SRC_CORE_ROUTER_TRANSPORTS_SSU_CONGESTION_H_
+#define SRC_CORE_ROUTER_TRANSPORTS_SSU_CONGESTION_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace kovri {
+namespace core {
+
+/// @enum SSUCongestion
+/// @brief Constants of SSU retransmission timeout and congestion window
+/// @note Timeouts are in milliseconds, windows in fragments
+enum struct SSUCongestion : std::uint16_t {
+  InitialRTO = 1000,
+  MinRTO = 100,
+  MaxRTO = 60000,  // See RFC 6298 2.5
+  InitialWindow = 4,
+  MinWindow = 2,
+  MaxWindow = 1024,
+  MaxQueuedMessages = 512,  // Waiting for room in the window
+};
+
+/// @class SSUCongestionControl
+/// @brief Round-trip time estimate, retransmission timeout (RFC 6298) and
+///   congestion window (RFC 5681) of an SSU session
+/// @note Samples must only come from fragments sent once (Karn's rule)
+class SSUCongestionControl {
+ public:
+  SSUCongestionControl();
+
+  /// @brief Updates round-trip time estimate and timeout with a new sample
+  /// @param rtt Milliseconds between sending a fragment and its ACK
+  void UpdateRTT(
+      std::uint64_t rtt);
+
+  /// @brief Grows window for newly ACKed fragments, exponentially during
+  ///   slow start, by about one fragment per window afterwards
+  void OnACK(
+      std::size_t num_fragments);
+
+  /// @brief Halves window and doubles timeout, after fragments were not
+  ///   ACKed in time
+  void OnTimeout();
+
+  /// @return True if window has room for another message
+  /// @param num_in_flight Fragments sent and not yet ACKed
+  bool CanSend(
+      std::size_t num_in_flight) const {
+    return num_in_flight < m_Window;
+  }
+
+  /// @return Smoothed round-trip time in milliseconds, 0 until sampled
+  std::uint64_t GetRTT() const {
+    return m_SRTT;
+  }
+
+  /// @return Current retransmission timeout in milliseconds
+  std::uint64_t GetRTO() const {
+    return m_RTO;
+  }
+
+  /// @return Congestion window in fragments
+  std::size_t GetWindow() const {
+    return m_Window;
+  }
+
+ private:
+  std::uint64_t m_SRTT, m_RTTVar, m_RTO;
+  std::size_t m_Window, m_SlowStartThreshold;
+  // ACKed fragments towards the next window increase, in congestion avoidance
+  std::size_t m_NumACKedFragments;
+};
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_ROUTER_TRANSPORTS_SSU_CONGESTION_H_
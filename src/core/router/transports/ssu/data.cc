@@ -34,11 +34,13 @@
 
 #include <boost/bind.hpp>
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <memory>
 
 #include "core/router/net_db/impl.h"
+#include "core/router/transports/impl.h"
 #include "core/router/transports/ssu/server.h"
 #include "core/router/transports/ssu/packet.h"
 
@@ -48,20 +50,17 @@
 namespace kovri {
 namespace core {
 
-void IncompleteMessage::AttachNextFragment(
+bool IncompleteMessage::AttachNextFragment(
     const std::uint8_t* fragment,
     std::size_t fragment_size) {
-  if (msg->len + fragment_size > msg->max_len) {
-    LOG(debug)
-      << "Transport: SSU I2NP message size "
-      << msg->max_len << " is not enough";
-    auto new_msg = ToSharedI2NPMessage(NewI2NPMessage());
-    *new_msg = *msg;
-    msg = new_msg;
-  }
+  auto grown_msg = GrowI2NPMessage(msg, fragment_size);
+  if (!grown_msg)
+    return false;
+  msg = grown_msg;
   memcpy(msg->buf + msg->len, fragment, fragment_size);
   msg->len += fragment_size;
   next_fragment_num++;
+  return true;
 }
 
 SSUData::SSUData(
@@ -69,7 +68,17 @@ SSUData::SSUData(
     : m_Session(session),
       m_ResendTimer(session.GetService()),
       m_DecayTimer(session.GetService()),
-      m_IncompleteMessagesCleanupTimer(session.GetService()) {
+      m_IncompleteMessagesCleanupTimer(session.GetService()),
+      m_ACKTimer(session.GetService()),
+      m_PackTimer(session.GetService()),
+      m_PackedLen(0),
+      m_NumPackedFragments(0),
+      m_NumQueuedACKs(0),
+      m_NumSentACKPackets(0),
+      m_NumInFlight(0),
+      m_NumRetransmits(0),
+      m_NextResendTime(0),
+      m_Clock(kovri::core::GetMillisecondsSinceEpoch) {
   m_MaxPacketSize = session.IsV6()
     ? GetType(SSUSize::PacketMaxIPv6)
     : GetType(SSUSize::PacketMaxIPv4);
@@ -91,6 +100,14 @@ void SSUData::Stop() {
   m_ResendTimer.cancel();
   m_DecayTimer.cancel();
   m_IncompleteMessagesCleanupTimer.cancel();
+  m_ACKTimer.cancel();
+  m_PackTimer.cancel();
+  m_SendQueue.clear();
+  LOG(debug)
+    << "SSUData:" << m_Session.GetFormattedSessionInfo()
+    << "RTT=" << m_Congestion.GetRTT() << "ms RTO=" << m_Congestion.GetRTO()
+    << "ms window=" << m_Congestion.GetWindow()
+    << " retransmits=" << m_NumRetransmits;
 }
 
 void SSUData::AdjustPacketSize(
@@ -142,12 +159,26 @@ void SSUData::ProcessSentMessageACK(
       //"processing sent message ACK");
   auto it = m_SentMessages.find(msg_id);
   if (it != m_SentMessages.end()) {
+    // fragments ACKed by bitfield are already accounted for
+    OnFragmentsACKed(*it->second, it->second->GetNumUnACKed());
     m_SentMessages.erase(it);
     if (m_SentMessages.empty())
       m_ResendTimer.cancel();
   }
 }
 
+void SSUData::OnFragmentsACKed(
+    const SentMessage& message,
+    std::size_t num_fragments) {
+  if (!num_fragments)
+    return;
+  // Karn's rule: the ACK of a resent message may be for any of its sends
+  if (!message.num_resends)
+    m_Congestion.UpdateRTT(m_Clock() - message.send_time);
+  m_Congestion.OnACK(num_fragments);
+  m_NumInFlight -= std::min(m_NumInFlight, num_fragments);
+}
+
 void SSUData::ProcessACKs(
     std::uint8_t*& buf,
     std::uint8_t flag) {
@@ -171,27 +202,37 @@ void SSUData::ProcessACKs(
       auto it = m_SentMessages.find(msg_id);
       // process individual ACK bitfields
       bool is_not_last = false;
-      std::size_t fragment = 0;
+      std::size_t fragment = 0, num_ACKed = 0;
       do {
         auto bitfield = *buf;
         is_not_last = bitfield & 0x80;
         bitfield &= 0x7F;  // clear MSB
         if (bitfield && it != m_SentMessages.end()) {
-          auto num_send_fragments = it->second->fragments.size();
+          auto& fragments = it->second->fragments;
           // process bits
-          std::uint8_t mask = 0x01;
-          for (auto j = 0; j < 7; j++) {
-            if (bitfield & mask) {
-              if (fragment < num_send_fragments)
-                it->second->fragments[fragment].reset(nullptr);
+          for (std::size_t j = 0; j < 7; j++) {
+            const std::size_t num = fragment + j;
+            if ((bitfield & (0x01 << j))
+                && num < fragments.size() && fragments[num]) {
+              fragments[num].reset(nullptr);
+              num_ACKed++;
             }
-            fragment++;
-            mask <<= 1;
           }
         }
+        // every byte covers 7 fragments, whether any of them is set or not
+        fragment += 7;
         buf++;
       }
       while (is_not_last);
+      if (it != m_SentMessages.end()) {
+        OnFragmentsACKed(*it->second, num_ACKed);
+        // all fragments ACKed, no need to wait for the message ACK
+        if (!it->second->GetNumUnACKed()) {
+          m_SentMessages.erase(it);
+          if (m_SentMessages.empty())
+            m_ResendTimer.cancel();
+        }
+      }
     }
   }
 }
@@ -224,7 +265,8 @@ void SSUData::ProcessFragments(
     auto it = m_IncompleteMessages.find(msg_id);
     if (it == m_IncompleteMessages.end()) {
       // create new message
-      auto msg = ToSharedI2NPMessage(NewI2NPShortMessage());
+      // sized for the first fragment, grown as more fragments arrive
+      auto msg = ToSharedI2NPMessage(NewI2NPMessage(fragment_size));
       msg->len -= I2NP_SHORT_HEADER_SIZE;
       it = m_IncompleteMessages.insert(
           std::make_pair(
@@ -236,17 +278,22 @@ void SSUData::ProcessFragments(
     // handle current fragment
     if (fragment_num == incomplete_message->next_fragment_num) {
       // expected fragment
-      incomplete_message->AttachNextFragment(buf, fragment_size);
-      if (!is_last && !incomplete_message->saved_fragments.empty()) {
+      bool is_attached =
+        incomplete_message->AttachNextFragment(buf, fragment_size);
+      if (is_attached &&
+          !is_last &&
+          !incomplete_message->saved_fragments.empty()) {
         // try saved fragments
         for (auto saved_fragment = incomplete_message->saved_fragments.begin();
             saved_fragment != incomplete_message->saved_fragments.end();) {
           auto& fragment = *saved_fragment;
           if (fragment->fragment_num ==
               incomplete_message->next_fragment_num) {
-            incomplete_message->AttachNextFragment(
+            is_attached = incomplete_message->AttachNextFragment(
                 fragment->buffer.data(),
                 fragment->len);
+            if (!is_attached)
+              break;
             is_last = fragment->is_last;
             incomplete_message->saved_fragments.erase(saved_fragment++);
           } else {
@@ -258,6 +305,15 @@ void SSUData::ProcessFragments(
             << "SSUData:" << m_Session.GetFormattedSessionInfo()
             << "message " << msg_id << " is complete";
       }
+      if (!is_attached) {
+        LOG(error)
+          << "SSUData:" << m_Session.GetFormattedSessionInfo()
+          << "message " << msg_id
+          << " exceeds max I2NP message size. Message dropped";
+        m_IncompleteMessages.erase(it);
+        buf += fragment_size;
+        continue;
+      }
     } else {
       if (fragment_num < incomplete_message->next_fragment_num) {
         // duplicate fragment
@@ -292,7 +348,7 @@ void SSUData::ProcessFragments(
       incomplete_message->msg = nullptr;
       m_IncompleteMessages.erase(msg_id);
       // process message
-      SendMsgACK(msg_id);
+      QueueMsgACK(msg_id);
       msg->FromSSU(msg_id);
       if (m_Session.GetState() == SessionState::Established) {
         if (!m_ReceivedMessages.count(msg_id)) {
@@ -330,7 +386,7 @@ void SSUData::ProcessFragments(
         }
       }
     } else {
-      SendFragmentACK(msg_id, fragment_num);
+      QueueFragmentACK(msg_id);
     }
     buf += fragment_size;
   }
@@ -356,8 +412,11 @@ void SSUData::ProcessMessage(
   // process acks if presented
   if (flag &
       (GetType(SSUFlag::DataACKBitfieldsIncluded) |
-       GetType(SSUFlag::DataExplicitACKsIncluded)))
+       GetType(SSUFlag::DataExplicitACKsIncluded))) {
     ProcessACKs(buf, flag);
+    // ACKs opened the window
+    SendQueuedMessages();
+  }
   // extended data if presented
   if (flag & GetType(SSUFlag::DataExtendedIncluded)) {
     std::uint8_t extended_data_size = *buf;
@@ -374,6 +433,33 @@ void SSUData::ProcessMessage(
 
 void SSUData::Send(
     std::shared_ptr<kovri::core::I2NPMessage> msg) {
+  if (!m_SendQueue.empty() || !m_Congestion.CanSend(m_NumInFlight)) {
+    if (m_SendQueue.size() >= GetType(SSUCongestion::MaxQueuedMessages)) {
+      LOG(debug)
+        << "SSUData:" << m_Session.GetFormattedSessionInfo()
+        << "send queue is full, dropping message";
+      transports.UpdateDroppedMessages(1);
+      return;
+    }
+    m_SendQueue.push_back(msg);
+    return;
+  }
+  SendMessage(msg);
+}
+
+void SSUData::SendQueuedMessages() {
+  bool is_sent = false;
+  while (!m_SendQueue.empty() && m_Congestion.CanSend(m_NumInFlight)) {
+    SendMessage(m_SendQueue.front());
+    m_SendQueue.pop_front();
+    is_sent = true;
+  }
+  if (is_sent)
+    FlushPacket();
+}
+
+void SSUData::SendMessage(
+    std::shared_ptr<kovri::core::I2NPMessage> msg) {
   LOG(debug)
     << "SSUData:" << m_Session.GetFormattedSessionInfo()
     << "sending message";
@@ -393,9 +479,9 @@ void SSUData::Send(
             std::unique_ptr<SentMessage>(std::make_unique<SentMessage>())));
   std::unique_ptr<SentMessage>& sent_message = ret.first->second;
   if (ret.second) {
+    sent_message->send_time = m_Clock();
     sent_message->next_resend_time =
-      kovri::core::GetSecondsSinceEpoch()
-      + GetType(SSUDuration::ResendInterval);
+      sent_message->send_time + m_Congestion.GetRTO();
     sent_message->num_resends = 0;
   }
   auto& fragments = sent_message->fragments;
@@ -407,38 +493,22 @@ void SSUData::Send(
   while (len > 0) {
     auto fragment = std::make_unique<Fragment>();
     fragment->fragment_num = fragment_num;
-    auto buf = fragment->buffer.data();
-    auto payload = buf + GetType(SSUSize::HeaderMin);
-    *payload = GetType(SSUFlag::DataWantReply);  // for compatibility
-    payload++;
-    *payload = 1;  // always 1 message fragment per message
-    payload++;
-    htobe32buf(payload, msg_id);
-    payload += 4;
     bool is_last = (len <= payload_size);
     auto size = is_last ? len : payload_size;
+    fragment->is_last = is_last;
+    auto buf = fragment->buffer.data();
+    htobe32buf(buf, msg_id);
     auto fragment_info = (fragment_num << 17);
     if (is_last)
       fragment_info |= 0x010000;
     fragment_info |= size;
     fragment_info = htobe32(fragment_info);
-    memcpy(payload, reinterpret_cast<std::uint8_t *>((&fragment_info)) + 1, 3);
-    payload += 3;
-    memcpy(payload, msg_buf, size);
-    size += payload - buf;
-    if (size & 0x0F)  // make sure 16 bytes boundary
-      size = ((size >> 4) + 1) << 4;  // (/16 + 1) * 16
-    fragment->len = size;
+    memcpy(buf + 4, reinterpret_cast<std::uint8_t *>((&fragment_info)) + 1, 3);
+    memcpy(buf + 7, msg_buf, size);
+    fragment->len = size + 7;
+    PackFragment(*fragment);
     fragments.push_back(std::unique_ptr<Fragment>(std::move(fragment)));
-    // encrypt message with session key
-    m_Session.FillHeaderAndEncrypt(GetType(SSUPayloadType::Data), buf, size);
-    try {
-      m_Session.Send(buf, size);
-    } catch (boost::system::system_error& ec) {
-      LOG(error)
-        << "SSUData:" << m_Session.GetFormattedSessionInfo()
-        << "can't send SSU fragment: '" << ec.what() << "'";
-    }
+    m_NumInFlight++;
     if (!is_last) {
       len -= payload_size;
       msg_buf += payload_size;
@@ -449,57 +519,234 @@ void SSUData::Send(
   }
 }
 
-void SSUData::SendMsgACK(
-    std::uint32_t msg_id) {
+void SSUData::PackFragment(
+    const Fragment& fragment) {
+  // 2 = flag + number of fragments
+  const std::size_t max_len = m_PacketSize - GetType(SSUSize::HeaderMin) - 2;
+  if (m_PackedLen + fragment.len > max_len || m_NumPackedFragments == 255)
+    FlushPacket();
+  memcpy(m_PackBuffer.data() + m_PackedLen, fragment.buffer.data(), fragment.len);
+  m_PackedLen += fragment.len;
+  m_NumPackedFragments++;
+  // 8 = message ID (4) + fragment info (3) + 1 byte of data
+  if (m_PackedLen + 8 > max_len)
+    FlushPacket();  // full
+  else if (m_NumPackedFragments == 1)
+    SchedulePackFlush();
+}
+
+void SSUData::FlushPacket() {
+  if (!m_NumPackedFragments)
+    return;
   LOG(debug)
     << "SSUData:" << m_Session.GetFormattedSessionInfo()
-    << "sending message ACK";
-  // actual length is 44 = 37 + 7 but pad it to multiple of 16
-  std::array<std::uint8_t, 48 + 18> buf;
+    << "sending " << m_NumPackedFragments << " fragment(s)";
+  m_PackTimer.cancel();
+  std::array<std::uint8_t, GetType(SSUSize::PacketMaxIPv4) + 18> buf;
   auto payload = buf.data() + GetType(SSUSize::HeaderMin);
-  *payload = GetType(SSUFlag::DataExplicitACKsIncluded);  // flag
+  auto& flag = *payload;
+  flag = GetType(SSUFlag::DataWantReply);  // for compatibility
   payload++;
-  *payload = 1;  // number of ACKs
+  // pending ACKs ride along in the room left by fragments
+  // 2 = flag + number of fragments
+  const std::size_t max_len = m_PacketSize - GetType(SSUSize::HeaderMin) - 2;
+  payload += PutPendingACKs(
+      flag,
+      payload,
+      m_PackedLen < max_len ? max_len - m_PackedLen : 0);
+  *payload = m_NumPackedFragments;
   payload++;
-  *(reinterpret_cast<std::uint32_t *>(payload)) = htobe32(msg_id);  // msg_id
-  payload += 4;
-  *payload = 0;  // number of fragments
+  memcpy(payload, m_PackBuffer.data(), m_PackedLen);
+  payload += m_PackedLen;
+  m_PackedLen = 0;
+  m_NumPackedFragments = 0;
+  std::size_t size = payload - buf.data();
+  if (size & 0x0F)  // make sure 16 bytes boundary
+    size = ((size >> 4) + 1) << 4;  // (/16 + 1) * 16
+  try {
+    SendPacket(buf.data(), size);
+  } catch (boost::system::system_error& ec) {
+    LOG(error)
+      << "SSUData:" << m_Session.GetFormattedSessionInfo()
+      << "can't send SSU fragments: '" << ec.what() << "'";
+  }
+}
+
+void SSUData::SendPacket(
+    std::uint8_t* buf,
+    std::size_t size) {
+  if (m_PayloadHandler) {
+    m_PayloadHandler(
+        buf + GetType(SSUSize::HeaderMin),
+        size - GetType(SSUSize::HeaderMin));
+    return;
+  }
   // encrypt message with session key
-  m_Session.FillHeaderAndEncrypt(GetType(SSUPayloadType::Data), buf.data(), 48);
-  m_Session.Send(buf.data(), 48);
+  m_Session.FillHeaderAndEncrypt(GetType(SSUPayloadType::Data), buf, size);
+  m_Session.Send(buf, size);
 }
 
-void SSUData::SendFragmentACK(
-    std::uint32_t msg_id,
-    std::size_t fragment_num) {
+void SSUData::SchedulePackFlush() {
+  m_PackTimer.expires_from_now(
+      boost::posix_time::milliseconds(
+          GetType(SSUDuration::PackDelay)));
+  auto s = m_Session.shared_from_this();
+  m_PackTimer.async_wait(
+      [s](const boost::system::error_code& ecode) {
+      s->m_Data.HandlePackTimer(ecode);
+      });
+}
+
+void SSUData::HandlePackTimer(
+    const boost::system::error_code& ecode) {
+  if (ecode != boost::asio::error::operation_aborted)
+    FlushPacket();
+}
+
+void SSUData::QueueMsgACK(
+    std::uint32_t msg_id) {
   LOG(debug)
     << "SSUData:" << m_Session.GetFormattedSessionInfo()
-    << "sending fragment ACK";
-  if (fragment_num > 64) {
-    LOG(warning)
-      << "SSUData:" << m_Session.GetFormattedSessionInfo()
-      << "fragment number " << fragment_num << " exceeds 64";
-    return;
+    << "queueing message ACK";
+  m_PendingFragmentACKs.erase(msg_id);
+  m_PendingMsgACKs.insert(msg_id);
+  m_NumQueuedACKs++;
+  ScheduleACKs();
+}
+
+void SSUData::QueueFragmentACK(
+    std::uint32_t msg_id) {
+  LOG(debug)
+    << "SSUData:" << m_Session.GetFormattedSessionInfo()
+    << "queueing fragment ACK";
+  // bitfield is built when sent, from all fragments received by then
+  m_PendingFragmentACKs.insert(msg_id);
+  m_NumQueuedACKs++;
+  ScheduleACKs();
+}
+
+std::size_t SSUData::PutPendingACKs(
+    std::uint8_t& flag,
+    std::uint8_t* buf,
+    std::size_t max_len) {
+  std::size_t len = 0;
+  // explicit ACKs: number + message IDs
+  if (!m_PendingMsgACKs.empty() && max_len >= 5) {
+    auto num_ACKs = std::min<std::size_t>(
+        {m_PendingMsgACKs.size(), (max_len - 1) / 4, 255});
+    buf[len++] = num_ACKs;
+    auto it = m_PendingMsgACKs.begin();
+    for (std::size_t i = 0; i < num_ACKs; i++) {
+      htobe32buf(buf + len, *it);
+      len += 4;
+      it = m_PendingMsgACKs.erase(it);
+    }
+    flag |= GetType(SSUFlag::DataExplicitACKsIncluded);
   }
-  std::array<std::uint8_t, 64 + 18> buf;  // TODO(unassigned): document values
-  auto payload = buf.data() + GetType(SSUSize::HeaderMin);
-  *payload = GetType(SSUFlag::DataACKBitfieldsIncluded);  // flag
-  payload++;
-  *payload = 1;  // number of ACK bitfields
-  payload++;
-  // one ack
-  *(reinterpret_cast<std::uint32_t *>(payload)) = htobe32(msg_id);  // msg_id
-  payload += 4;
-  div_t d = div(fragment_num, 7);
-  memset(payload, 0x80, d.quot);  // 0x80 means non-last
-  payload += d.quot;
-  *payload = 0x01 << d.rem;  // set corresponding bit
-  payload++;
-  *payload = 0;  // number of fragments
-  auto len = d.quot < 4 ? 48 : 64;  // 48 = 37 + 7 + 4 (3+1)
-  // encrypt message with session key
-  m_Session.FillHeaderAndEncrypt(GetType(SSUPayloadType::Data), buf.data(), len);
-  m_Session.Send(buf.data(), len);
+  // ACK bitfields: number + (message ID + bitfield) each
+  if (!m_PendingFragmentACKs.empty() && max_len >= len + 6) {
+    auto& num_bitfields = buf[len++];
+    num_bitfields = 0;
+    for (auto it = m_PendingFragmentACKs.begin();
+         it != m_PendingFragmentACKs.end() && num_bitfields < 255;) {
+      auto incomplete = m_IncompleteMessages.find(*it);
+      if (incomplete == m_IncompleteMessages.end()) {
+        // completed or expired meanwhile
+        it = m_PendingFragmentACKs.erase(it);
+        continue;
+      }
+      // 7 fragments per byte, for up to 128 fragments
+      std::array<std::uint8_t, 19> bitfield {};
+      std::size_t last_fragment = 0;
+      auto set_fragment = [&bitfield, &last_fragment](std::size_t num) {
+        bitfield.at(num / 7) |= 0x01 << (num % 7);
+        last_fragment = std::max(last_fragment, num);
+      };
+      auto& message = incomplete->second;
+      for (std::size_t i = 0; i < message->next_fragment_num; i++)
+        set_fragment(i);
+      for (const auto& fragment : message->saved_fragments)
+        set_fragment(fragment->fragment_num);
+      const std::size_t bitfield_len = last_fragment / 7 + 1;
+      if (len + 4 + bitfield_len > max_len)
+        break;
+      htobe32buf(buf + len, *it);
+      len += 4;
+      for (std::size_t i = 0; i < bitfield_len; i++)
+        buf[len++] = bitfield[i]
+          | (i + 1 < bitfield_len ? GetType(SSUFlag::DataACKBitFieldHasNext) : 0);
+      num_bitfields++;
+      it = m_PendingFragmentACKs.erase(it);
+    }
+    if (num_bitfields)
+      flag |= GetType(SSUFlag::DataACKBitfieldsIncluded);
+    else
+      len--;
+  }
+  UpdateSavedACKPackets();
+  return len;
+}
+
+void SSUData::SendPendingACKs() {
+  LOG(debug)
+    << "SSUData:" << m_Session.GetFormattedSessionInfo()
+    << "sending pending ACKs";
+  // fragments waiting to be sent carry what they can
+  FlushPacket();
+  while (!m_PendingMsgACKs.empty() || !m_PendingFragmentACKs.empty()) {
+    std::array<std::uint8_t, GetType(SSUSize::PacketMaxIPv4) + 18> buf;
+    auto payload = buf.data() + GetType(SSUSize::HeaderMin);
+    auto& flag = *payload;
+    flag = 0;
+    payload++;
+    // 2 = flag + number of fragments
+    auto acks_len = PutPendingACKs(
+        flag,
+        payload,
+        m_PacketSize - GetType(SSUSize::HeaderMin) - 2);
+    if (!acks_len)
+      break;  // nothing left but expired messages
+    payload += acks_len;
+    *payload = 0;  // number of fragments
+    payload++;
+    std::size_t size = payload - buf.data();
+    if (size & 0x0F)  // make sure 16 bytes boundary
+      size = ((size >> 4) + 1) << 4;  // (/16 + 1) * 16
+    SendPacket(buf.data(), size);
+    m_NumSentACKPackets++;
+  }
+  UpdateSavedACKPackets();
+}
+
+void SSUData::UpdateSavedACKPackets() {
+  if (!m_NumQueuedACKs ||
+      !m_PendingMsgACKs.empty() ||
+      !m_PendingFragmentACKs.empty())
+    return;
+  m_ACKTimer.cancel();
+  if (m_NumQueuedACKs > m_NumSentACKPackets)
+    transports.UpdateSavedACKPackets(m_NumQueuedACKs - m_NumSentACKPackets);
+  m_NumQueuedACKs = 0;
+  m_NumSentACKPackets = 0;
+}
+
+void SSUData::ScheduleACKs() {
+  if (m_NumQueuedACKs > 1)
+    return;  // already scheduled with the first ACK
+  m_ACKTimer.expires_from_now(
+      boost::posix_time::milliseconds(
+          GetType(SSUDuration::ACKDelay)));
+  auto s = m_Session.shared_from_this();
+  m_ACKTimer.async_wait(
+      [s](const boost::system::error_code& ecode) {
+      s->m_Data.HandleACKTimer(ecode);
+      });
+}
+
+void SSUData::HandleACKTimer(
+    const boost::system::error_code& ecode) {
+  if (ecode != boost::asio::error::operation_aborted)
+    SendPendingACKs();
 }
 
 void SSUData::ScheduleResend() {
@@ -507,9 +754,19 @@ void SSUData::ScheduleResend() {
     << "SSUData:" << m_Session.GetFormattedSessionInfo()
     << "scheduling resend";
   m_ResendTimer.cancel();
+  // wake up for the first message due, or past its lifetime
+  const auto ts = m_Clock();
+  auto next_resend_time = ts + m_Congestion.GetRTO();
+  for (const auto& it : m_SentMessages)
+    next_resend_time = std::min(
+        {next_resend_time,
+         it.second->next_resend_time,
+         it.second->send_time
+           + GetType(SSUDuration::MessageLifetime) * 1000});
+  m_NextResendTime = next_resend_time;
   m_ResendTimer.expires_from_now(
-      boost::posix_time::seconds(
-          GetType(SSUDuration::ResendInterval)));
+      boost::posix_time::milliseconds(
+          next_resend_time > ts ? next_resend_time - ts : 0));
   auto s = m_Session.shared_from_this();
   m_ResendTimer.async_wait(
       [s](const boost::system::error_code& ecode) {
@@ -522,38 +779,54 @@ void SSUData::HandleResendTimer(
   LOG(debug)
     << "SSUData:" << m_Session.GetFormattedSessionInfo()
     << "handling resend timer";
-  if (ecode != boost::asio::error::operation_aborted) {
-    auto ts = kovri::core::GetSecondsSinceEpoch();
-    for (auto it = m_SentMessages.begin(); it != m_SentMessages.end();) {
-      if (ts >= it->second->next_resend_time) {
-        if (it->second->num_resends < GetType(SSUDuration::MaxResends)) {
-          for (auto& fragment : it->second->fragments)
-            if (fragment) {
-              try {
-                m_Session.Send(fragment->buffer.data(), fragment->len);  // resend
-              } catch (boost::system::system_error& ec) {
-                LOG(error)
-                  << "SSUData:" << m_Session.GetFormattedSessionInfo()
-                  << "can't resend SSU fragment: '" << ec.what() << "'";
-              }
-            }
-          it->second->num_resends++;
-          it->second->next_resend_time
-             += it->second->num_resends * GetType(SSUDuration::ResendInterval);
-          it++;
-        } else {
-          LOG(error)
-            << "SSUData:" << m_Session.GetFormattedSessionInfo()
-            << "SSU message has not been ACKed after "
-            << static_cast<std::size_t>(SSUDuration::MaxResends) << " attempts. Deleted";
-          it = m_SentMessages.erase(it);
+  if (ecode != boost::asio::error::operation_aborted)
+    Resend();
+}
+
+void SSUData::Resend() {
+  const auto ts = m_Clock();
+  const std::uint64_t lifetime =
+    GetType(SSUDuration::MessageLifetime) * 1000;
+  bool is_timeout = false;
+  for (auto it = m_SentMessages.begin(); it != m_SentMessages.end();) {
+    const std::size_t num_unACKed = it->second->GetNumUnACKed();
+    if (!num_unACKed) {
+      // fully ACKed by bitfields, nothing to resend
+      it = m_SentMessages.erase(it);
+    } else if (ts >= it->second->send_time + lifetime) {
+      LOG(error)
+        << "SSUData:" << m_Session.GetFormattedSessionInfo()
+        << "SSU message has not been ACKed after "
+        << GetType(SSUDuration::MessageLifetime) << " seconds. Deleted";
+      m_NumInFlight -= std::min(m_NumInFlight, num_unACKed);
+      it = m_SentMessages.erase(it);
+    } else {
+      // one loss event per timeout, however many messages are due
+      if (ts >= it->second->next_resend_time)
+        is_timeout = true;
+      it++;
+    }
+  }
+  if (is_timeout) {
+    m_Congestion.OnTimeout();  // shrinks window, backs off timeout
+    for (auto& it : m_SentMessages) {
+      if (ts < it.second->next_resend_time)
+        continue;
+      for (auto& fragment : it.second->fragments)
+        if (fragment) {
+          PackFragment(*fragment);  // resend
+          m_NumRetransmits++;
         }
-      } else {
-        it++;
-      }
+      it.second->num_resends++;
+      it.second->next_resend_time = ts + m_Congestion.GetRTO();
     }
-    ScheduleResend();
   }
+  FlushPacket();
+  SendQueuedMessages();
+  if (!m_SentMessages.empty())
+    ScheduleResend();
+  else
+    m_ResendTimer.cancel();
 }
 
 void SSUData::ScheduleDecay() {
@@ -564,7 +837,7 @@ void SSUData::ScheduleDecay() {
       boost::posix_time::seconds(
           GetType(SSUDuration::DecayInterval)));
   auto s = m_Session.shared_from_this();
-  m_ResendTimer.async_wait(
+  m_DecayTimer.async_wait(
       [s](const boost::system::error_code& ecode) {
       s->m_Data.HandleDecayTimer(ecode);
       });
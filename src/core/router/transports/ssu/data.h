@@ -35,8 +35,11 @@
 
 #include <boost/asio.hpp>
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
+#include <deque>
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
@@ -45,6 +48,7 @@
 #include "core/router/i2np.h"
 #include "core/router/identity.h"
 #include "core/router/info.h"
+#include "core/router/transports/ssu/congestion.h"
 #include "core/router/transports/ssu/packet.h"
 
 namespace kovri {
@@ -54,8 +58,9 @@ namespace core {
 /// @brief Constants used to represent various aspects
 ///   of duration used during SSU activity
 enum struct SSUDuration : std::uint16_t {
-  ResendInterval = 3,  // Seconds
-  MaxResends = 5,
+  ACKDelay = 10,  // Milliseconds we wait for data to carry ACKs
+  PackDelay = 5,  // Milliseconds we wait for more fragments to share a packet
+  MessageLifetime = 45,  // Seconds we resend a message until it is ACKed
   DecayInterval = 20,  // Number of message IDs we store for duplicates check
   IncompleteMessagesCleanupTimeout = 30,  // Seconds
   ConnectTimeout = 5,  // Seconds
@@ -65,6 +70,9 @@ enum struct SSUDuration : std::uint16_t {
   ToIntroducerSessionDuration = 3600,  // 1 hour
 };
 
+/// @brief Fragment of a message
+/// @note For sent messages, buffer holds the message ID and fragment info
+///   ahead of the data, as written in the packet
 struct Fragment {
   Fragment() = default;
 
@@ -100,7 +108,8 @@ struct IncompleteMessage {
         next_fragment_num(0),
         last_fragment_insert_time(0) {}
 
-  void AttachNextFragment(
+  /// @return False if the message would exceed the max I2NP message size
+  bool AttachNextFragment(
       const std::uint8_t* fragment,
       std::size_t fragment_size);
 
@@ -111,14 +120,29 @@ struct IncompleteMessage {
 };
 
 struct SentMessage {
-  std::vector<std::unique_ptr<Fragment>> fragments;
-  std::uint32_t next_resend_time;  // in seconds
+  /// @return Number of fragments not ACKed yet
+  std::size_t GetNumUnACKed() const {
+    return std::count_if(
+        fragments.begin(),
+        fragments.end(),
+        [](const std::unique_ptr<Fragment>& f) { return f != nullptr; });
+  }
+
+  std::vector<std::unique_ptr<Fragment>> fragments;  // null once ACKed
+  std::uint64_t send_time;  // in milliseconds
+  std::uint64_t next_resend_time;  // in milliseconds
   std::size_t num_resends;
 };
 
 class SSUSession;
 class SSUData {
  public:
+  /// @brief Source of time in milliseconds since epoch
+  typedef std::function<std::uint64_t()> Clock;
+
+  /// @brief Handler of data payloads (flag byte onwards) about to be sent
+  typedef std::function<void(std::uint8_t*, std::size_t)> PayloadHandler;
+
   SSUData(
       SSUSession& session);
 
@@ -134,19 +158,128 @@ class SSUData {
 
   void FlushReceivedMessage();
 
+  /// @brief Fragments message into the packets being packed, or queues it
+  ///   until the congestion window has room
   void Send(
       std::shared_ptr<kovri::core::I2NPMessage> msg);
 
+  /// @brief Sends the fragments packed so far in one packet
+  void FlushPacket();
+
   void UpdatePacketSize(
       const kovri::core::IdentHash& remote_ident);
 
+  /// @brief Sends ACKs that could not be piggybacked on data, in as few
+  ///   packets as possible
+  /// @note Called by the ACK timer
+  void SendPendingACKs();
+
+  /// @brief Resends fragments not ACKed in time, and gives up on messages
+  ///   past their lifetime
+  /// @note Called by the resend timer
+  void Resend();
+
+  /// @brief Replaces the clock of timeouts and round-trip times
+  void SetClock(
+      Clock clock) {
+    m_Clock = clock;
+  }
+
+  /// @brief Hands payloads to given handler instead of encrypting them and
+  ///   sending them to the peer, e.g., for a simulated link
+  void SetPayloadHandler(
+      PayloadHandler handler) {
+    m_PayloadHandler = handler;
+  }
+
+  /// @return Smoothed round-trip time in milliseconds, 0 until measured
+  std::uint64_t GetRTT() const {
+    return m_Congestion.GetRTT();
+  }
+
+  /// @return Retransmission timeout in milliseconds
+  std::uint64_t GetRTO() const {
+    return m_Congestion.GetRTO();
+  }
+
+  /// @return Congestion window in fragments
+  std::size_t GetCongestionWindow() const {
+    return m_Congestion.GetWindow();
+  }
+
+  /// @return Number of fragments sent but not yet ACKed
+  std::size_t GetNumInFlight() const {
+    return m_NumInFlight;
+  }
+
+  /// @return Number of fragments sent again because they were not ACKed
+  std::size_t GetNumRetransmits() const {
+    return m_NumRetransmits;
+  }
+
+  /// @return Number of sent messages waiting for their ACK
+  std::size_t GetNumSentMessages() const {
+    return m_SentMessages.size();
+  }
+
+  /// @return Number of messages waiting for room in the congestion window
+  std::size_t GetNumQueuedMessages() const {
+    return m_SendQueue.size();
+  }
+
+  /// @return Time the resend timer expires, in milliseconds since epoch,
+  ///   or 0 if nothing waits for an ACK
+  std::uint64_t GetNextResendTime() const {
+    return m_SentMessages.empty() ? 0 : m_NextResendTime;
+  }
+
  private:
-  void SendMsgACK(
+  void SendMessage(
+      std::shared_ptr<kovri::core::I2NPMessage> msg);
+
+  /// @brief Sends queued messages while the congestion window has room
+  void SendQueuedMessages();
+
+  /// @brief Accounts for fragments of sent message newly ACKed
+  void OnFragmentsACKed(
+      const SentMessage& message,
+      std::size_t num_fragments);
+
+  /// @brief Adds fragment to the packet being packed, sending the packet
+  ///   first if fragment does not fit
+  void PackFragment(
+      const Fragment& fragment);
+
+  void SchedulePackFlush();
+
+  void HandlePackTimer(
+      const boost::system::error_code& ecode);
+
+  /// @brief Queues ACK of a fully received message
+  void QueueMsgACK(
+      std::uint32_t msg_id);
+
+  /// @brief Queues ACK of the fragments received so far of a message
+  void QueueFragmentACK(
       std::uint32_t msg_id);
 
-  void SendFragmentACK(
-      std::uint32_t msg_id,
-      std::size_t fragment_num);
+  /// @brief Writes as many pending ACKs as fit in given space
+  /// @param flag Data flag, updated with the ACK fields written
+  /// @param buf Start of ACK fields, right after flag
+  /// @param max_len Space available for ACK fields
+  /// @return Number of bytes written
+  std::size_t PutPendingACKs(
+      std::uint8_t& flag,
+      std::uint8_t* buf,
+      std::size_t max_len);
+
+  /// @brief Accounts for ACK packets saved, once nothing is pending
+  void UpdateSavedACKPackets();
+
+  void ScheduleACKs();
+
+  void HandleACKTimer(
+      const boost::system::error_code& ecode);
 
   void ProcessACKs(
       std::uint8_t*& buf,
@@ -158,6 +291,11 @@ class SSUData {
   void ProcessSentMessageACK(
       std::uint32_t msg_id);
 
+  /// @brief Encrypts and sends packet, whose payload starts after the header
+  void SendPacket(
+      std::uint8_t* buf,
+      std::size_t size);
+
   void ScheduleResend();
 
   void HandleResendTimer(
@@ -182,8 +320,23 @@ class SSUData {
   std::map<std::uint32_t, std::unique_ptr<SentMessage>> m_SentMessages;
   std::set<std::uint32_t> m_ReceivedMessages;
   boost::asio::deadline_timer m_ResendTimer, m_DecayTimer,
-                              m_IncompleteMessagesCleanupTimer;
+                              m_IncompleteMessagesCleanupTimer, m_ACKTimer,
+                              m_PackTimer;
+  // Fragments of the packet being packed, and their number
+  std::array<std::uint8_t, GetType(SSUSize::PacketMaxIPv4)> m_PackBuffer;
+  std::size_t m_PackedLen, m_NumPackedFragments;
+  // IDs of messages to ACK, fully or by their received fragments
+  std::set<std::uint32_t> m_PendingMsgACKs, m_PendingFragmentACKs;
+  // ACK packets we would send one by one, and those actually sent
+  std::size_t m_NumQueuedACKs, m_NumSentACKPackets;
   std::size_t m_MaxPacketSize, m_PacketSize;
+  SSUCongestionControl m_Congestion;
+  // Messages waiting for room in the congestion window
+  std::deque<std::shared_ptr<kovri::core::I2NPMessage>> m_SendQueue;
+  std::size_t m_NumInFlight, m_NumRetransmits;
+  std::uint64_t m_NextResendTime;
+  Clock m_Clock;
+  PayloadHandler m_PayloadHandler;
   kovri::core::I2NPMessagesHandler m_Handler;
 };
 
@@ -35,6 +35,8 @@
 #include <boost/bind.hpp>
 
 #include <array>
+#include <cerrno>
+#include <cstring>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -53,42 +55,124 @@
 namespace kovri {
 namespace core {
 
+namespace {
+
+/// @brief Shard whose service runs on this thread, if not the first shard
+thread_local SSUServerShard* g_CurrentShard = nullptr;
+
+/// @brief Opens socket, then binds it to endpoint
+/// @param reuse_port Lets several sockets bind to the same endpoint
+void BindSocket(
+    boost::asio::ip::udp::socket& socket,
+    const boost::asio::ip::udp::endpoint& endpoint,
+    bool reuse_port) {
+  socket.open(endpoint.protocol());
+  if (endpoint.protocol() == boost::asio::ip::udp::v6())
+    socket.set_option(boost::asio::ip::v6_only(true));
+  socket.set_option(boost::asio::socket_base::receive_buffer_size(65535));
+  socket.set_option(boost::asio::socket_base::send_buffer_size(65535));
+#if defined(SO_REUSEPORT)
+  if (reuse_port)
+    socket.set_option(
+        boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>(
+            true));
+#else
+  (void)reuse_port;
+#endif
+  socket.bind(endpoint);
+}
+
+}  // namespace
+
+SSUServerShard::SSUServerShard(
+    boost::asio::io_service& service)
+    : service(service),
+      socket(service),
+      socket_v6(service) {
+#if defined(__linux__)
+  receive_batch = std::make_unique<SSUPacketBatch>();
+  send_batch = std::make_unique<SSUPacketBatch>();
+  if (context.SupportsV6()) {
+    receive_batch_v6 = std::make_unique<SSUPacketBatch>();
+    send_batch_v6 = std::make_unique<SSUPacketBatch>();
+  }
+  is_batching_sends = false;
+#endif
+}
+
 SSUServer::SSUServer(
     boost::asio::io_service& service,
     std::size_t port)
     : m_Service(service),
       m_Endpoint(boost::asio::ip::udp::v4(), port),
       m_EndpointV6(boost::asio::ip::udp::v6(), port),
-      m_Socket(m_Service, m_Endpoint),
-      m_SocketV6(m_Service),
+      m_NextShard(0),
       m_IntroducersUpdateTimer(m_Service),
       m_PeerTestsCleanupTimer(m_Service),
       m_IsRunning(false) {
-  m_Socket.set_option(boost::asio::socket_base::receive_buffer_size(65535));
-  m_Socket.set_option(boost::asio::socket_base::send_buffer_size(65535));
-  if (context.SupportsV6()) {
-    m_SocketV6.open(boost::asio::ip::udp::v6());
-    m_SocketV6.set_option(boost::asio::ip::v6_only(true));
-    m_SocketV6.set_option(boost::asio::socket_base::receive_buffer_size(65535));
-    m_SocketV6.set_option(boost::asio::socket_base::send_buffer_size(65535));
-    m_SocketV6.bind(m_EndpointV6);
+  std::size_t num_shards = context.GetOptionSSUShards();
+#if !defined(__linux__) || !defined(SO_REUSEPORT)
+  if (num_shards > 1)
+    LOG(warning) << "SSUServer: SO_REUSEPORT is not supported, using one socket";
+  num_shards = 1;
+#endif
+  // The first shard runs on the transports service, others on their own
+  m_Shards.push_back(std::make_unique<SSUServerShard>(m_Service));
+  for (std::size_t i = 1; i < num_shards; i++) {
+    m_ShardServices.push_back(std::make_unique<boost::asio::io_service>());
+    m_Shards.push_back(
+        std::make_unique<SSUServerShard>(*m_ShardServices.back()));
+  }
+  for (auto& shard : m_Shards) {
+    BindSocket(shard->socket, m_Endpoint, num_shards > 1);
+    if (context.SupportsV6())
+      BindSocket(shard->socket_v6, m_EndpointV6, num_shards > 1);
   }
 }
 
 SSUServer::~SSUServer() {}
 
+#if defined(__linux__)
+void SSUPacketBatch::SetHeader(
+    std::size_t i,
+    std::size_t len,
+    std::size_t name_len) {
+  iovecs[i].iov_base = packets[i].buf;
+  iovecs[i].iov_len = len;
+  std::memset(&headers[i], 0, sizeof(headers[i]));
+  headers[i].msg_hdr.msg_name = packets[i].from.data();
+  headers[i].msg_hdr.msg_namelen = name_len;
+  headers[i].msg_hdr.msg_iov = &iovecs[i];
+  headers[i].msg_hdr.msg_iovlen = 1;
+}
+#endif
+
 void SSUServer::Start() {
-  LOG(debug) << "SSUServer: starting";
+  LOG(debug) << "SSUServer: starting " << m_Shards.size() << " shard(s)";
   m_IsRunning = true;
-  m_Service.post(
-      std::bind(
-          &SSUServer::Receive,
-          this));
-  if (context.SupportsV6()) {
-    m_Service.post(
+  for (auto& shard : m_Shards) {
+    shard->service.post(
         std::bind(
-            &SSUServer::ReceiveV6,
-            this));
+            &SSUServer::Receive,
+            this,
+            std::ref(*shard)));
+    if (context.SupportsV6()) {
+      shard->service.post(
+          std::bind(
+              &SSUServer::ReceiveV6,
+              this,
+              std::ref(*shard)));
+    }
+  }
+  for (std::size_t i = 1; i < m_Shards.size(); i++) {
+    m_ShardWorks.push_back(
+        std::make_unique<boost::asio::io_service::work>(m_Shards[i]->service));
+    m_ShardThreads.push_back(
+        std::thread(
+            std::bind(
+                &SSUServer::RunShard,
+                this,
+                std::ref(*m_Shards[i]))));
   }
   SchedulePeerTestsCleanupTimer();
   // wait for 30 seconds and decide if we need introducers
@@ -97,26 +181,78 @@ void SSUServer::Start() {
 
 void SSUServer::Stop() {
   LOG(debug) << "SSUServer: stopping";
-  DeleteAllSessions();
   m_IsRunning = false;
-  m_Socket.close();
-  m_SocketV6.close();
+  m_ShardWorks.clear();
+  for (auto& service : m_ShardServices)
+    service->stop();
+  for (auto& thread : m_ShardThreads)
+    thread.join();
+  m_ShardThreads.clear();
+  DeleteAllSessions();
+  for (auto& shard : m_Shards) {
+    shard->socket.close();
+    shard->socket_v6.close();
+  }
+}
+
+void SSUServer::RunShard(
+    SSUServerShard& shard) {
+  g_CurrentShard = &shard;
+  while (m_IsRunning) {
+    try {
+      shard.service.run();
+    } catch (const std::exception& ex) {
+      LOG(error) << "SSUServer: " << __func__ << ": '" << ex.what() << "'";
+    }
+  }
+  g_CurrentShard = nullptr;
+}
+
+SSUServerShard& SSUServer::GetCurrentShard() {
+  return g_CurrentShard ? *g_CurrentShard : *m_Shards.front();
+}
+
+SSUServerShard& SSUServer::GetNextShard() {
+  return *m_Shards[m_NextShard++ % m_Shards.size()];
+}
+
+SSUServerShard* SSUServer::FindSessionShard(
+    const boost::asio::ip::udp::endpoint& ep) const {
+  for (const auto& shard : m_Shards) {
+    std::unique_lock<std::mutex> l(shard->sessions_mutex);
+    if (shard->sessions.count(ep))
+      return shard.get();
+  }
+  return nullptr;
+}
+
+void SSUServer::AddSession(
+    SSUServerShard& shard,
+    std::shared_ptr<SSUSession> session) {
+  std::unique_lock<std::mutex> l(shard.sessions_mutex);
+  shard.sessions[session->GetRemoteEndpoint()] = session;
 }
 
 void SSUServer::AddRelay(
     std::uint32_t tag,
     const boost::asio::ip::udp::endpoint& relay) {
   LOG(debug) << "SSUServer: adding relay";
+  std::unique_lock<std::mutex> l(m_RegistryMutex);
   m_Relays[tag] = relay;
 }
 
 std::shared_ptr<SSUSession> SSUServer::FindRelaySession(
     std::uint32_t tag) {
   LOG(debug) << "SSUServer: finding relay session";
-  auto it = m_Relays.find(tag);
-  if (it != m_Relays.end())
-    return FindSession(it->second);
-  return nullptr;
+  boost::asio::ip::udp::endpoint relay;
+  {
+    std::unique_lock<std::mutex> l(m_RegistryMutex);
+    auto it = m_Relays.find(tag);
+    if (it == m_Relays.end())
+      return nullptr;
+    relay = it->second;
+  }
+  return FindSession(relay);
 }
 
 void SSUServer::Send(
@@ -124,25 +260,48 @@ void SSUServer::Send(
     std::size_t len,
     const boost::asio::ip::udp::endpoint& to) {
   LOG(debug) << "SSUServer: sending data";
+  // All shards share our port, so any of their sockets will do
+  auto& shard = GetCurrentShard();
+#if defined(__linux__)
+  if (shard.is_batching_sends) {
+    const bool is_v4 = to.protocol() == boost::asio::ip::udp::v4();
+    auto& socket = is_v4 ? shard.socket : shard.socket_v6;
+    auto* batch = is_v4 ? shard.send_batch.get() : shard.send_batch_v6.get();
+    if (batch && len <= sizeof(batch->packets[0].buf)) {
+      if (batch->size == SSU_PACKET_BATCH_SIZE)
+        FlushSendBatch(socket, *batch);
+      auto& packet = batch->packets[batch->size++];
+      std::memcpy(packet.buf, buf, len);
+      packet.len = len;
+      packet.from = to;
+      return;
+    }
+  }
+#endif
   if (to.protocol() == boost::asio::ip::udp::v4()) {
     try {
-      m_Socket.send_to(boost::asio::buffer(buf, len), to);
+      shard.socket.send_to(boost::asio::buffer(buf, len), to);
     } catch (const std::exception& ex) {
       LOG(error) << "SSUServer: send error: '" << ex.what() << "'";
     }
   } else {
     try {
-      m_SocketV6.send_to(boost::asio::buffer(buf, len), to);
+      shard.socket_v6.send_to(boost::asio::buffer(buf, len), to);
     } catch (const std::exception& ex) {
       LOG(error) << "SSUServer: V6 send error: '" << ex.what() << "'";
     }
   }
 }
 
-void SSUServer::Receive() {
+void SSUServer::Receive(
+    SSUServerShard& shard) {
   LOG(debug) << "SSUServer: receiving data";
+#if defined(__linux__)
+  ReceiveBatch(
+      shard, shard.socket, *shard.receive_batch, GetType(SSUSize::MTUv4));
+#else
   RawSSUPacket* packet = new RawSSUPacket();  // always freed in ensuing handlers
-  m_Socket.async_receive_from(
+  shard.socket.async_receive_from(
       boost::asio::buffer(
           packet->buf,
           GetType(SSUSize::MTUv4)),
@@ -152,13 +311,20 @@ void SSUServer::Receive() {
           this,
           std::placeholders::_1,
           std::placeholders::_2,
+          std::ref(shard),
           packet));
+#endif
 }
 
-void SSUServer::ReceiveV6() {
+void SSUServer::ReceiveV6(
+    SSUServerShard& shard) {
   LOG(debug) << "SSUServer: V6: receiving data";
+#if defined(__linux__)
+  ReceiveBatch(
+      shard, shard.socket_v6, *shard.receive_batch_v6, GetType(SSUSize::MTUv6));
+#else
   RawSSUPacket* packet = new RawSSUPacket();  // always freed in ensuing handlers
-  m_SocketV6.async_receive_from(
+  shard.socket_v6.async_receive_from(
       boost::asio::buffer(
           packet->buf,
           GetType(SSUSize::MTUv6)),
@@ -168,13 +334,105 @@ void SSUServer::ReceiveV6() {
           this,
           std::placeholders::_1,
           std::placeholders::_2,
+          std::ref(shard),
           packet));
+#endif
+}
+
+#if defined(__linux__)
+void SSUServer::ReceiveBatch(
+    SSUServerShard& shard,
+    boost::asio::ip::udp::socket& socket,
+    SSUPacketBatch& batch,
+    std::size_t mtu) {
+  socket.async_receive(
+      boost::asio::null_buffers(),
+      std::bind(
+          &SSUServer::HandleReceiveBatch,
+          this,
+          std::placeholders::_1,
+          std::ref(shard),
+          std::ref(socket),
+          std::ref(batch),
+          mtu));
 }
 
+void SSUServer::HandleReceiveBatch(
+    const boost::system::error_code& ecode,
+    SSUServerShard& shard,
+    boost::asio::ip::udp::socket& socket,
+    SSUPacketBatch& batch,
+    std::size_t mtu) {
+  LOG(debug) << "SSUServer: handling received batch";
+  if (ecode) {
+    LOG(error) << "SSUServer: receive error: " << ecode.message();
+    return;
+  }
+  for (std::size_t i = 0; i < SSU_PACKET_BATCH_SIZE; i++)
+    batch.SetHeader(i, mtu, batch.packets[i].from.capacity());
+  // Everything that is waiting, up to a batch, in one system call
+  const int num = recvmmsg(
+      socket.native_handle(),
+      batch.headers.data(),
+      SSU_PACKET_BATCH_SIZE,
+      MSG_DONTWAIT,
+      nullptr);
+  if (num > 0) {
+    std::vector<RawSSUPacket *> packets;
+    for (int i = 0; i < num; i++) {
+      auto& packet = batch.packets[i];
+      packet.len = batch.headers[i].msg_len;
+      packet.from.resize(batch.headers[i].msg_hdr.msg_namelen);
+      packets.push_back(&packet);
+    }
+    HandleReceivedPackets(shard, packets);
+  } else if (num < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+    LOG(error) << "SSUServer: recvmmsg error: " << std::strerror(errno);
+  }
+  ReceiveBatch(shard, socket, batch, mtu);
+}
+
+void SSUServer::FlushSendBatch(
+    boost::asio::ip::udp::socket& socket,
+    SSUPacketBatch& batch) {
+  for (std::size_t i = 0; i < batch.size; i++)
+    batch.SetHeader(i, batch.packets[i].len, batch.packets[i].from.size());
+  std::size_t num_sent = 0;
+  while (num_sent < batch.size) {
+    const int num = sendmmsg(
+        socket.native_handle(),
+        batch.headers.data() + num_sent,
+        batch.size - num_sent,
+        0);
+    if (num > 0) {
+      num_sent += num;
+    } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      // Socket buffer is full, let the blocking path wait for room
+      for (; num_sent < batch.size; num_sent++) {
+        auto& packet = batch.packets[num_sent];
+        boost::system::error_code ec;
+        socket.send_to(
+            boost::asio::buffer(packet.buf, packet.len), packet.from, 0, ec);
+        if (ec)
+          LOG(error) << "SSUServer: send error: '" << ec.message() << "'";
+      }
+    } else if (errno != EINTR) {
+      // Error belongs to the first unsent datagram, drop it and carry on
+      LOG(error)
+        << "SSUServer: sendmmsg error for " << batch.packets[num_sent].from
+        << ": " << std::strerror(errno);
+      num_sent++;
+    }
+  }
+  batch.size = 0;
+}
+#endif
+
 // coverity[+free : arg-2]
 void SSUServer::HandleReceivedFrom(
     const boost::system::error_code& ecode,
     std::size_t bytes_transferred,
+    SSUServerShard& shard,
     RawSSUPacket* packet) {
   LOG(debug) << "SSUServer: handling received data";
   if (!ecode) {
@@ -182,24 +440,24 @@ void SSUServer::HandleReceivedFrom(
     std::vector<RawSSUPacket *> packets;
     packets.push_back(packet);
     boost::system::error_code ec;
-    std::size_t more_bytes = m_Socket.available(ec);
+    std::size_t more_bytes = shard.socket.available(ec);
     while (more_bytes && packets.size() < 25) {
       packet = new RawSSUPacket();
-      packet->len = m_Socket.receive_from(
+      packet->len = shard.socket.receive_from(
           boost::asio::buffer(
               packet->buf,
               GetType(SSUSize::MTUv4)),
           packet->from);
       packets.push_back(packet);
-      more_bytes = m_Socket.available();
+      more_bytes = shard.socket.available();
     }
-    // packet is freed in ensuing handler
-    m_Service.post(
-        std::bind(
-            &SSUServer::HandleReceivedPackets,
-            this,
-            packets));
-    Receive();
+    shard.service.post(
+        [this, &shard, packets]() {
+          HandleReceivedPackets(shard, packets);
+          for (auto packet : packets)
+            delete packet;  // free received packet
+        });
+    Receive(shard);
   } else {
     LOG(error) << "SSUServer: receive error: " << ecode.message();
     delete packet;  // free packet, now
@@ -210,30 +468,31 @@ void SSUServer::HandleReceivedFrom(
 void SSUServer::HandleReceivedFromV6(
     const boost::system::error_code& ecode,
     std::size_t bytes_transferred,
+    SSUServerShard& shard,
     RawSSUPacket* packet) {
   LOG(debug) << "SSUServer: V6: handling received data";
   if (!ecode) {
     packet->len = bytes_transferred;
     std::vector<RawSSUPacket *> packets;
     packets.push_back(packet);
-    std::size_t more_bytes = m_SocketV6.available();
+    std::size_t more_bytes = shard.socket_v6.available();
     while (more_bytes && packets.size() < 25) {
       packet = new RawSSUPacket();
-      packet->len = m_SocketV6.receive_from(
+      packet->len = shard.socket_v6.receive_from(
           boost::asio::buffer(
               packet->buf,
               GetType(SSUSize::MTUv6)),
           packet->from);
       packets.push_back(packet);
-      more_bytes = m_SocketV6.available();
+      more_bytes = shard.socket_v6.available();
     }
-    // packet is freed in ensuing handler
-    m_Service.post(
-        std::bind(
-            &SSUServer::HandleReceivedPackets,
-            this,
-            packets));
-    ReceiveV6();
+    shard.service.post(
+        [this, &shard, packets]() {
+          HandleReceivedPackets(shard, packets);
+          for (auto packet : packets)
+            delete packet;  // free received packet
+        });
+    ReceiveV6(shard);
   } else {
     LOG(error) << "SSUServer: V6 receive error: " << ecode.message();
     delete packet;  // free packet, now
@@ -241,25 +500,40 @@ void SSUServer::HandleReceivedFromV6(
 }
 
 void SSUServer::HandleReceivedPackets(
-    std::vector<RawSSUPacket *> packets) {
+    SSUServerShard& shard,
+    const std::vector<RawSSUPacket *>& packets) {
   LOG(debug) << "SSUServer: handling received packets";
+#if defined(__linux__)
+  // Replies to the whole batch go out together
+  shard.is_batching_sends = true;
+#endif
   std::shared_ptr<SSUSession> session;
-  for (auto packet : packets) {
-    auto pkt = packet;
+  for (auto pkt : packets) {
     try {
       // we received pkt for other session than previous
       if (!session || session->GetRemoteEndpoint() != pkt->from) {
         if (session)
           session->FlushData();
-        auto session_it = m_Sessions.find(pkt->from);
-        if (session_it != m_Sessions.end())
-          session = session_it->second;
-        if (!session) {
-          session = std::make_shared<SSUSession>(*this, pkt->from);
-          session->WaitForConnect(); {
-            std::unique_lock<std::mutex> l(m_SessionsMutex);
-            m_Sessions[pkt->from] = session;
+        session = nullptr;
+        {
+          std::unique_lock<std::mutex> l(shard.sessions_mutex);
+          auto session_it = shard.sessions.find(pkt->from);
+          if (session_it != shard.sessions.end())
+            session = session_it->second;
+        }
+        if (!session && m_Shards.size() > 1) {
+          // Sessions we initiate are not placed by the kernel, so their
+          // packets may arrive on any shard
+          auto owner = FindSessionShard(pkt->from);
+          if (owner) {
+            ForwardPacket(*owner, *pkt);
+            continue;
           }
+        }
+        if (!session) {
+          session = std::make_shared<SSUSession>(*this, shard.service, pkt->from);
+          session->WaitForConnect();
+          AddSession(shard, session);
           LOG(debug)
             << "SSUServer: created new SSU session from "
             << session->GetRemoteEndpoint();
@@ -272,10 +546,30 @@ void SSUServer::HandleReceivedPackets(
         session->FlushData();
       session = nullptr;
     }
-    delete pkt;  // free received packet
   }
   if (session)
     session->FlushData();
+#if defined(__linux__)
+  shard.is_batching_sends = false;
+  FlushSendBatch(shard.socket, *shard.send_batch);
+  if (shard.send_batch_v6)
+    FlushSendBatch(shard.socket_v6, *shard.send_batch_v6);
+#endif
+}
+
+void SSUServer::ForwardPacket(
+    SSUServerShard& shard,
+    const RawSSUPacket& packet) {
+  LOG(debug) << "SSUServer: forwarding packet from " << packet.from;
+  auto copy = new RawSSUPacket();  // freed by owner shard
+  std::memcpy(copy->buf, packet.buf, packet.len);
+  copy->len = packet.len;
+  copy->from = packet.from;
+  shard.service.post(
+      [this, &shard, copy]() {
+        HandleReceivedPackets(shard, {copy});
+        delete copy;
+      });
 }
 
 std::shared_ptr<SSUSession> SSUServer::FindSession(
@@ -300,11 +594,13 @@ std::shared_ptr<SSUSession> SSUServer::FindSession(
 std::shared_ptr<SSUSession> SSUServer::FindSession(
     const boost::asio::ip::udp::endpoint& ep) const {
   LOG(debug) << "SSUServer: finding session from endpoint";
-  auto it = m_Sessions.find(ep);
-  if (it != m_Sessions.end())
-    return it->second;
-  else
-    return nullptr;
+  for (const auto& shard : m_Shards) {
+    std::unique_lock<std::mutex> l(shard->sessions_mutex);
+    auto it = shard->sessions.find(ep);
+    if (it != shard->sessions.end())
+      return it->second;
+  }
+  return nullptr;
 }
 
 std::shared_ptr<SSUSession> SSUServer::GetSession(
@@ -318,26 +614,28 @@ std::shared_ptr<SSUSession> SSUServer::GetSession(
       boost::asio::ip::udp::endpoint remote_endpoint(
           address->host,
           address->port);
-      auto it = m_Sessions.find(remote_endpoint);
-      if (it != m_Sessions.end()) {
-        session = it->second;
-      } else {
+      session = FindSession(remote_endpoint);
+      if (!session) {
         // otherwise create new session
+        auto& shard = GetNextShard();
         session = std::make_shared<SSUSession>(
             *this,
+            shard.service,
             remote_endpoint,
             router,
-            peer_test); {
-          std::unique_lock<std::mutex> l(m_SessionsMutex);
-          m_Sessions[remote_endpoint] = session;
-        }
+            peer_test);
+        AddSession(shard, session);
         session->SetRemoteIdentHashAbbreviation();
+        // New sessions run on their shard, which may not be ours
         if (!router->UsesIntroducer()) {
           // connect directly
           LOG(debug)
             << "SSUServer: creating new session to"
             << session->GetFormattedSessionInfo();
-          session->Connect();
+          session->GetService().dispatch(
+              std::bind(
+                  &SSUSession::Connect,
+                  session));
         } else {
           // connect through introducer
           auto num_introducers = address->introducers.size();
@@ -347,14 +645,12 @@ std::shared_ptr<SSUSession> SSUServer::GetSession(
             // we might have a session to introducer already
             for (std::size_t i = 0; i < num_introducers; i++) {
               introducer = &(address->introducers[i]);
-              it = m_Sessions.find(
-                       boost::asio::ip::udp::endpoint(
-                           introducer->host,
-                           introducer->port));
-              if (it != m_Sessions.end()) {
-                introducer_session = it->second;
+              introducer_session = FindSession(
+                  boost::asio::ip::udp::endpoint(
+                      introducer->host,
+                      introducer->port));
+              if (introducer_session)
                 break;
-              }
             }
             if (introducer_session) {  // session found
               LOG(debug)
@@ -366,12 +662,13 @@ std::shared_ptr<SSUSession> SSUServer::GetSession(
               boost::asio::ip::udp::endpoint introducerEndpoint(
                   introducer->host,
                   introducer->port);
+              auto& introducer_shard = GetNextShard();
               introducer_session = std::make_shared<SSUSession>(
                   *this,
+                  introducer_shard.service,
                   introducerEndpoint,
                   router);
-              std::unique_lock<std::mutex> l(m_SessionsMutex);
-              m_Sessions[introducerEndpoint] = introducer_session;
+              AddSession(introducer_shard, introducer_session);
             }
             // introduce
             LOG(debug)
@@ -379,19 +676,27 @@ std::shared_ptr<SSUSession> SSUServer::GetSession(
               << "[" << router->GetIdentHashAbbreviation() << "] through introducer "
               << "[" << introducer_session->GetRemoteIdentHashAbbreviation() << "] "
               << introducer->host << ":" << introducer->port;
-            session->WaitForIntroduction();
+            session->GetService().dispatch(
+                std::bind(
+                    &SSUSession::WaitForIntroduction,
+                    session));
             // if we are unreachable
             if (kovri::context.GetRouterInfo().UsesIntroducer()) {
               std::array<std::uint8_t, 1> buf {};
               Send(buf.data(), 0, remote_endpoint);  // send HolePunch
             }
-            introducer_session->Introduce(introducer->tag, introducer->key);
+            const std::uint32_t tag = introducer->tag;
+            const auto key = introducer->key;
+            introducer_session->GetService().dispatch(
+                [introducer_session, tag, key]() {
+                  introducer_session->Introduce(tag, key);
+                });
           } else {
             LOG(warning)
               << "SSUServer: can't connect to unreachable router."
               << "No introducers presented";
-            std::unique_lock<std::mutex> l(m_SessionsMutex);
-            m_Sessions.erase(remote_endpoint);
+            std::unique_lock<std::mutex> l(shard.sessions_mutex);
+            shard.sessions.erase(remote_endpoint);
             session.reset();
           }
         }
@@ -406,22 +711,40 @@ std::shared_ptr<SSUSession> SSUServer::GetSession(
   return session;
 }
 
+std::size_t SSUServer::GetNumSessions() const {
+  std::size_t num_sessions = 0;
+  for (const auto& shard : m_Shards) {
+    std::unique_lock<std::mutex> l(shard->sessions_mutex);
+    num_sessions += shard->sessions.size();
+  }
+  return num_sessions;
+}
+
 void SSUServer::DeleteSession(
     std::shared_ptr<SSUSession> session) {
   LOG(debug) << "SSUServer: deleting session";
   if (session) {
-    session->Close();
-    std::unique_lock<std::mutex> l(m_SessionsMutex);
-    m_Sessions.erase(session->GetRemoteEndpoint());
+    // Closed on its own shard, which runs it inline when that is ours
+    session->GetService().dispatch(
+        std::bind(
+            &SSUSession::Close,
+            session));
+    for (auto& shard : m_Shards) {
+      std::unique_lock<std::mutex> l(shard->sessions_mutex);
+      shard->sessions.erase(session->GetRemoteEndpoint());
+    }
   }
 }
 
 void SSUServer::DeleteAllSessions() {
   LOG(debug) << "SSUServer: deleting all sessions";
-  std::unique_lock<std::mutex> l(m_SessionsMutex);
-  for (auto it : m_Sessions)
-    it.second->Close();
-  m_Sessions.clear();
+  // Shard services are stopped by now, so sessions are closed right here
+  for (auto& shard : m_Shards) {
+    std::unique_lock<std::mutex> l(shard->sessions_mutex);
+    for (auto it : shard->sessions)
+      it.second->Close();
+    shard->sessions.clear();
+  }
 }
 
 template<typename Filter>
@@ -429,9 +752,12 @@ std::shared_ptr<SSUSession> SSUServer::GetRandomSession(
     Filter filter) {
   LOG(debug) << "SSUServer: getting random session";
   std::vector<std::shared_ptr<SSUSession>> filtered_sessions;
-  for (auto session : m_Sessions)
-    if (filter (session.second))
-      filtered_sessions.push_back(session.second);
+  for (auto& shard : m_Shards) {
+    std::unique_lock<std::mutex> l(shard->sessions_mutex);
+    for (auto session : shard->sessions)
+      if (filter (session.second))
+        filtered_sessions.push_back(session.second);
+  }
   if (filtered_sessions.size() > 0) {
     std::size_t s = filtered_sessions.size();
     std::size_t ind = kovri::core::RandInRange32(0, s - 1);
@@ -506,7 +832,10 @@ void SSUServer::HandleIntroducersUpdateTimer(
       if (session &&
           ts < session->GetCreationTime()
              + GetType(SSUDuration::ToIntroducerSessionDuration)) {
-        session->SendKeepAlive();
+        session->GetService().dispatch(
+            std::bind(
+                &SSUSession::SendKeepAlive,
+                session));
         new_list.push_back(introducer);
         num_introducers++;
       } else {
@@ -544,6 +873,7 @@ void SSUServer::NewPeerTest(
     PeerTestParticipant role,
     std::shared_ptr<SSUSession> session) {
   LOG(debug) << "SSUServer: new peer test";
+  std::unique_lock<std::mutex> l(m_RegistryMutex);
   m_PeerTests[nonce] = {
     kovri::core::GetMillisecondsSinceEpoch(),
     role,
@@ -554,6 +884,7 @@ void SSUServer::NewPeerTest(
 PeerTestParticipant SSUServer::GetPeerTestParticipant(
     std::uint32_t nonce) {
   LOG(debug) << "SSUServer: getting PeerTest participant";
+  std::unique_lock<std::mutex> l(m_RegistryMutex);
   auto it = m_PeerTests.find(nonce);
   if (it != m_PeerTests.end())
     return it->second.role;
@@ -564,6 +895,7 @@ PeerTestParticipant SSUServer::GetPeerTestParticipant(
 std::shared_ptr<SSUSession> SSUServer::GetPeerTestSession(
     std::uint32_t nonce) {
   LOG(debug) << "SSUServer: getting PeerTest session";
+  std::unique_lock<std::mutex> l(m_RegistryMutex);
   auto it = m_PeerTests.find(nonce);
   if (it != m_PeerTests.end())
     return it->second.session;
@@ -575,6 +907,7 @@ void SSUServer::UpdatePeerTest(
     std::uint32_t nonce,
     PeerTestParticipant role) {
   LOG(debug) << "SSUServer: updating PeerTest";
+  std::unique_lock<std::mutex> l(m_RegistryMutex);
   auto it = m_PeerTests.find(nonce);
   if (it != m_PeerTests.end())
     it->second.role = role;
@@ -583,6 +916,7 @@ void SSUServer::UpdatePeerTest(
 void SSUServer::RemovePeerTest(
     std::uint32_t nonce) {
   LOG(debug) << "SSUServer: removing PeerTest";
+  std::unique_lock<std::mutex> l(m_RegistryMutex);
   m_PeerTests.erase(nonce);
 }
 
@@ -604,6 +938,7 @@ void SSUServer::HandlePeerTestsCleanupTimer(
   if (ecode != boost::asio::error::operation_aborted) {
     std::size_t num_deleted = 0;
     std::uint64_t ts = kovri::core::GetMillisecondsSinceEpoch();
+    std::unique_lock<std::mutex> l(m_RegistryMutex);
     for (auto it = m_PeerTests.begin(); it != m_PeerTests.end();) {
       if (ts > it->second.creationTime
                + GetType(SSUDuration::PeerTestTimeout)
@@ -35,6 +35,12 @@
 
 #include <boost/asio.hpp>
 
+#if defined(__linux__)
+#include <sys/socket.h>
+#endif
+
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <list>
 #include <map>
@@ -62,6 +68,48 @@ struct RawSSUPacket {
   std::size_t len;
 };
 
+const std::size_t SSU_PACKET_BATCH_SIZE = 32;  // Max datagrams per recvmmsg/sendmmsg
+
+/// @struct SSUPacketBatch
+/// @brief Preallocated packets exchanged with the socket in one system call
+/// @note For sends, 'from' holds the destination
+struct SSUPacketBatch {
+  std::array<RawSSUPacket, SSU_PACKET_BATCH_SIZE> packets;
+  std::size_t size = 0;
+#if defined(__linux__)
+  std::array<mmsghdr, SSU_PACKET_BATCH_SIZE> headers;
+  std::array<iovec, SSU_PACKET_BATCH_SIZE> iovecs;
+
+  /// @brief Points header i at packet i, with given buffer length
+  void SetHeader(
+      std::size_t i,
+      std::size_t len,
+      std::size_t name_len);
+#endif
+};
+
+/// @struct SSUServerShard
+/// @brief Sockets bound to our SSU port, with the sessions of the peers
+///   which the kernel steers to them
+/// @note Sessions are handled on the shard's service only
+struct SSUServerShard {
+  explicit SSUServerShard(
+      boost::asio::io_service& service);
+
+  boost::asio::io_service& service;
+  boost::asio::ip::udp::socket socket, socket_v6;
+
+  mutable std::mutex sessions_mutex;
+  std::map<boost::asio::ip::udp::endpoint, std::shared_ptr<SSUSession>> sessions;
+
+#if defined(__linux__)
+  std::unique_ptr<SSUPacketBatch>
+    receive_batch, receive_batch_v6, send_batch, send_batch_v6;
+  // Set while received packets are handled: sends are queued then flushed
+  bool is_batching_sends;
+#endif
+};
+
 class SSUServer {
  public:
   SSUServer(
@@ -100,6 +148,21 @@ class SSUServer {
     return m_Endpoint;
   }
 
+  /// @return Number of sockets sharing our port, each with its own sessions
+  std::size_t GetNumShards() const {
+    return m_Shards.size();
+  }
+
+  /// @return Local endpoint of the V4 socket of given shard
+  /// @note Differs between shards only when bound to an ephemeral port
+  boost::asio::ip::udp::endpoint GetShardEndpoint(
+      std::size_t shard) const {
+    return m_Shards.at(shard)->socket.local_endpoint();
+  }
+
+  /// @return Number of sessions, across all shards
+  std::size_t GetNumSessions() const;
+
   void Send(
       const uint8_t* buf,
       std::size_t len,
@@ -131,22 +194,74 @@ class SSUServer {
       std::uint32_t nonce);
 
  private:
-  void Receive();
+  /// @brief Runs the service of an additional shard, in its own thread
+  void RunShard(
+      SSUServerShard& shard);
+
+  /// @return Shard of the calling thread, the first one if none
+  SSUServerShard& GetCurrentShard();
 
-  void ReceiveV6();
+  /// @return Shard for a session we initiate, in turn
+  SSUServerShard& GetNextShard();
+
+  /// @return Shard which has a session with given endpoint, if any
+  SSUServerShard* FindSessionShard(
+      const boost::asio::ip::udp::endpoint& ep) const;
+
+  /// @brief Adds session to shard, within the shared registry
+  void AddSession(
+      SSUServerShard& shard,
+      std::shared_ptr<SSUSession> session);
+
+  void Receive(
+      SSUServerShard& shard);
+
+  void ReceiveV6(
+      SSUServerShard& shard);
 
   void HandleReceivedFrom(
       const boost::system::error_code& ecode,
       std::size_t bytes_transferred,
+      SSUServerShard& shard,
       RawSSUPacket* packet);
 
   void HandleReceivedFromV6(
       const boost::system::error_code& ecode,
       std::size_t bytes_transferred,
+      SSUServerShard& shard,
       RawSSUPacket* packet);
 
+  /// @brief Dispatches packets received by shard to their sessions
+  /// @note Does not free packets, and batches sends made by sessions meanwhile
   void HandleReceivedPackets(
-      std::vector<RawSSUPacket *> packets);
+      SSUServerShard& shard,
+      const std::vector<RawSSUPacket *>& packets);
+
+  /// @brief Hands a copy of packet to the shard which owns its session
+  void ForwardPacket(
+      SSUServerShard& shard,
+      const RawSSUPacket& packet);
+
+#if defined(__linux__)
+  /// @brief Waits until socket is readable, then receives with recvmmsg
+  void ReceiveBatch(
+      SSUServerShard& shard,
+      boost::asio::ip::udp::socket& socket,
+      SSUPacketBatch& batch,
+      std::size_t mtu);
+
+  void HandleReceiveBatch(
+      const boost::system::error_code& ecode,
+      SSUServerShard& shard,
+      boost::asio::ip::udp::socket& socket,
+      SSUPacketBatch& batch,
+      std::size_t mtu);
+
+  /// @brief Sends all packets of batch with sendmmsg
+  void FlushSendBatch(
+      boost::asio::ip::udp::socket& socket,
+      SSUPacketBatch& batch);
+#endif
 
   template<typename Filter>
   std::shared_ptr<SSUSession> GetRandomSession(
@@ -175,18 +290,25 @@ class SSUServer {
   boost::asio::io_service& m_Service;
 
   boost::asio::ip::udp::endpoint m_Endpoint, m_EndpointV6;
-  boost::asio::ip::udp::socket m_Socket, m_SocketV6;
+
+  // Services of the shards after the first, which runs on m_Service.
+  // Declared before the shards, so sockets are destroyed first
+  std::vector<std::unique_ptr<boost::asio::io_service>> m_ShardServices;
+  std::vector<std::unique_ptr<boost::asio::io_service::work>> m_ShardWorks;
+  std::vector<std::thread> m_ShardThreads;
+
+  std::vector<std::unique_ptr<SSUServerShard>> m_Shards;
+  std::atomic<std::size_t> m_NextShard;
 
   boost::asio::deadline_timer m_IntroducersUpdateTimer, m_PeerTestsCleanupTimer;
 
-  bool m_IsRunning;
+  std::atomic<bool> m_IsRunning;
 
   // introducers we are connected to
   std::list<boost::asio::ip::udp::endpoint> m_Introducers;
 
-  mutable std::mutex m_SessionsMutex;
-
-  std::map<boost::asio::ip::udp::endpoint, std::shared_ptr<SSUSession>> m_Sessions;
+  // Registry shared by shards, for relays and peer tests across sessions
+  std::mutex m_RegistryMutex;
 
   // we are introducer
   std::map<std::uint32_t, boost::asio::ip::udp::endpoint> m_Relays;
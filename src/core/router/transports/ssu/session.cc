@@ -34,6 +34,7 @@
 
 #include <boost/bind.hpp>
 
+#include <array>
 #include <cstdint>
 #include <vector>
 #include <memory>
@@ -77,11 +78,13 @@ std::uint8_t* SSUSessionPacket::Encrypted() const {
 
 SSUSession::SSUSession(
     SSUServer& server,
+    boost::asio::io_service& service,
     boost::asio::ip::udp::endpoint& remote_endpoint,
     std::shared_ptr<const kovri::core::RouterInfo> router,
     bool peer_test)
     : TransportSession(router),
       m_Server(server),
+      m_Service(service),
       m_RemoteEndpoint(remote_endpoint),
       m_Timer(GetService()),
       m_PeerTest(peer_test),
@@ -97,7 +100,7 @@ SSUSession::SSUSession(
 SSUSession::~SSUSession() {}
 
 boost::asio::io_service& SSUSession::GetService() {
-  return m_Server.GetService();
+  return m_Service;
 }
 
 bool SSUSession::CreateAESandMACKey(
@@ -616,7 +619,11 @@ void SSUSession::ProcessRelayRequest(
       from,
       packet->GetIntroKey(),
       session->GetRemoteEndpoint());
-  SendRelayIntro(session.get(), from);
+  // Charlie's session may run on another server shard
+  session->GetService().dispatch(
+      [session, from]() {
+        session->SendRelayIntro(from);
+      });
 }
 
 void SSUSession::SendRelayRequest(
@@ -789,10 +796,7 @@ void SSUSession::ProcessRelayIntro(SSUPacket* pkt) {
 }
 
 void SSUSession::SendRelayIntro(
-    SSUSession* session,
     const boost::asio::ip::udp::endpoint& from) {
-  if (!session)
-    return;
   // Alice's address always v4
   if (!from.address().is_v4()) {
     LOG(error)
@@ -815,13 +819,13 @@ void SSUSession::SendRelayIntro(
       GetType(SSUPayloadType::RelayIntro),
       buf.data(),
       48,
-      session->m_SessionKey,
+      m_SessionKey,
       iv.data(),
-      session->m_MACKey);
+      m_MACKey);
   m_Server.Send(
       buf.data(),
       48,
-      session->GetRemoteEndpoint());
+      GetRemoteEndpoint());
   LOG(debug) << "SSUSession: " << GetFormattedSessionInfo() << "RelayIntro sent";
 }
 
@@ -910,11 +914,19 @@ void SSUSession::ProcessPeerTest(
         << "PeerTest from Charlie. We are Bob";
       // session with Alice from PeerTest
       auto session = m_Server.GetPeerTestSession(packet->GetNonce());
-      if (session && session->m_State == SessionState::Established)
-        session->Send(  // back to Alice
-            peer_test,
+      if (session && session->m_State == SessionState::Established) {
+        // Alice's session may run on another server shard
+        std::vector<std::uint8_t> data(
             packet->m_RawData,
-            packet->m_RawDataLength);
+            packet->m_RawData + packet->m_RawDataLength);
+        session->GetService().dispatch(
+            [session, peer_test, data]() {
+              session->Send(  // back to Alice
+                  peer_test,
+                  data.data(),
+                  data.size());
+            });
+      }
       m_Server.RemovePeerTest(packet->GetNonce());  // nonce has been used
       break;
     }
@@ -959,12 +971,22 @@ void SSUSession::ProcessPeerTest(
                 packet->GetNonce(),
                 PeerTestParticipant::Bob,
                 shared_from_this());
-            session->SendPeerTest(
-                packet->GetNonce(),
-                sender_endpoint.address().to_v4().to_ulong(),
-                sender_endpoint.port(),
-                packet->GetIntroKey(),
-                false);  // to Charlie with Alice's actual address
+            // Charlie's session may run on another server shard
+            const std::uint32_t nonce = packet->GetNonce();
+            const std::uint32_t address =
+              sender_endpoint.address().to_v4().to_ulong();
+            const std::uint16_t port = sender_endpoint.port();
+            std::array<std::uint8_t, 32> intro_key;
+            memcpy(intro_key.data(), packet->GetIntroKey(), intro_key.size());
+            session->GetService().dispatch(
+                [session, nonce, address, port, intro_key]() {
+                  session->SendPeerTest(
+                      nonce,
+                      address,
+                      port,
+                      intro_key.data(),
+                      false);  // to Charlie with Alice's actual address
+                });
           }
         }
       } else {
@@ -1410,7 +1432,10 @@ void SSUSession::Established() {
   // send delivery status
   m_Data.Send(CreateDeliveryStatusMsg(0));
   // send database store
-  m_Data.Send(CreateDatabaseStoreMsg());
+  auto database_store = CreateDatabaseStoreMsg();
+  if (database_store)
+    m_Data.Send(database_store);
+  m_Data.FlushPacket();
   transports.PeerConnected(shared_from_this());
   if (m_PeerTest && (m_RemoteRouter && m_RemoteRouter->IsPeerTesting()))
     SendPeerTest();
@@ -1473,6 +1498,7 @@ void SSUSession::PostI2NPMessages(
     for (auto it : msgs)
       if (it)
         m_Data.Send(it);
+    m_Data.FlushPacket();
   }
 }
 
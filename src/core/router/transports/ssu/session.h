@@ -33,6 +33,7 @@
 #ifndef SRC_CORE_ROUTER_TRANSPORTS_SSU_SESSION_H_
 #define SRC_CORE_ROUTER_TRANSPORTS_SSU_SESSION_H_
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <ostream>
@@ -121,8 +122,10 @@ class SSUSession
     : public TransportSession,
       public std::enable_shared_from_this<SSUSession> {
  public:
+  /// @param service Service of the server shard which owns this session
   SSUSession(
       SSUServer& server,
+      boost::asio::io_service& service,
       boost::asio::ip::udp::endpoint& remote_endpoint,
       std::shared_ptr<const kovri::core::RouterInfo> router = nullptr,
       bool peer_test = false);
@@ -169,6 +172,11 @@ class SSUSession
     return m_NumReceivedBytes;
   }
 
+  /// @brief Data channel, for its RTT, congestion window and retransmits
+  const SSUData& GetData() const {
+    return m_Data;
+  }
+
   void SendKeepAlive();
 
   std::uint32_t GetRelayTag() const {
@@ -211,9 +219,10 @@ class SSUSession
 
   void FlushData();
 
- private:
+  /// @return Service of the server shard which runs this session
   boost::asio::io_service& GetService();
 
+ private:
   bool CreateAESandMACKey(
       const std::uint8_t* pub_key);
 
@@ -279,8 +288,9 @@ class SSUSession
   void ProcessRelayIntro(
       SSUPacket* pkt);
 
+  /// @brief Introduces Alice to our peer (Charlie), with our session keys
+  /// @note Runs on our own shard, as the keys belong to this session
   void SendRelayIntro(
-      SSUSession* session,
       const boost::asio::ip::udp::endpoint& from);
 
   // Payload type 6: Data
@@ -374,12 +384,15 @@ class SSUSession
   friend class SSUData;  // TODO(unassigned): change in later
   std::string m_RemoteIdentHashAbbreviation;
   SSUServer& m_Server;
+  boost::asio::io_service& m_Service;
   boost::asio::ip::udp::endpoint m_RemoteEndpoint;
   boost::asio::deadline_timer m_Timer;
   bool m_PeerTest;
-  SessionState m_State;
+  // Read by other shards when they pick introducers and relays; setting
+  //  Established publishes the results of the handshake along with it
+  std::atomic<SessionState> m_State;
   bool m_IsSessionKey;
-  std::uint32_t m_RelayTag;
+  std::atomic<std::uint32_t> m_RelayTag;
   SSUData m_Data;
   kovri::core::CBCEncryption m_SessionKeyEncryption;
   kovri::core::CBCDecryption m_SessionKeyDecryption;
@@ -36,6 +36,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "core/router/i2np.h"
 #include "core/router/identity.h"
@@ -81,6 +82,16 @@ class TunnelBase {
       std::shared_ptr<const I2NPMessage> in,
       std::shared_ptr<I2NPMessage> out) = 0;
 
+  /// @brief Applies this tunnel's layer crypto to a batch of messages
+  /// @param in Messages to process
+  /// @param out Output messages, same size as in (may be the same messages)
+  virtual void EncryptTunnelMsgs(
+      const std::vector<std::shared_ptr<const I2NPMessage> >& in,
+      const std::vector<std::shared_ptr<I2NPMessage> >& out) {
+    for (std::size_t i = 0; i < in.size(); i++)
+      EncryptTunnelMsg(in[i], out[i]);
+  }
+
   virtual std::uint32_t GetNextTunnelID() const = 0;
 
   virtual const kovri::core::IdentHash& GetNextIdentHash() const = 0;
@@ -51,10 +51,11 @@ namespace core {
 // TODO(unassigned): refactor all tunnel implementation (applies across entire namespace)
 
 TunnelAESRecordAttributes::TunnelAESRecordAttributes() {
-  RandBytes(layer_key.data(), layer_key.size());
-  RandBytes(IV_key.data(), IV_key.size());
-  RandBytes(reply_key.data(), reply_key.size());
-  RandBytes(reply_IV.data(), reply_IV.size());
+  RandBytes({
+      {layer_key.data(), layer_key.size()},
+      {IV_key.data(), IV_key.size()},
+      {reply_key.data(), reply_key.size()},
+      {reply_IV.data(), reply_IV.size()}});
 }
 
 TunnelHopConfig::TunnelHopConfig(
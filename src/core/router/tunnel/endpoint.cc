@@ -134,7 +134,7 @@ void TunnelEndpoint::HandleDecryptedTunnelDataMsg(
       msg->len = msg->offset + size;
       if (fragment + size < decrypted + TUNNEL_DATA_ENCRYPTED_SIZE) {
         // this is not last message. we have to copy it
-        m.data = ToSharedI2NPMessage(NewI2NPShortMessage());
+        m.data = ToSharedI2NPMessage(NewI2NPMessage(size));
         // reserve room for TunnelGateway header
         m.data->offset += TUNNEL_GATEWAY_HEADER_SIZE;
         m.data->len += TUNNEL_GATEWAY_HEADER_SIZE;
@@ -184,15 +184,11 @@ void TunnelEndpoint::HandleFollowOnFragment(
     auto& msg = it->second;
     if (m.next_fragment_num == msg.next_fragment_num) {
       // check if message is not too long
-      if (msg.data->len + size < I2NP_MAX_MESSAGE_SIZE) {
-        if (msg.data->len + size > msg.data->max_len) {
-          LOG(debug)
-            << "TunnelEndpoint: I2NP message size "
-            << msg.data->max_len << " is not enough";
-          auto new_msg = ToSharedI2NPMessage(NewI2NPMessage());
-          *new_msg = *(msg.data);
-          msg.data = new_msg;
-        }
+      auto grown_data = msg.data->len + size < I2NP_MAX_MESSAGE_SIZE
+        ? GrowI2NPMessage(msg.data, size)
+        : nullptr;
+      if (grown_data) {
+        msg.data = grown_data;
         // concatenate fragment
         memcpy(msg.data->buf + msg.data->len, fragment, size);
         msg.data->len += size;
@@ -259,14 +255,16 @@ void TunnelEndpoint::HandleOutOfSequenceFragment(
         << static_cast<int>(it->second.fragment_num)
         << " of message " << msg_ID << " found";
       auto size = it->second.data->GetLength();
-      if (msg.data->len + size > msg.data->max_len) {
-        LOG(debug)
-          << "TunnelEndpoint: I2NP message size "
-          << msg.data->max_len << " is not enough";
-        auto new_msg = ToSharedI2NPMessage(NewI2NPMessage());
-        *new_msg = *(msg.data);
-        msg.data = new_msg;
+      auto grown_data = GrowI2NPMessage(msg.data, size);
+      if (!grown_data) {
+        LOG(error)
+          << "TunnelEndpoint: out-of-sequence fragment of message " << msg_ID
+          << " exceeds max I2NP message size. Message dropped";
+        m_OutOfSequenceFragments.erase(it);
+        m_IncompleteMessages.erase(msg_ID);  // msg is no longer valid
+        return;
       }
+      msg.data = grown_data;
       memcpy(  // concatenate out-of-sync fragment
           msg.data->buf + msg.data->len,
           it->second.data->GetBuffer(),
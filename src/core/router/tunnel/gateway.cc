@@ -246,8 +246,13 @@ void TunnelGateway::PutTunnelDataMsg(
 void TunnelGateway::SendBuffer() {
   m_Buffer.CompleteCurrentTunnelDataMessage();
   auto tunnel_msgs = m_Buffer.GetTunnelDataMsgs();
+  // encrypted in place, as a batch
+  m_Tunnel->EncryptTunnelMsgs(
+      std::vector<std::shared_ptr<const I2NPMessage> >(
+          tunnel_msgs.begin(),
+          tunnel_msgs.end()),
+      tunnel_msgs);
   for (auto tunnel_msg : tunnel_msgs) {
-    m_Tunnel->EncryptTunnelMsg(tunnel_msg, tunnel_msg);
     tunnel_msg->FillI2NPMessageHeader(I2NPTunnelData);
     m_NumSentBytes += TUNNEL_DATA_MSG_SIZE;
   }
@@ -32,6 +32,7 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <thread>
@@ -213,6 +214,35 @@ void Tunnel::EncryptTunnelMsg(
   }
 }
 
+void Tunnel::EncryptTunnelMsgs(
+    const std::vector<std::shared_ptr<const I2NPMessage> >& in,
+    const std::vector<std::shared_ptr<I2NPMessage> >& out) {
+  // TODO(anonimal): this try block should be handled entirely by caller
+  try {
+    std::vector<const std::uint8_t*> in_payloads;
+    std::vector<std::uint8_t*> out_payloads;
+    in_payloads.reserve(in.size());
+    out_payloads.reserve(out.size());
+    for (std::size_t i = 0; i < in.size(); i++) {
+      in_payloads.push_back(in[i]->GetPayload() + 4);
+      out_payloads.push_back(out[i]->GetPayload() + 4);
+    }
+    TunnelHopConfig* hop = m_Config->GetLastHop();
+    while (hop) {
+      hop->GetDecryption().Decrypt(
+          in_payloads.data(),
+          out_payloads.data(),
+          in_payloads.size());
+      hop = hop->GetPreviousHop();
+      in_payloads.assign(out_payloads.begin(), out_payloads.end());
+    }
+  } catch (...) {
+    m_Exception.Dispatch(__func__);
+    // TODO(anonimal): review if we need to safely break control, ensure exception handling by callers
+    throw;
+  }
+}
+
 void Tunnel::SendTunnelDataMsg(
     std::shared_ptr<kovri::core::I2NPMessage>) {
   // TODO(unassigned): review for missing code
@@ -224,10 +254,22 @@ void InboundTunnel::HandleTunnelDataMsg(
   // incoming messages means a tunnel is alive
   if (IsFailed())
     SetState(e_TunnelStateEstablished);
-  auto new_msg = CreateEmptyTunnelDataMsg();
-  EncryptTunnelMsg(msg, new_msg);
-  new_msg->from = shared_from_this();
-  m_Endpoint.HandleDecryptedTunnelDataMsg(new_msg);
+  m_TunnelDataMsgs.push_back(msg);
+}
+
+void InboundTunnel::FlushTunnelDataMsgs() {
+  if (m_TunnelDataMsgs.empty())
+    return;
+  std::vector<std::shared_ptr<I2NPMessage> > new_msgs;
+  new_msgs.reserve(m_TunnelDataMsgs.size());
+  for (std::size_t i = 0; i < m_TunnelDataMsgs.size(); i++)
+    new_msgs.push_back(CreateEmptyTunnelDataMsg());
+  EncryptTunnelMsgs(m_TunnelDataMsgs, new_msgs);
+  m_TunnelDataMsgs.clear();
+  for (auto& new_msg : new_msgs) {
+    new_msg->from = shared_from_this();
+    m_Endpoint.HandleDecryptedTunnelDataMsg(new_msg);
+  }
 }
 
 void OutboundTunnel::SendTunnelDataMsg(
@@ -273,31 +315,67 @@ Tunnels tunnels;
 Tunnels::Tunnels()
     : m_IsRunning(false),
       m_Thread(nullptr),
+      m_NumWorkers(0),
+      m_BuildQueueLatency(0),
+      m_NumDroppedBuildRequests(0),
+      m_BuildRecordFilter(
+          TUNNEL_BUILD_REPLAY_FILTER_CAPACITY,
+          0.0001,
+          std::chrono::seconds(TUNNEL_BUILD_REPLAY_WINDOW)),
+      m_BuildReplyMsgIDFilter(
+          TUNNEL_BUILD_REPLAY_FILTER_CAPACITY,
+          0.0001,
+          std::chrono::seconds(TUNNEL_BUILD_REPLAY_WINDOW)),
+      m_NumReplayedBuildRequests(0),
       m_NumSuccesiveTunnelCreations(0),
       m_NumFailedTunnelCreations(0) {}
 
-Tunnels::~Tunnels() {
-  for (auto& it : m_TransitTunnels)
-    delete it.second;
-  m_TransitTunnels.clear();
-}
+Tunnels::~Tunnels() {}
 
 std::shared_ptr<InboundTunnel> Tunnels::GetInboundTunnel(
     std::uint32_t tunnel_ID) {
+  std::unique_lock<std::mutex> l(m_InboundTunnelsMutex);
   auto it = m_InboundTunnels.find(tunnel_ID);
   if (it != m_InboundTunnels.end())
     return it->second;
   return nullptr;
 }
 
-TransitTunnel* Tunnels::GetTransitTunnel(
+std::shared_ptr<TransitTunnel> Tunnels::GetTransitTunnel(
     std::uint32_t tunnel_ID) {
+  std::unique_lock<std::mutex> l(m_TransitTunnelsMutex);
   auto it = m_TransitTunnels.find(tunnel_ID);
   if (it != m_TransitTunnels.end())
     return it->second;
   return nullptr;
 }
 
+std::size_t Tunnels::GetNumTransitTunnels() {
+  std::unique_lock<std::mutex> l(m_TransitTunnelsMutex);
+  return m_TransitTunnels.size();
+}
+
+bool Tunnels::IsReplayedBuildRecord(
+    const std::uint8_t* record) {
+  // The ElGamal block is unique per request, whatever its position in the message
+  if (!m_BuildRecordFilter.CheckAndInsert(
+          record + BUILD_REQUEST_RECORD_ENCRYPTED_OFFSET,
+          TUNNEL_BUILD_RECORD_SIZE - BUILD_REQUEST_RECORD_ENCRYPTED_OFFSET))
+    return false;
+  m_NumReplayedBuildRequests++;
+  return true;
+}
+
+bool Tunnels::IsReplayedBuildReplyMsgID(
+    std::uint32_t msg_ID) {
+  if (!m_BuildReplyMsgIDFilter.CheckAndInsert(
+          reinterpret_cast<const std::uint8_t*>(&msg_ID),
+          sizeof(msg_ID)))
+    return false;
+  m_NumReplayedBuildRequests++;
+  return true;
+}
+
 std::shared_ptr<InboundTunnel> Tunnels::GetPendingInboundTunnel(
     std::uint32_t reply_msg_ID) {
   return GetPendingTunnel(
@@ -329,6 +407,7 @@ std::shared_ptr<TTunnel> Tunnels::GetPendingTunnel(
 std::shared_ptr<InboundTunnel> Tunnels::GetNextInboundTunnel() {
   std::shared_ptr<InboundTunnel> tunnel;
   std::size_t min_received = 0;
+  std::unique_lock<std::mutex> l(m_InboundTunnelsMutex);
   for (auto it : m_InboundTunnels) {
     if (!it.second->IsEstablished ())
       continue;
@@ -395,7 +474,7 @@ void Tunnels::StopTunnelPool(
 }
 
 void Tunnels::AddTransitTunnel(
-    TransitTunnel* tunnel) {
+    std::shared_ptr<TransitTunnel> tunnel) {
   std::unique_lock<std::mutex> l(m_TransitTunnelsMutex);
   if (!m_TransitTunnels.insert(
         std::make_pair(
@@ -404,7 +483,6 @@ void Tunnels::AddTransitTunnel(
     LOG(error)
       << "Tunnels: transit tunnel "
       << tunnel->GetTunnelID() << " already exists";
-    delete tunnel;
   }
 }
 
@@ -415,15 +493,47 @@ void Tunnels::Start() {
         std::bind(
           &Tunnels::Run,
           this));
+  // Queues are never destroyed before we are: transports may post at any time
+  std::size_t num_workers =
+    std::max<std::size_t>(1, kovri::context.GetOptionTunnelWorkers());
+  while (m_WorkerQueues.size() < num_workers)
+    m_WorkerQueues.push_back(
+        std::make_unique<kovri::core::MPSCQueue<std::shared_ptr<I2NPMessage> > >());
+  for (std::size_t i = 0; i < num_workers; i++)
+    m_WorkerThreads.push_back(
+        std::make_unique<std::thread>(
+            std::bind(
+              &Tunnels::RunWorker,
+              this,
+              i)));
+  // Until now, all tunnel data was posted to the main queue
+  m_NumWorkers = num_workers;
+  LOG(debug) << "Tunnels: started " << num_workers << " tunnel worker(s)";
+  for (std::size_t i = 0; i < NUM_TUNNEL_BUILD_WORKERS; i++)
+    m_BuildThreads.push_back(
+        std::make_unique<std::thread>(
+            std::bind(
+              &Tunnels::RunBuildWorker,
+              this)));
 }
 
 void Tunnels::Stop() {
   m_IsRunning = false;
+  m_NumWorkers = 0;
   m_Queue.WakeUp();
+  for (auto& queue : m_WorkerQueues)
+    queue->WakeUp();
+  m_BuildQueue.WakeUp();
   if (m_Thread) {
     m_Thread->join();
     m_Thread.reset(nullptr);
   }
+  for (auto& thread : m_WorkerThreads)
+    thread->join();
+  m_WorkerThreads.clear();
+  for (auto& thread : m_BuildThreads)
+    thread->join();
+  m_BuildThreads.clear();
 }
 
 void Tunnels::Run() {
@@ -433,56 +543,8 @@ void Tunnels::Run() {
   while (m_IsRunning) {
     try {
       auto msg = m_Queue.GetNextWithTimeout(1000);  // 1 sec
-      if (msg) {
-        std::uint32_t prev_tunnel_ID = 0,
-                 tunnel_ID = 0;
-        TunnelBase* prev_tunnel = nullptr;
-        do {
-          TunnelBase* tunnel = nullptr;
-          std::uint8_t type_ID = msg->GetTypeID();
-          switch (type_ID) {
-            case I2NPTunnelData:
-            case I2NPTunnelGateway: {
-              tunnel_ID = bufbe32toh(msg->GetPayload());
-              if (tunnel_ID == prev_tunnel_ID)
-                tunnel = prev_tunnel;
-              else if (prev_tunnel)
-                prev_tunnel->FlushTunnelDataMsgs();
-              if (!tunnel && type_ID == I2NPTunnelData)
-                tunnel = GetInboundTunnel(tunnel_ID).get();
-              if (!tunnel)
-                tunnel = GetTransitTunnel(tunnel_ID);
-              if (tunnel) {
-                if (type_ID == I2NPTunnelData)
-                  tunnel->HandleTunnelDataMsg(msg);
-                else  // tunnel gateway assumed
-                  HandleTunnelGatewayMsg(tunnel, msg);
-              } else {
-                LOG(warning) << "Tunnels: tunnel " << tunnel_ID << " not found";
-              }
-              break;
-            }
-            case I2NPVariableTunnelBuild:
-            case I2NPVariableTunnelBuildReply:
-            case I2NPTunnelBuild:
-            case I2NPTunnelBuildReply:
-              HandleI2NPMessage(msg->GetBuffer(), msg->GetLength());
-            break;
-            default:
-              LOG(error)
-                << "Tunnels: unexpected messsage type "
-                << static_cast<int>(type_ID);
-          }
-          msg = m_Queue.Get();
-          if (msg) {
-            prev_tunnel_ID = tunnel_ID;
-            prev_tunnel = tunnel;
-          } else if (tunnel) {
-            tunnel->FlushTunnelDataMsgs();
-          }
-        }
-        while (msg);
-      }
+      if (msg)
+        HandleTunnelMsgs(msg, m_Queue);
       std::uint64_t ts = kovri::core::GetSecondsSinceEpoch();
       if (ts - last_ts >= 15) {  // manage tunnels every 15 seconds
         ManageTunnels();
@@ -494,6 +556,173 @@ void Tunnels::Run() {
   }
 }
 
+void Tunnels::RunWorker(
+    std::size_t index) {
+  // wait for other parts are ready
+  std::this_thread::sleep_for(std::chrono::seconds(1));
+  auto& queue = *m_WorkerQueues.at(index);
+  while (m_IsRunning) {
+    try {
+      auto msg = queue.GetNextWithTimeout(1000);  // 1 sec
+      if (msg)
+        HandleTunnelMsgs(msg, queue);
+    } catch (std::exception& ex) {
+      LOG(error)
+        << "Tunnels: " << __func__ << " " << index
+        << " exception: " << ex.what();
+    }
+  }
+}
+
+void Tunnels::RunBuildWorker() {
+  while (m_IsRunning) {
+    try {
+      auto request = m_BuildQueue.GetNextWithTimeout(1000);  // 1 sec
+      if (!request)
+        continue;
+      // Moving average over about the last 8 requests
+      std::uint64_t latency =
+        kovri::core::GetMillisecondsSinceEpoch() - request->received;
+      std::uint64_t average = m_BuildQueueLatency;
+      while (!m_BuildQueueLatency.compare_exchange_weak(
+                 average,
+                 (average * 7 + latency) / 8)) {}
+      auto& msg = request->msg;
+      if (msg->GetTypeID() == I2NPVariableTunnelBuild)
+        HandleVariableTunnelBuildRequestMsg(msg->GetPayload(), msg->GetSize());
+      else
+        HandleTunnelBuildMsg(msg->GetPayload(), msg->GetSize());
+    } catch (std::exception& ex) {
+      LOG(error) << "Tunnels: " << __func__ << " exception: " << ex.what();
+    }
+  }
+}
+
+bool Tunnels::IsTunnelBuildRequest(
+    const I2NPMessage& msg) {
+  switch (msg.GetTypeID()) {
+    case I2NPTunnelBuild:
+      return true;
+    case I2NPVariableTunnelBuild: {
+      // Unless it completes one of our pending inbound tunnels
+      auto it = m_PendingInboundTunnels.find(msg.GetMsgID());
+      return it == m_PendingInboundTunnels.end()
+          || it->second->GetState() != e_TunnelStatePending;
+    }
+    default:
+      return false;
+  }
+}
+
+void Tunnels::PostTunnelBuildRequest(
+    std::shared_ptr<I2NPMessage> msg) {
+  if (m_BuildQueue.GetSize() >= static_cast<int>(TUNNEL_BUILD_QUEUE_MAX_SIZE)) {
+    // Can't even reject: the reply key is in the encrypted record
+    m_NumDroppedBuildRequests++;
+    LOG(warning)
+      << "Tunnels: build queue is full, dropped build request " << msg->GetMsgID();
+    return;
+  }
+  auto request = std::make_shared<BuildRequest>();
+  request->msg = msg;
+  request->received = kovri::core::GetMillisecondsSinceEpoch();
+  m_BuildQueue.Put(request);
+}
+
+void Tunnels::HandleTunnelMsgs(
+    std::shared_ptr<I2NPMessage> msg,
+    kovri::core::MPSCQueue<std::shared_ptr<I2NPMessage> >& queue) {
+  std::uint32_t prev_tunnel_ID = 0,
+           tunnel_ID = 0;
+  std::shared_ptr<TunnelBase> prev_tunnel;
+  bool prev_is_participant = false;
+  // Participants defer their layer encryption so that tunnel data
+  // of many tunnels is encrypted in one interleaved batch
+  std::vector<std::shared_ptr<TransitTunnelParticipant> > participants;
+  std::size_t num_participant_msgs = 0;
+  auto FlushParticipants = [&participants, &num_participant_msgs]() {
+    if (participants.empty())
+      return;
+    TransitTunnelParticipant::FlushTunnelDataMsgs(participants);
+    participants.clear();
+    num_participant_msgs = 0;
+  };
+  do {
+    std::shared_ptr<TunnelBase> tunnel;
+    bool is_participant = false;
+    std::uint8_t type_ID = msg->GetTypeID();
+    switch (type_ID) {
+      case I2NPTunnelData:
+      case I2NPTunnelGateway: {
+        tunnel_ID = bufbe32toh(msg->GetPayload());
+        if (tunnel_ID == prev_tunnel_ID) {
+          tunnel = prev_tunnel;
+          is_participant = prev_is_participant;
+        } else if (prev_tunnel && !prev_is_participant) {
+          prev_tunnel->FlushTunnelDataMsgs();
+        }
+        if (!tunnel && type_ID == I2NPTunnelData)
+          tunnel = GetInboundTunnel(tunnel_ID);
+        if (!tunnel) {
+          auto transit_tunnel = GetTransitTunnel(tunnel_ID);
+          if (transit_tunnel)
+            is_participant = transit_tunnel->IsParticipant();
+          tunnel = transit_tunnel;
+        }
+        if (tunnel) {
+          if (type_ID == I2NPTunnelData) {
+            tunnel->HandleTunnelDataMsg(msg);
+            if (is_participant) {
+              if (participants.empty() || participants.back() != tunnel)
+                participants.push_back(
+                    std::static_pointer_cast<TransitTunnelParticipant>(tunnel));
+              if (++num_participant_msgs >= TUNNEL_DATA_BATCH_SIZE)
+                FlushParticipants();
+            }
+          } else {  // tunnel gateway assumed
+            HandleTunnelGatewayMsg(tunnel.get(), msg);
+          }
+        } else {
+          LOG(warning) << "Tunnels: tunnel " << tunnel_ID << " not found";
+        }
+        break;
+      }
+      case I2NPVariableTunnelBuild:
+      case I2NPVariableTunnelBuildReply:
+      case I2NPTunnelBuild:
+      case I2NPTunnelBuildReply:
+        // don't leave batched tunnel data behind
+        if (prev_tunnel && !prev_is_participant)
+          prev_tunnel->FlushTunnelDataMsgs();
+        FlushParticipants();
+        if (IsTunnelBuildRequest(*msg))
+          PostTunnelBuildRequest(msg);
+        else
+          HandleI2NPMessage(msg->GetBuffer(), msg->GetLength());
+      break;
+      default:
+        LOG(error)
+          << "Tunnels: unexpected messsage type "
+          << static_cast<int>(type_ID);
+        // prev_tunnel is forgotten below, so flush it now
+        if (prev_tunnel && !prev_is_participant)
+          prev_tunnel->FlushTunnelDataMsgs();
+        FlushParticipants();
+    }
+    msg = queue.Get();
+    if (msg) {
+      prev_tunnel_ID = tunnel_ID;
+      prev_tunnel = tunnel;
+      prev_is_participant = is_participant;
+    } else {
+      if (tunnel && !is_participant)
+        tunnel->FlushTunnelDataMsgs();
+      FlushParticipants();
+    }
+  }
+  while (msg);
+}
+
 void Tunnels::HandleTunnelGatewayMsg(
     TunnelBase* tunnel,
     std::shared_ptr<I2NPMessage> msg) {
@@ -631,6 +860,7 @@ void Tunnels::ManageInboundTunnels() {
         auto pool = tunnel->GetTunnelPool();
         if (pool)
           pool->TunnelExpired(tunnel);
+        std::unique_lock<std::mutex> l(m_InboundTunnelsMutex);
         it = m_InboundTunnels.erase(it);
       } else {
         if (tunnel->IsEstablished()) {
@@ -671,14 +901,13 @@ void Tunnels::ManageInboundTunnels() {
 
 void Tunnels::ManageTransitTunnels() {
   std::uint64_t ts = kovri::core::GetSecondsSinceEpoch();
+  // Build workers add transit tunnels concurrently
+  std::unique_lock<std::mutex> l(m_TransitTunnelsMutex);
   for (auto it = m_TransitTunnels.begin(); it != m_TransitTunnels.end();) {
     if (ts > it->second->GetCreationTime() + TUNNEL_EXPIRATION_TIMEOUT) {
-      auto tmp = it->second;
-      LOG(debug) << "Tunnels: transit tunnel " << tmp->GetTunnelID() << " expired"; {
-        std::unique_lock<std::mutex> l(m_TransitTunnelsMutex);
-        it = m_TransitTunnels.erase(it);
-      }
-      delete tmp;
+      // A worker may still hold the tunnel, it is released with its last reference
+      LOG(debug) << "Tunnels: transit tunnel " << it->second->GetTunnelID() << " expired";
+      it = m_TransitTunnels.erase(it);
     } else {
       it++;
     }
@@ -698,13 +927,36 @@ void Tunnels::ManageTunnelPools() {
 
 void Tunnels::PostTunnelData(
     std::shared_ptr<I2NPMessage> msg) {
-  if (msg)
+  if (!msg)
+    return;
+  std::uint8_t type_ID = msg->GetTypeID();
+  std::size_t num_workers = m_NumWorkers;
+  if (num_workers
+      && (type_ID == I2NPTunnelData || type_ID == I2NPTunnelGateway))
+    // Same tunnel ID always lands on the same worker to preserve ordering
+    m_WorkerQueues[bufbe32toh(msg->GetPayload()) % num_workers]->Put(msg);
+  else
     m_Queue.Put(msg);
 }
 
 void Tunnels::PostTunnelData(
     const std::vector<std::shared_ptr<I2NPMessage> >& msgs) {
-  m_Queue.Put(msgs);
+  std::size_t num_workers = m_NumWorkers;
+  if (!num_workers) {
+    m_Queue.Put(msgs);
+    return;
+  }
+  // Split batch by worker, keeping the batch's order within each worker
+  std::vector<std::vector<std::shared_ptr<I2NPMessage> > > batches(num_workers);
+  for (const auto& msg : msgs) {
+    std::uint8_t type_ID = msg->GetTypeID();
+    if (type_ID == I2NPTunnelData || type_ID == I2NPTunnelGateway)
+      batches[bufbe32toh(msg->GetPayload()) % num_workers].push_back(msg);
+    else
+      m_Queue.Put(msg);
+  }
+  for (std::size_t i = 0; i < num_workers; i++)
+    m_WorkerQueues[i]->Put(batches[i]);
 }
 
 template<class TTunnel>
@@ -742,7 +994,10 @@ void Tunnels::AddOutboundTunnel(
 
 void Tunnels::AddInboundTunnel(
     std::shared_ptr<InboundTunnel> new_tunnel) {
-  m_InboundTunnels[new_tunnel->GetTunnelID()] = new_tunnel;
+  {
+    std::unique_lock<std::mutex> l(m_InboundTunnelsMutex);
+    m_InboundTunnels[new_tunnel->GetTunnelID()] = new_tunnel;
+  }
   auto pool = new_tunnel->GetTunnelPool();
   if (!pool) {
     // build symmetric outbound tunnel
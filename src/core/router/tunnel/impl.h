@@ -33,6 +33,7 @@
 #ifndef SRC_CORE_ROUTER_TUNNEL_IMPL_H_
 #define SRC_CORE_ROUTER_TUNNEL_IMPL_H_
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <list>
@@ -51,6 +52,7 @@
 #include "core/router/tunnel/pool.h"
 #include "core/router/tunnel/transit.h"
 
+#include "core/util/bloom_filter.h"
 #include "core/util/exception.h"
 #include "core/util/queue.h"
 
@@ -63,6 +65,14 @@ const int TUNNEL_EXPIRATION_TIMEOUT = 660,    // 11 minutes
           TUNNEL_CREATION_TIMEOUT = 30,       // 30 seconds
           STANDARD_NUM_RECORDS = 5;           // in VariableTunnelBuild message
 
+const std::size_t TUNNEL_DATA_BATCH_SIZE = 32,          // participant messages encrypted together
+                  NUM_TUNNEL_BUILD_WORKERS = 2,         // threads decrypting build requests
+                  TUNNEL_BUILD_QUEUE_REJECT_SIZE = 64,  // queued requests before we reject
+                  TUNNEL_BUILD_QUEUE_MAX_SIZE = 256,    // queued requests before we drop
+                  TUNNEL_BUILD_REPLAY_FILTER_CAPACITY = 100000;  // build requests per generation
+
+const int TUNNEL_BUILD_REPLAY_WINDOW = 1800;  // 30 minutes, remembered for up to twice as long
+
 enum TunnelState {
   e_TunnelStatePending,
   e_TunnelStateBuildReplyReceived,
@@ -135,6 +145,10 @@ class Tunnel : public TunnelBase {
       std::shared_ptr<const I2NPMessage> in,
       std::shared_ptr<I2NPMessage> out);
 
+  void EncryptTunnelMsgs(
+      const std::vector<std::shared_ptr<const I2NPMessage> >& in,
+      const std::vector<std::shared_ptr<I2NPMessage> >& out);
+
   std::uint32_t GetNextTunnelID() const {
     return m_Config->GetFirstHop()->GetTunnelID();
   }
@@ -201,9 +215,12 @@ class InboundTunnel
       : Tunnel(config),
         m_Endpoint(true) {}
 
+  /// @brief Queues message until flush so that it can be decrypted in a batch
   void HandleTunnelDataMsg(
       std::shared_ptr<const I2NPMessage> msg);
 
+  void FlushTunnelDataMsgs();
+
   std::size_t GetNumReceivedBytes() const {
     return m_Endpoint.GetNumReceivedBytes();
   }
@@ -215,6 +232,7 @@ class InboundTunnel
 
  private:
   TunnelEndpoint m_Endpoint;
+  std::vector<std::shared_ptr<const I2NPMessage> > m_TunnelDataMsgs;
 };
 
 
@@ -242,13 +260,15 @@ class Tunnels {
     return m_ExploratoryPool;
   }
 
-  TransitTunnel* GetTransitTunnel(
+  std::shared_ptr<TransitTunnel> GetTransitTunnel(
       std::uint32_t tunnel_ID);
 
+  std::size_t GetNumTransitTunnels();
+
   std::uint64_t GetTransitTunnelsExpirationTimeout();
 
   void AddTransitTunnel(
-      TransitTunnel* tunnel);
+      std::shared_ptr<TransitTunnel> tunnel);
 
   void AddOutboundTunnel(
       std::shared_ptr<OutboundTunnel> new_tunnel);
@@ -262,6 +282,23 @@ class Tunnels {
   void PostTunnelData(
       const std::vector<std::shared_ptr<I2NPMessage> >& msgs);
 
+  /// @return True if so many build requests wait for a crypto worker that
+  ///   new transit tunnels should be rejected
+  bool IsBuildQueueOverloaded() {
+    return m_BuildQueue.GetSize() >= static_cast<int>(TUNNEL_BUILD_QUEUE_REJECT_SIZE);
+  }
+
+  /// @brief Remembers a build request record, before its ElGamal decryption
+  /// @param record Encrypted record addressed to us
+  /// @return True if the record was seen before, i.e., the request is a replay
+  bool IsReplayedBuildRecord(
+      const std::uint8_t* record);
+
+  /// @brief Remembers the message ID a build request asks us to send its reply with
+  /// @return True if the ID was seen before, i.e., the request is a replay
+  bool IsReplayedBuildReplyMsgID(
+      std::uint32_t msg_ID);
+
   template<class TTunnel>
   std::shared_ptr<TTunnel> CreateTunnel(
       std::shared_ptr<TunnelConfig> config,
@@ -298,8 +335,34 @@ class Tunnels {
       TunnelBase* tunnel,
       std::shared_ptr<I2NPMessage> msg);
 
+  /// @brief Handles given message and drains all messages that follow it
+  /// @details Consecutive tunnel data for the same tunnel is flushed as a batch
+  /// @param msg First message, as taken from the queue
+  /// @param queue Queue to drain
+  void HandleTunnelMsgs(
+      std::shared_ptr<I2NPMessage> msg,
+      kovri::core::MPSCQueue<std::shared_ptr<I2NPMessage> >& queue);
+
+  /// @return True if message is a build request from another router,
+  ///   as opposed to a build reply for one of our own tunnels
+  bool IsTunnelBuildRequest(
+      const I2NPMessage& msg);
+
+  /// @brief Queues a build request for the crypto workers, drops it if they are too far behind
+  void PostTunnelBuildRequest(
+      std::shared_ptr<I2NPMessage> msg);
+
+  /// @brief Manages tunnels and processes build replies
   void Run();
 
+  /// @brief Processes build requests, the ElGamal decryption of which is expensive
+  void RunBuildWorker();
+
+  /// @brief Processes tunnel data for the tunnel IDs owned by given worker
+  /// @param index Index of worker
+  void RunWorker(
+      std::size_t index);
+
   void ManageTunnels();
 
   void ManageOutboundTunnels();
@@ -319,22 +382,42 @@ class Tunnels {
   void CreateZeroHopsInboundTunnel();
 
  private:
-  bool m_IsRunning;
+  std::atomic<bool> m_IsRunning;
   std::unique_ptr<std::thread> m_Thread;
 
+  // Tunnel data workers, one queue per worker thread
+  std::atomic<std::size_t> m_NumWorkers;
+  std::vector<std::unique_ptr<kovri::core::MPSCQueue<std::shared_ptr<I2NPMessage> > > > m_WorkerQueues;
+  std::vector<std::unique_ptr<std::thread> > m_WorkerThreads;
+
+  /// @brief Build request waiting for a crypto worker
+  struct BuildRequest {
+    std::shared_ptr<I2NPMessage> msg;
+    std::uint64_t received;  // in milliseconds
+  };
+  kovri::core::Queue<std::shared_ptr<BuildRequest> > m_BuildQueue;  // several consumers
+  std::vector<std::unique_ptr<std::thread> > m_BuildThreads;
+  std::atomic<std::uint64_t> m_BuildQueueLatency;  // moving average, in milliseconds
+  std::atomic<std::size_t> m_NumDroppedBuildRequests;
+
+  // Replay detection for build requests
+  kovri::core::RotatingBloomFilter m_BuildRecordFilter, m_BuildReplyMsgIDFilter;
+  std::atomic<std::size_t> m_NumReplayedBuildRequests;
+
   // by reply_msg_ID
   std::map<std::uint32_t, std::shared_ptr<InboundTunnel> > m_PendingInboundTunnels;
   // by reply_msg_ID
   std::map<std::uint32_t, std::shared_ptr<OutboundTunnel> > m_PendingOutboundTunnels;
 
+  std::mutex m_InboundTunnelsMutex;
   std::map<std::uint32_t, std::shared_ptr<InboundTunnel> > m_InboundTunnels;
   std::list<std::shared_ptr<OutboundTunnel> > m_OutboundTunnels;
   std::mutex m_TransitTunnelsMutex;
-  std::map<std::uint32_t, TransitTunnel *> m_TransitTunnels;
+  std::map<std::uint32_t, std::shared_ptr<TransitTunnel> > m_TransitTunnels;
   std::mutex m_PoolsMutex;
   std::list<std::shared_ptr<TunnelPool>> m_Pools;
   std::shared_ptr<TunnelPool> m_ExploratoryPool;
-  kovri::core::Queue<std::shared_ptr<I2NPMessage> > m_Queue;
+  kovri::core::MPSCQueue<std::shared_ptr<I2NPMessage> > m_Queue;
 
   // some stats
   int m_NumSuccesiveTunnelCreations,
@@ -354,8 +437,44 @@ class Tunnels {
     return m_TransitTunnels;
   }
 
+  /// @return Number of messages waiting in all queues
   int GetQueueSize() {
-    return m_Queue.GetSize();
+    int size = m_Queue.GetSize();
+    for (std::size_t i = 0; i < m_NumWorkers; i++)
+      size += m_WorkerQueues[i]->GetSize();
+    return size;
+  }
+
+  /// @return Number of messages waiting in given worker's queue
+  /// @param worker Index of worker
+  int GetQueueSize(
+      std::size_t worker) {
+    return worker < m_NumWorkers ? m_WorkerQueues[worker]->GetSize() : 0;
+  }
+
+  /// @return Number of tunnel data worker threads
+  std::size_t GetNumWorkers() const {
+    return m_NumWorkers;
+  }
+
+  /// @return Number of build requests waiting for a crypto worker
+  int GetBuildQueueSize() {
+    return m_BuildQueue.GetSize();
+  }
+
+  /// @return Average time build requests wait for a crypto worker, in milliseconds
+  std::uint64_t GetBuildQueueLatency() const {
+    return m_BuildQueueLatency;
+  }
+
+  /// @return Number of build requests dropped because the build queue was full
+  std::size_t GetNumDroppedBuildRequests() const {
+    return m_NumDroppedBuildRequests;
+  }
+
+  /// @return Number of build requests dropped as replays
+  std::size_t GetNumReplayedBuildRequests() const {
+    return m_NumReplayedBuildRequests;
   }
 
   int GetTunnelCreationSuccessRate() const {  // in percents
@@ -77,19 +77,99 @@ void TransitTunnel::EncryptTunnelMsg(
   }
 }
 
+void TransitTunnel::EncryptTunnelMsgs(
+    const std::vector<std::shared_ptr<const I2NPMessage> >& in,
+    const std::vector<std::shared_ptr<I2NPMessage> >& out) {
+  // TODO(anonimal): this try block should be handled entirely by caller
+  try {
+    std::vector<kovri::core::TunnelEncryption*> encryptions(in.size(), &m_Encryption);
+    std::vector<const std::uint8_t*> in_payloads;
+    std::vector<std::uint8_t*> out_payloads;
+    in_payloads.reserve(in.size());
+    out_payloads.reserve(out.size());
+    for (std::size_t i = 0; i < in.size(); i++) {
+      in_payloads.push_back(in[i]->GetPayload() + 4);
+      out_payloads.push_back(out[i]->GetPayload() + 4);
+    }
+    kovri::core::TunnelEncryption::Encrypt(
+        encryptions.data(),
+        in_payloads.data(),
+        out_payloads.data(),
+        in_payloads.size());
+  } catch (...) {
+    m_Exception.Dispatch(__func__);
+    // TODO(anonimal): review if we need to safely break control, ensure exception handling by callers
+    throw;
+  }
+}
+
 TransitTunnelParticipant::~TransitTunnelParticipant() {}
 
 void TransitTunnelParticipant::HandleTunnelDataMsg(
     std::shared_ptr<const kovri::core::I2NPMessage> tunnel_msg) {
-  auto new_msg = CreateEmptyTunnelDataMsg();
-  EncryptTunnelMsg(tunnel_msg, new_msg);
   m_NumTransmittedBytes += tunnel_msg->GetLength();
-  htobe32buf(new_msg->GetPayload(), GetNextTunnelID());
-  new_msg->FillI2NPMessageHeader(I2NPTunnelData);
-  m_TunnelDataMsgs.push_back(new_msg);
+  m_PendingMsgs.push_back(tunnel_msg);
 }
 
 void TransitTunnelParticipant::FlushTunnelDataMsgs() {
+  TransitTunnelParticipant* participant = this;
+  EncryptTunnelDataMsgs(&participant, 1);
+  SendTunnelDataMsgs();
+}
+
+void TransitTunnelParticipant::FlushTunnelDataMsgs(
+    const std::vector<std::shared_ptr<TransitTunnelParticipant> >& participants) {
+  std::vector<TransitTunnelParticipant*> ptrs;
+  ptrs.reserve(participants.size());
+  for (const auto& participant : participants)
+    ptrs.push_back(participant.get());
+  EncryptTunnelDataMsgs(ptrs.data(), ptrs.size());
+  for (auto participant : ptrs)
+    participant->SendTunnelDataMsgs();
+}
+
+void TransitTunnelParticipant::EncryptTunnelDataMsgs(
+    TransitTunnelParticipant* const* participants,
+    std::size_t num) {
+  std::vector<TransitTunnelParticipant*> owners;
+  std::vector<kovri::core::TunnelEncryption*> encryptions;
+  std::vector<std::shared_ptr<const I2NPMessage> > in_msgs;
+  std::vector<std::shared_ptr<I2NPMessage> > out_msgs;
+  for (std::size_t i = 0; i < num; i++) {
+    auto participant = participants[i];
+    // A participant may be listed more than once, its queue is taken only once
+    for (auto& msg : participant->m_PendingMsgs) {
+      owners.push_back(participant);
+      encryptions.push_back(&participant->GetEncryption());
+      in_msgs.push_back(std::move(msg));
+      out_msgs.push_back(CreateEmptyTunnelDataMsg());
+    }
+    participant->m_PendingMsgs.clear();
+  }
+  if (in_msgs.empty())
+    return;
+  std::vector<const std::uint8_t*> in_payloads;
+  std::vector<std::uint8_t*> out_payloads;
+  in_payloads.reserve(in_msgs.size());
+  out_payloads.reserve(out_msgs.size());
+  for (std::size_t i = 0; i < in_msgs.size(); i++) {
+    in_payloads.push_back(in_msgs[i]->GetPayload() + 4);
+    out_payloads.push_back(out_msgs[i]->GetPayload() + 4);
+  }
+  kovri::core::TunnelEncryption::Encrypt(
+      encryptions.data(),
+      in_payloads.data(),
+      out_payloads.data(),
+      in_payloads.size());
+  for (std::size_t i = 0; i < out_msgs.size(); i++) {
+    auto& new_msg = out_msgs[i];
+    htobe32buf(new_msg->GetPayload(), owners[i]->GetNextTunnelID());
+    new_msg->FillI2NPMessageHeader(I2NPTunnelData);
+    owners[i]->m_TunnelDataMsgs.push_back(new_msg);
+  }
+}
+
+void TransitTunnelParticipant::SendTunnelDataMsgs() {
   if (!m_TunnelDataMsgs.empty()) {
     auto num = m_TunnelDataMsgs.size();
     if (num > 1)
@@ -138,7 +218,7 @@ void TransitTunnelEndpoint::HandleTunnelDataMsg(
   m_Endpoint.HandleDecryptedTunnelDataMsg(new_msg);
 }
 
-TransitTunnel* CreateTransitTunnel(
+std::shared_ptr<TransitTunnel> CreateTransitTunnel(
     std::uint32_t receive_tunnel_ID,
     const std::uint8_t* next_ident,
     std::uint32_t next_tunnel_ID,
@@ -148,7 +228,7 @@ TransitTunnel* CreateTransitTunnel(
     bool is_endpoint) {
   if (is_endpoint) {
     LOG(debug) << "TransitTunnel: endpoint " << receive_tunnel_ID << " created";
-    return new TransitTunnelEndpoint(
+    return std::make_shared<TransitTunnelEndpoint>(
         receive_tunnel_ID,
         next_ident,
         next_tunnel_ID,
@@ -156,7 +236,7 @@ TransitTunnel* CreateTransitTunnel(
         iv_key);
   } else if (is_gateway) {
     LOG(debug) << "TransitTunnel: gateway: " << receive_tunnel_ID << " created";
-    return new TransitTunnelGateway(
+    return std::make_shared<TransitTunnelGateway>(
         receive_tunnel_ID,
         next_ident,
         next_tunnel_ID,
@@ -165,7 +245,7 @@ TransitTunnel* CreateTransitTunnel(
   } else {
     LOG(debug)
       << "TransitTunnel: " << receive_tunnel_ID << "->" << next_tunnel_ID << " created";
-    return new TransitTunnelParticipant(
+    return std::make_shared<TransitTunnelParticipant>(
         receive_tunnel_ID,
         next_ident,
         next_tunnel_ID,
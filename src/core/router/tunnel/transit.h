@@ -79,6 +79,15 @@ class TransitTunnel : public TunnelBase {
       std::shared_ptr<const I2NPMessage> in,
       std::shared_ptr<I2NPMessage> out);
 
+  void EncryptTunnelMsgs(
+      const std::vector<std::shared_ptr<const I2NPMessage> >& in,
+      const std::vector<std::shared_ptr<I2NPMessage> >& out);
+
+  /// @return True if tunnel data is only re-encrypted and forwarded to the next hop
+  virtual bool IsParticipant() const {
+    return false;
+  }
+
   std::uint32_t GetNextTunnelID() const {
     return m_NextTunnelID;
   }
@@ -87,6 +96,11 @@ class TransitTunnel : public TunnelBase {
     return m_NextIdent;
   }
 
+ protected:
+  kovri::core::TunnelEncryption& GetEncryption() {
+    return m_Encryption;
+  }
+
  private:
   std::uint32_t m_TunnelID,
            m_NextTunnelID;
@@ -116,13 +130,32 @@ class TransitTunnelParticipant : public TransitTunnel {
     return m_NumTransmittedBytes;
   }
 
+  bool IsParticipant() const {
+    return true;
+  }
+
+  /// @brief Queues tunnel data, encryption is deferred until flush
   void HandleTunnelDataMsg(
       std::shared_ptr<const kovri::core::I2NPMessage> tunnel_msg);
 
   void FlushTunnelDataMsgs();
 
+  /// @brief Encrypts queued tunnel data of many participants in one batch and sends it
+  /// @details Messages of different tunnels are independent, so their layer
+  ///   encryption is interleaved through the AES pipeline
+  static void FlushTunnelDataMsgs(
+      const std::vector<std::shared_ptr<TransitTunnelParticipant> >& participants);
+
  private:
+  /// @brief Encrypts queued tunnel data and moves it to outgoing messages
+  static void EncryptTunnelDataMsgs(
+      TransitTunnelParticipant* const* participants,
+      std::size_t num);
+
+  void SendTunnelDataMsgs();
+
   std::size_t m_NumTransmittedBytes;
+  std::vector<std::shared_ptr<const kovri::core::I2NPMessage> > m_PendingMsgs;
   std::vector<std::shared_ptr<kovri::core::I2NPMessage> > m_TunnelDataMsgs;
 };
 
@@ -183,7 +216,7 @@ class TransitTunnelEndpoint : public TransitTunnel {
   TunnelEndpoint m_Endpoint;
 };
 
-TransitTunnel* CreateTransitTunnel(
+std::shared_ptr<TransitTunnel> CreateTransitTunnel(
     std::uint32_t receive_tunnel_ID,
     const std::uint8_t* next_ident,
     std::uint32_t next_tunnel_ID,
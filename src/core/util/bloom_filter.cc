@@ -0,0 +1,206 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#include "core/util/bloom_filter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/crypto/rand.h"
+
+#include "core/util/i2p_endian.h"
+
+namespace kovri {
+namespace core {
+
+namespace {
+
+inline std::uint64_t RotateLeft(
+    std::uint64_t x,
+    int b) {
+  return (x << b) | (x >> (64 - b));
+}
+
+inline void SipRound(
+    std::uint64_t& v0,
+    std::uint64_t& v1,
+    std::uint64_t& v2,
+    std::uint64_t& v3) {
+  v0 += v1; v1 = RotateLeft(v1, 13); v1 ^= v0; v0 = RotateLeft(v0, 32);
+  v2 += v3; v3 = RotateLeft(v3, 16); v3 ^= v2;
+  v0 += v3; v3 = RotateLeft(v3, 21); v3 ^= v0;
+  v2 += v1; v1 = RotateLeft(v1, 17); v1 ^= v2; v2 = RotateLeft(v2, 32);
+}
+
+/// @brief SipHash-2-4
+std::uint64_t SipHash(
+    const std::uint64_t* key,
+    const std::uint8_t* data,
+    std::size_t len) {
+  std::uint64_t v0 = key[0] ^ 0x736f6d6570736575ULL,
+                v1 = key[1] ^ 0x646f72616e646f6dULL,
+                v2 = key[0] ^ 0x6c7967656e657261ULL,
+                v3 = key[1] ^ 0x7465646279746573ULL;
+  const std::uint8_t* end = data + (len & ~std::size_t(7));
+  for (; data != end; data += 8) {
+    std::uint64_t m = le64toh(buf64toh(data));
+    v3 ^= m;
+    SipRound(v0, v1, v2, v3);
+    SipRound(v0, v1, v2, v3);
+    v0 ^= m;
+  }
+  std::uint64_t b = static_cast<std::uint64_t>(len) << 56;
+  for (std::size_t i = 0; i < (len & 7); i++)
+    b |= static_cast<std::uint64_t>(data[i]) << (8 * i);
+  v3 ^= b;
+  SipRound(v0, v1, v2, v3);
+  SipRound(v0, v1, v2, v3);
+  v0 ^= b;
+  v2 ^= 0xff;
+  for (int i = 0; i < 4; i++)
+    SipRound(v0, v1, v2, v3);
+  return v0 ^ v1 ^ v2 ^ v3;
+}
+
+}  // namespace
+
+RotatingBloomFilter::RotatingBloomFilter(
+    std::size_t capacity,
+    double false_positive_rate,
+    std::chrono::seconds period)
+    : m_Capacity(std::max<std::size_t>(capacity, 1)),
+      m_Period(period),
+      m_NumCurrent(0),
+      m_RotationTime(std::chrono::steady_clock::now()) {
+  // Optimal sizing: m = -n ln(p) / ln(2)^2 bits and k = m / n ln(2) hashes
+  const double ln2 = std::log(2.0);
+  auto bits = std::ceil(
+      -static_cast<double>(m_Capacity) * std::log(false_positive_rate)
+      / (ln2 * ln2));
+  m_NumBits = (static_cast<std::size_t>(bits) + 63) & ~std::size_t(63);
+  m_NumHashes = std::min<std::size_t>(
+      std::max<long>(std::lround(bits / m_Capacity * ln2), 1), 32);
+  m_Current.resize(m_NumBits / 64);
+  m_Previous.resize(m_NumBits / 64);
+  kovri::core::RandBytes(
+      reinterpret_cast<std::uint8_t*>(m_Key),
+      sizeof(m_Key));
+}
+
+bool RotatingBloomFilter::CheckAndInsert(
+    const std::uint8_t* data,
+    std::size_t len) {
+  std::uint32_t h1, h2;
+  Hash(data, len, h1, h2);
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  RotateIfExpired();
+  if (Test(m_Current, h1, h2) || Test(m_Previous, h1, h2))
+    return true;
+  Set(m_Current, h1, h2);
+  m_NumCurrent++;
+  return false;
+}
+
+bool RotatingBloomFilter::Contains(
+    const std::uint8_t* data,
+    std::size_t len) {
+  std::uint32_t h1, h2;
+  Hash(data, len, h1, h2);
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  RotateIfExpired();
+  return Test(m_Current, h1, h2) || Test(m_Previous, h1, h2);
+}
+
+void RotatingBloomFilter::Rotate() {
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Previous.swap(m_Current);
+  std::fill(m_Current.begin(), m_Current.end(), 0);
+  m_NumCurrent = 0;
+  m_RotationTime = std::chrono::steady_clock::now();
+}
+
+void RotatingBloomFilter::Clear() {
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  std::fill(m_Current.begin(), m_Current.end(), 0);
+  std::fill(m_Previous.begin(), m_Previous.end(), 0);
+  m_NumCurrent = 0;
+  m_RotationTime = std::chrono::steady_clock::now();
+}
+
+void RotatingBloomFilter::RotateIfExpired() {
+  auto now = std::chrono::steady_clock::now();
+  if (now - m_RotationTime < m_Period && m_NumCurrent < m_Capacity)
+    return;
+  // More than one period passed: the previous generation is stale too
+  if (now - m_RotationTime >= 2 * m_Period)
+    std::fill(m_Current.begin(), m_Current.end(), 0);
+  m_Previous.swap(m_Current);
+  std::fill(m_Current.begin(), m_Current.end(), 0);
+  m_NumCurrent = 0;
+  m_RotationTime = now;
+}
+
+void RotatingBloomFilter::Hash(
+    const std::uint8_t* data,
+    std::size_t len,
+    std::uint32_t& h1,
+    std::uint32_t& h2) const {
+  auto hash = SipHash(m_Key, data, len);
+  h1 = static_cast<std::uint32_t>(hash);
+  h2 = static_cast<std::uint32_t>(hash >> 32) | 1;  // Odd, never a zero stride
+}
+
+bool RotatingBloomFilter::Test(
+    const std::vector<std::uint64_t>& bits,
+    std::uint32_t h1,
+    std::uint32_t h2) const {
+  std::uint64_t index = h1;
+  for (std::size_t i = 0; i < m_NumHashes; i++, index += h2) {
+    auto bit = index % m_NumBits;
+    if (!(bits[bit / 64] & (std::uint64_t(1) << (bit % 64))))
+      return false;
+  }
+  return true;
+}
+
+void RotatingBloomFilter::Set(
+    std::vector<std::uint64_t>& bits,
+    std::uint32_t h1,
+    std::uint32_t h2) {
+  std::uint64_t index = h1;
+  for (std::size_t i = 0; i < m_NumHashes; i++, index += h2) {
+    auto bit = index % m_NumBits;
+    bits[bit / 64] |= std::uint64_t(1) << (bit % 64);
+  }
+}
+
+}  // namespace core
+}  // namespace kovri
@@ -0,0 +1,125 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#ifndef SRC_CORE_UTIL_BLOOM_FILTER_H_
+#define SRC_CORE_UTIL_BLOOM_FILTER_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace kovri {
+namespace core {
+
+/// @class RotatingBloomFilter
+/// @brief Time-decayed set membership for replay detection
+/// @details Entries are added to the current generation while lookups check
+///   both the current and the previous one. Generations rotate once per period,
+///   or earlier when the current one holds its capacity, so an entry is
+///   remembered for at least one and at most two periods and the false
+///   positive rate stays bounded under floods.
+/// @details Indexes come from a SipHash keyed with a random per-filter key,
+///   so that peers cannot precompute colliding inputs.
+/// @note Thread-safe
+class RotatingBloomFilter {
+ public:
+  /// @param capacity Expected number of entries per generation
+  /// @param false_positive_rate Target false positive rate at capacity
+  /// @param period Lifetime of a generation
+  RotatingBloomFilter(
+      std::size_t capacity,
+      double false_positive_rate,
+      std::chrono::seconds period);
+
+  /// @brief Atomically tests for and adds an entry
+  /// @return True if the entry was (probably) already present
+  bool CheckAndInsert(
+      const std::uint8_t* data,
+      std::size_t len);
+
+  /// @return True if the entry is (probably) present
+  bool Contains(
+      const std::uint8_t* data,
+      std::size_t len);
+
+  /// @brief Starts a new generation, forgetting the oldest one
+  void Rotate();
+
+  /// @brief Forgets all entries
+  void Clear();
+
+  /// @return Number of bits in each generation
+  std::size_t GetNumBits() const {
+    return m_NumBits;
+  }
+
+  /// @return Number of hash functions
+  std::size_t GetNumHashes() const {
+    return m_NumHashes;
+  }
+
+ private:
+  /// @brief Rotates generations if the current one expired or is full
+  void RotateIfExpired();
+
+  /// @brief Computes the double hashing seeds for data
+  void Hash(
+      const std::uint8_t* data,
+      std::size_t len,
+      std::uint32_t& h1,
+      std::uint32_t& h2) const;
+
+  bool Test(
+      const std::vector<std::uint64_t>& bits,
+      std::uint32_t h1,
+      std::uint32_t h2) const;
+
+  void Set(
+      std::vector<std::uint64_t>& bits,
+      std::uint32_t h1,
+      std::uint32_t h2);
+
+ private:
+  std::size_t m_Capacity, m_NumBits, m_NumHashes;
+  std::chrono::seconds m_Period;
+  std::uint64_t m_Key[2];
+  std::mutex m_Mutex;
+  std::vector<std::uint64_t> m_Current, m_Previous;
+  std::size_t m_NumCurrent;  // Entries added to the current generation
+  std::chrono::steady_clock::time_point m_RotationTime;
+};
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_UTIL_BLOOM_FILTER_H_
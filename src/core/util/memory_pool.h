@@ -0,0 +1,196 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#ifndef SRC_CORE_UTIL_MEMORY_POOL_H_
+#define SRC_CORE_UTIL_MEMORY_POOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace kovri {
+namespace core {
+
+/// @class MemoryPool
+/// @brief Recycles fixed size blocks instead of returning them to the heap
+/// @details Every thread keeps a small cache of free blocks so that the
+///   common allocate/free path takes no lock. Caches spill to, and refill
+///   from, a shared free list. Both are bounded so that an idle pool never
+///   holds more than a few MB.
+/// @tparam BlockSize Size of each block in bytes
+template <std::size_t BlockSize>
+class MemoryPool {
+ public:
+  /// @return The pool for this block size
+  /// @note Never destroyed, blocks may be freed by other static objects at exit
+  static MemoryPool& Instance() {
+    static MemoryPool* pool = new MemoryPool();
+    return *pool;
+  }
+
+  /// @return A block of BlockSize bytes
+  void* Allocate() {
+    void* block = nullptr;
+    auto cache = GetLocalCache();
+    if (cache && cache->empty()) {
+      std::unique_lock<std::mutex> l(m_FreeBlocksMutex);
+      auto num = std::min(m_FreeBlocks.size(), LocalCapacity / 2 + 1);
+      cache->insert(
+          cache->end(),
+          m_FreeBlocks.end() - num,
+          m_FreeBlocks.end());
+      m_FreeBlocks.resize(m_FreeBlocks.size() - num);
+    }
+    if (cache && !cache->empty()) {
+      block = cache->back();
+      cache->pop_back();
+    } else if (!cache) {
+      block = Acquire();
+    }
+    if (block) {
+      m_Hits++;
+    } else {
+      block = ::operator new(BlockSize);
+      m_Misses++;
+    }
+    UpdateHighWaterMark(++m_InUse);
+    return block;
+  }
+
+  /// @brief Returns a block obtained from Allocate() to the pool
+  void Free(
+      void* block) {
+    if (!block)
+      return;
+    m_InUse--;
+    auto cache = GetLocalCache();
+    if (cache && cache->size() < LocalCapacity) {
+      cache->push_back(block);
+      return;
+    }
+    Release(block);
+  }
+
+  /// @return Number of allocations served from recycled blocks
+  std::size_t GetHits() const {
+    return m_Hits;
+  }
+
+  /// @return Number of allocations which had to go to the heap
+  std::size_t GetMisses() const {
+    return m_Misses;
+  }
+
+  /// @return Number of blocks currently handed out
+  std::size_t GetInUse() const {
+    return m_InUse;
+  }
+
+  /// @return Largest number of blocks handed out at once
+  std::size_t GetHighWaterMark() const {
+    return m_HighWaterMark;
+  }
+
+ private:
+  MemoryPool()
+      : m_Hits(0),
+        m_Misses(0),
+        m_InUse(0),
+        m_HighWaterMark(0) {}
+
+  /// Free blocks cached by each thread, about 256 KB
+  static const std::size_t LocalCapacity =
+      BlockSize < 256 * 1024 / 4 ? 256 * 1024 / BlockSize : 4;
+
+  /// Free blocks kept in the shared list, about 4 MB
+  static const std::size_t SharedCapacity =
+      BlockSize < 4096 * 1024 / 16 ? 4096 * 1024 / BlockSize : 16;
+
+  /// @return Free blocks cached by this thread, null once the thread is exiting
+  static std::vector<void*>* GetLocalCache() {
+    static thread_local bool is_destroyed = false;
+    struct LocalCache {
+      ~LocalCache() {
+        // Hand blocks of an exiting thread to the others
+        is_destroyed = true;
+        for (auto block : blocks)
+          Instance().Release(block);
+      }
+      bool& is_destroyed;
+      std::vector<void*> blocks;
+    };
+    if (is_destroyed)
+      return nullptr;
+    static thread_local LocalCache cache{is_destroyed, {}};
+    return &cache.blocks;
+  }
+
+  void* Acquire() {
+    std::unique_lock<std::mutex> l(m_FreeBlocksMutex);
+    if (m_FreeBlocks.empty())
+      return nullptr;
+    auto block = m_FreeBlocks.back();
+    m_FreeBlocks.pop_back();
+    return block;
+  }
+
+  void Release(
+      void* block) {
+    {
+      std::unique_lock<std::mutex> l(m_FreeBlocksMutex);
+      if (m_FreeBlocks.size() < SharedCapacity) {
+        m_FreeBlocks.push_back(block);
+        return;
+      }
+    }
+    ::operator delete(block);
+  }
+
+  void UpdateHighWaterMark(
+      std::size_t in_use) {
+    auto mark = m_HighWaterMark.load();
+    while (in_use > mark
+        && !m_HighWaterMark.compare_exchange_weak(mark, in_use)) {}
+  }
+
+ private:
+  std::mutex m_FreeBlocksMutex;
+  std::vector<void*> m_FreeBlocks;
+  std::atomic<std::size_t> m_Hits, m_Misses, m_InUse, m_HighWaterMark;
+};
+
+}  // namespace core
+}  // namespace kovri
+
+#endif  // SRC_CORE_UTIL_MEMORY_POOL_H_
@@ -33,7 +33,10 @@
 #ifndef SRC_CORE_UTIL_QUEUE_H_
 #define SRC_CORE_UTIL_QUEUE_H_
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstddef>
 #include <functional>
 #include <mutex>
 #include <queue>
@@ -140,6 +143,166 @@ class Queue {
   std::condition_variable m_NonEmpty;
 };
 
+/// @class MPSCQueue
+/// @brief Lock-free queue for many producers and a single consumer
+/// @details Producers link their nodes with a single atomic exchange, also for
+///   a whole batch (Vyukov's MPSC design), so they never wait on each other or on
+///   the consumer. The mutex is only taken by the consumer to sleep when empty,
+///   and by producers to wake it up.
+/// @note Get, GetNext, GetNextWithTimeout and IsEmpty must only be called by one thread
+template<typename Element>
+class MPSCQueue {
+ public:
+  MPSCQueue()
+      : m_Head(new Node()),
+        m_Tail(m_Head.load()),
+        m_Size(0),
+        m_IsWaiting(false) {}
+
+  ~MPSCQueue() {
+    while (m_Tail) {
+      auto next = m_Tail->next.load();
+      delete m_Tail;
+      m_Tail = next;
+    }
+  }
+
+  MPSCQueue(const MPSCQueue&) = delete;
+  MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+  void Put(
+      Element e) {
+    auto node = new Node(std::move(e));
+    m_Size++;
+    Link(node, node);
+  }
+
+  void Put(
+      const std::vector<Element>& vec) {
+    if (vec.empty())
+      return;
+    // Chain privately, then publish with one exchange
+    auto first = new Node(vec.front()), last = first;
+    for (auto it = vec.begin() + 1; it != vec.end(); ++it) {
+      auto node = new Node(*it);
+      last->next.store(node, std::memory_order_relaxed);
+      last = node;
+    }
+    m_Size += vec.size();
+    Link(first, last);
+  }
+
+  /// @return Next element, or null if empty. Does not block.
+  Element Get() {
+    auto next = m_Tail->next.load();
+    if (!next)
+      return nullptr;
+    // The next node becomes the new stub
+    Element el = std::move(next->value);
+    delete m_Tail;
+    m_Tail = next;
+    m_Size--;
+    return el;
+  }
+
+  /// @brief Moves up to max elements into vec
+  /// @return Number of elements moved
+  std::size_t Get(
+      std::vector<Element>& vec,
+      std::size_t max) {
+    std::size_t num = 0;
+    for (; num < max; num++) {
+      auto el = Get();
+      if (!el)
+        break;
+      vec.push_back(std::move(el));
+    }
+    return num;
+  }
+
+  /// @return Next element, or null if woken up without one, as by WakeUp()
+  Element GetNext() {
+    auto el = Get();
+    if (!el) {
+      Sleep([this](std::unique_lock<std::mutex>& l) { m_NonEmpty.wait(l); });
+      el = Get();
+    }
+    return el;
+  }
+
+  /// @param msec Maximum time to wait, in milliseconds
+  Element GetNextWithTimeout(
+      int msec) {
+    auto el = Get();
+    if (!el) {
+      Sleep([this, msec](std::unique_lock<std::mutex>& l) {
+        m_NonEmpty.wait_for(l, std::chrono::milliseconds(msec));
+      });
+      el = Get();
+    }
+    return el;
+  }
+
+  bool IsEmpty() {
+    return !m_Tail->next.load();
+  }
+
+  /// @return Number of elements, may briefly include elements being put
+  int GetSize() const {
+    return m_Size;
+  }
+
+  void WakeUp() {
+    std::unique_lock<std::mutex> l(m_WaitMutex);
+    m_NonEmpty.notify_all();
+  }
+
+ private:
+  struct Node {
+    Node()
+        : next(nullptr) {}
+    explicit Node(
+        Element e)
+        : next(nullptr),
+          value(std::move(e)) {}
+    std::atomic<Node*> next;
+    Element value;
+  };
+
+  void Link(
+      Node* first,
+      Node* last) {
+    auto prev = m_Head.exchange(last);
+    // Until this store, the consumer sees the queue end at prev
+    prev->next.store(first);
+    // Sequentially consistent with Sleep(): either we see the consumer waiting,
+    // or it sees our node before going to sleep. Only the first producer to see
+    // it waiting wakes it up.
+    if (m_IsWaiting.load() && m_IsWaiting.exchange(false)) {
+      std::unique_lock<std::mutex> l(m_WaitMutex);
+      m_NonEmpty.notify_one();
+    }
+  }
+
+  template<typename Wait>
+  void Sleep(
+      Wait wait) {
+    std::unique_lock<std::mutex> l(m_WaitMutex);
+    m_IsWaiting.store(true);
+    if (IsEmpty())
+      wait(l);
+    m_IsWaiting.store(false);
+  }
+
+ private:
+  std::atomic<Node*> m_Head;  // Last node, where producers link
+  Node* m_Tail;  // Stub before the first element, owned by the consumer
+  std::atomic<int> m_Size;
+  std::atomic<bool> m_IsWaiting;
+  std::mutex m_WaitMutex;
+  std::condition_variable m_NonEmpty;
+};
+
 template<class Msg>
 class MsgQueue : public Queue<Msg *> {
  public:
@@ -0,0 +1,78 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#include <cryptopp/adler32.h>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "core/crypto/rand.h"
+#include "core/crypto/util/checksum.h"
+
+typedef std::chrono::high_resolution_clock Clock;
+
+template<class Digest>
+void benchmark(
+    const char* name,
+    std::size_t count,
+    std::size_t length,
+    Digest digest) {
+  std::vector<std::uint8_t> buf(length);
+  kovri::core::RandBytes(buf.data(), buf.size());
+  std::uint8_t result[4];
+  auto begin = Clock::now();
+  for (std::size_t i = 0; i < count; i++)
+    digest(result, buf.data(), buf.size());
+  auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      Clock::now() - begin).count();
+  std::cout << name << ", " << length << " bytes: "
+    << duration / count << " ns per call, "
+    << length * count * 1000 / duration << " MB/s" << std::endl;
+}
+
+int main() {
+  const std::size_t count = 100000;
+  // Sizes of an NTCP timestamp, of a tunnel message and of a full NTCP frame
+  for (std::size_t length : { 16, 1040, 16400 }) {
+    CryptoPP::Adler32 library;
+    benchmark("CryptoPP::Adler32", count, length,
+        [&library](std::uint8_t* digest, const std::uint8_t* input, std::size_t len) {
+          library.CalculateDigest(digest, input, len);
+        });
+    kovri::core::Adler32 adler;
+    benchmark("kovri::core::Adler32", count, length,
+        [&adler](std::uint8_t* digest, const std::uint8_t* input, std::size_t len) {
+          adler.CalculateDigest(digest, input, len);
+        });
+  }
+}
@@ -0,0 +1,84 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "core/crypto/rand.h"
+#include "core/util/bloom_filter.h"
+
+// Size of the encrypted part of a tunnel build request record
+const std::size_t RECORD_SIZE = 512;
+
+void benchmark(
+    std::size_t capacity,
+    double false_positive_rate) {
+  typedef std::chrono::high_resolution_clock Clock;
+  kovri::core::RotatingBloomFilter filter(
+      capacity,
+      false_positive_rate,
+      std::chrono::seconds(3600));
+  std::vector<std::uint8_t> records(2 * capacity * RECORD_SIZE);
+  kovri::core::RandBytes(records.data(), records.size());
+  // Fill the current generation, then look up as many unseen records
+  auto begin = Clock::now();
+  for (std::size_t i = 0; i < capacity; i++)
+    filter.CheckAndInsert(records.data() + i * RECORD_SIZE, RECORD_SIZE);
+  auto middle = Clock::now();
+  std::size_t false_positives = 0;
+  for (std::size_t i = capacity; i < 2 * capacity; i++)
+    if (filter.Contains(records.data() + i * RECORD_SIZE, RECORD_SIZE))
+      false_positives++;
+  auto end = Clock::now();
+  auto insert_duration =
+    std::chrono::duration_cast<std::chrono::microseconds>(middle - begin);
+  auto lookup_duration =
+    std::chrono::duration_cast<std::chrono::microseconds>(end - middle);
+  std::cout << "Capacity " << capacity << ", target false positive rate "
+    << false_positive_rate << std::endl;
+  std::cout << "Bits: " << filter.GetNumBits()
+    << ", hashes: " << filter.GetNumHashes() << std::endl;
+  std::cout << "Inserts per second: "
+    << capacity * 1000000 / (insert_duration.count() + 1) << std::endl;
+  std::cout << "Lookups per second: "
+    << capacity * 1000000 / (lookup_duration.count() + 1) << std::endl;
+  std::cout << "Measured false positive rate: "
+    << static_cast<double>(false_positives) / capacity << std::endl;
+}
+
+int main() {
+  std::cout << "-----Build records-----" << std::endl;
+  benchmark(100000, 0.0001);
+  std::cout << "-----Saturated-----" << std::endl;
+  benchmark(100000, 0.01);
+}
@@ -0,0 +1,77 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include "core/crypto/elgamal.h"
+#include "core/crypto/rand.h"
+
+typedef std::chrono::high_resolution_clock Clock;
+
+/// @return Time to set up and use an encryption for each of count keys
+std::chrono::nanoseconds benchmark(
+    std::size_t count,
+    const std::uint8_t* public_key) {
+  std::uint8_t message[222], encrypted[512];
+  kovri::core::RandBytes(message, sizeof(message));
+  std::chrono::nanoseconds duration(0);
+  for (std::size_t i = 0; i < count; i++) {
+    auto begin = Clock::now();
+    kovri::core::ElGamalEncryption encryption(public_key);
+    encryption.Encrypt(message, sizeof(message), encrypted);
+    duration += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now() - begin);
+  }
+  return duration;
+}
+
+int main() {
+  const std::size_t count = 100;
+  std::uint8_t private_key[256], public_key[256];
+  kovri::core::GenerateElGamalKeyPair(private_key, public_key);
+  auto cold = benchmark(count, public_key);
+  // Fill the pool before measuring, as on an idle router
+  auto& supplier = kovri::core::ElGamalKeysSupplier::Instance();
+  supplier.Start(count);
+  while (supplier.GetSize() < count)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  supplier.Stop();
+  auto pooled = benchmark(count, public_key);
+  std::cout << "Conducted " << count << " experiments." << std::endl;
+  std::cout << "Cold encryption latency (us): "
+    << cold.count() / count / 1000 << std::endl;
+  std::cout << "Pooled encryption latency (us): "
+    << pooled.count() / count / 1000 << std::endl;
+}
@@ -0,0 +1,83 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#include <cryptopp/integer.h>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "core/crypto/diffie_hellman.h"
+#include "core/crypto/impl/cryptopp/crypto_const.h"
+#include "core/crypto/rand.h"
+
+typedef std::chrono::high_resolution_clock Clock;
+
+int main() {
+  const std::size_t count = 200;
+  std::vector<CryptoPP::Integer> exponents;
+  for (std::size_t i = 0; i < count; i++) {
+    std::uint8_t buf[256];
+    kovri::core::RandBytes(buf, sizeof(buf));
+    exponents.emplace_back(buf, sizeof(buf));
+  }
+  // Build the table before measuring, as at startup
+  kovri::core::elgg_exp_mod_elgp(exponents.front());
+  std::vector<CryptoPP::Integer> generic, fixed;
+  auto begin = Clock::now();
+  for (const auto& exponent : exponents)
+    generic.push_back(
+        CryptoPP::a_exp_b_mod_c(kovri::core::elgg, exponent, kovri::core::elgp));
+  auto middle = Clock::now();
+  for (const auto& exponent : exponents)
+    fixed.push_back(kovri::core::elgg_exp_mod_elgp(exponent));
+  auto end = Clock::now();
+  if (generic != fixed)
+    std::cout << "!!! fixed-base result differs from a_exp_b_mod_c" << std::endl;
+  std::cout << "Conducted " << count << " experiments." << std::endl;
+  std::cout << "Generic g^x (us): "
+    << std::chrono::duration_cast<std::chrono::microseconds>(
+        middle - begin).count() / count << std::endl;
+  std::cout << "Fixed-base g^x (us): "
+    << std::chrono::duration_cast<std::chrono::microseconds>(
+        end - middle).count() / count << std::endl;
+  // End to end, as used by transports
+  std::uint8_t private_key[256], public_key[256];
+  kovri::core::DiffieHellman dh;
+  begin = Clock::now();
+  for (std::size_t i = 0; i < count; i++)
+    dh.GenerateKeyPair(private_key, public_key);
+  end = Clock::now();
+  std::cout << "DH key pairs per second: "
+    << count * 1000000 / (std::chrono::duration_cast<std::chrono::microseconds>(
+        end - begin).count() + 1) << std::endl;
+}
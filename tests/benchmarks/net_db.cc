@@ -0,0 +1,199 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "core/crypto/rand.h"
+#include "core/router/identity.h"
+#include "core/router/info.h"
+#include "core/router/net_db/index.h"
+
+// Hops selected per run, i.e., a few hundred 3-hop tunnel builds
+const std::size_t NUM_SELECTIONS = 1000;
+
+/// @brief Selection as previously done by NetDb: copy and shuffle all keys,
+///   then look each one up until the filter passes
+std::shared_ptr<kovri::core::RouterInfo> ShuffleSelect(
+    const std::map<kovri::core::IdentHash,
+                   std::shared_ptr<kovri::core::RouterInfo>>& routers) {
+  std::vector<std::unique_ptr<kovri::core::IdentHash>> idents;
+  for (auto const& ri : routers)
+    idents.push_back(std::make_unique<kovri::core::IdentHash>(ri.first));
+  kovri::core::Shuffle(idents.begin(), idents.end());
+  for (auto const& i : idents) {
+    auto const& router = routers.at(*i);
+    if (!router->IsUnreachable() && !router->IsHidden()
+        && router->IsHighBandwidth())
+      return router;
+  }
+  return nullptr;
+}
+
+void benchmark(
+    std::size_t num_routers) {
+  typedef std::chrono::high_resolution_clock Clock;
+  std::map<kovri::core::IdentHash, std::shared_ptr<kovri::core::RouterInfo>>
+    routers;
+  kovri::core::RouterIndex index;
+  for (std::size_t i = 0; i < num_routers; i++) {
+    auto router = std::make_shared<kovri::core::RouterInfo>();
+    router->AddNTCPAddress("127.0.0.1", 9111);
+    // Roughly a third of the network is high-bandwidth
+    router->SetCaps(
+        i % 3 ? kovri::core::RouterInfo::eReachable
+              : kovri::core::RouterInfo::eHighBandwidth);
+    // Some routers will have failed to be reached
+    router->SetUnreachable(i % 10 == 0);
+    kovri::core::IdentHash ident;
+    kovri::core::RandBytes(ident, 32);
+    routers[ident] = router;
+    index.Add(router);
+  }
+  std::size_t found = 0;
+  auto begin = Clock::now();
+  for (std::size_t i = 0; i < NUM_SELECTIONS; i++)
+    if (ShuffleSelect(routers))
+      found++;
+  auto middle = Clock::now();
+  for (std::size_t i = 0; i < NUM_SELECTIONS; i++)
+    if (index.GetRandom(
+            kovri::core::RouterIndexSet::HighBandwidth,
+            [](const std::shared_ptr<kovri::core::RouterInfo>& router) {
+              return !router->IsUnreachable();
+            }))
+      found++;
+  auto end = Clock::now();
+  auto shuffle_duration =
+    std::chrono::duration_cast<std::chrono::microseconds>(middle - begin);
+  auto index_duration =
+    std::chrono::duration_cast<std::chrono::microseconds>(end - middle);
+  std::cout << "Routers " << num_routers << ", high-bandwidth "
+    << index.GetSize(kovri::core::RouterIndexSet::HighBandwidth)
+    << std::endl;
+  std::cout << "Shuffled selections per second: "
+    << NUM_SELECTIONS * 1000000 / (shuffle_duration.count() + 1) << std::endl;
+  std::cout << "Indexed selections per second: "
+    << NUM_SELECTIONS * 1000000 / (index_duration.count() + 1) << std::endl;
+  std::cout << "Selections which found a router: "
+    << found << "/" << 2 * NUM_SELECTIONS << std::endl;
+}
+
+/// @brief Lookup as previously done by NetDb: measure every floodfill
+std::vector<kovri::core::IdentHash> ScanClosest(
+    const std::vector<std::shared_ptr<kovri::core::RouterInfo>>& floodfills,
+    const kovri::core::IdentHash& key,
+    std::size_t num) {
+  struct Sorted {
+    std::shared_ptr<const kovri::core::RouterInfo> r;
+    kovri::core::XORMetric metric;
+    bool operator<(const Sorted& other) const {
+      return metric < other.metric;
+    }
+  };
+  std::set<Sorted> sorted;
+  for (const auto& it : floodfills) {
+    kovri::core::XORMetric m = key ^ it->GetIdentHash();
+    if (sorted.size() < num) {
+      sorted.insert({it, m});
+    } else if (m < sorted.rbegin()->metric) {
+      sorted.insert({it, m});
+      sorted.erase(std::prev(sorted.end()));
+    }
+  }
+  std::vector<kovri::core::IdentHash> res;
+  for (const auto& it : sorted)
+    res.push_back(it.r->GetIdentHash());
+  return res;
+}
+
+void benchmark_floodfills(
+    std::size_t num_floodfills) {
+  typedef std::chrono::high_resolution_clock Clock;
+  std::vector<std::shared_ptr<kovri::core::RouterInfo>> floodfills;
+  kovri::core::FloodfillIndex index;
+  for (std::size_t i = 0; i < num_floodfills; i++) {
+    std::uint8_t public_key[256], signing_key[128];
+    kovri::core::RandBytes(public_key, sizeof(public_key));
+    kovri::core::RandBytes(signing_key, sizeof(signing_key));
+    auto floodfill = std::make_shared<kovri::core::RouterInfo>();
+    floodfill->SetRouterIdentity(
+        kovri::core::IdentityEx(public_key, signing_key));
+    floodfills.push_back(floodfill);
+    index.Add(floodfill);
+  }
+  // Looked up destinations, repeatedly queried as popular ones are
+  std::vector<kovri::core::IdentHash> destinations(NUM_SELECTIONS / 10);
+  for (auto& destination : destinations)
+    kovri::core::RandBytes(destination, 32);
+  // Number of floodfills a DatabaseStore is flooded to
+  const std::size_t num = 3;
+  auto begin = Clock::now();
+  for (std::size_t i = 0; i < NUM_SELECTIONS; i++)
+    ScanClosest(
+        floodfills,
+        kovri::core::CalculateRoutingKey(
+            destinations[i % destinations.size()], std::time(nullptr)),
+        num);
+  auto middle = Clock::now();
+  for (std::size_t i = 0; i < NUM_SELECTIONS; i++)
+    index.GetClosest(
+        kovri::core::CreateRoutingKey(destinations[i % destinations.size()]),
+        num,
+        [](const std::shared_ptr<kovri::core::RouterInfo>&) { return true; });
+  auto end = Clock::now();
+  auto scan_duration =
+    std::chrono::duration_cast<std::chrono::microseconds>(middle - begin);
+  auto index_duration =
+    std::chrono::duration_cast<std::chrono::microseconds>(end - middle);
+  std::cout << "Floodfills " << num_floodfills << std::endl;
+  std::cout << "Replies per second, hashed key and scan: "
+    << NUM_SELECTIONS * 1000000 / (scan_duration.count() + 1) << std::endl;
+  std::cout << "Replies per second, cached key and index: "
+    << NUM_SELECTIONS * 1000000 / (index_duration.count() + 1) << std::endl;
+}
+
+int main() {
+  std::cout << "-----5k routers-----" << std::endl;
+  benchmark(5000);
+  std::cout << "-----50k routers-----" << std::endl;
+  benchmark(50000);
+  std::cout << "-----1k floodfills-----" << std::endl;
+  benchmark_floodfills(1000);
+  std::cout << "-----5k floodfills-----" << std::endl;
+  benchmark_floodfills(5000);
+}
@@ -0,0 +1,77 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "core/util/queue.h"
+
+/// @brief Has producers post to one consumer, as transports do to tunnels and netdb
+template<class Queue>
+void benchmark(
+    std::size_t num_producers,
+    std::size_t count) {
+  typedef std::chrono::high_resolution_clock Clock;
+  Queue queue;
+  auto begin = Clock::now();
+  std::vector<std::thread> producers;
+  for (std::size_t p = 0; p < num_producers; p++)
+    producers.emplace_back([&queue, count]() {
+      for (std::size_t i = 0; i < count; i++)
+        queue.Put(std::make_shared<std::size_t>(i));
+    });
+  for (std::size_t received = 0; received < num_producers * count;)
+    if (queue.GetNextWithTimeout(1000))
+      received++;
+  auto end = Clock::now();
+  for (auto& producer : producers)
+    producer.join();
+  auto duration =
+    std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+  std::cout << num_producers << " producer(s): "
+    << num_producers * count * 1000000 / (duration + 1)
+    << " messages per second" << std::endl;
+}
+
+int main() {
+  const std::size_t count = 1000000;
+  for (std::size_t num_producers : { 1, 2, 4, 8 }) {
+    std::cout << "-----Queue-----" << std::endl;
+    benchmark<kovri::core::Queue<std::shared_ptr<std::size_t> > >(
+        num_producers, count / num_producers);
+    std::cout << "-----MPSCQueue-----" << std::endl;
+    benchmark<kovri::core::MPSCQueue<std::shared_ptr<std::size_t> > >(
+        num_producers, count / num_producers);
+  }
+}
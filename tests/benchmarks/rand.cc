@@ -0,0 +1,77 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#include <cryptopp/osrng.h>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "core/crypto/rand.h"
+
+typedef std::chrono::high_resolution_clock Clock;
+
+template<class Generate>
+void benchmark(
+    const char* name,
+    std::size_t count,
+    std::size_t length,
+    Generate generate) {
+  std::vector<std::uint8_t> buf(length);
+  auto begin = Clock::now();
+  for (std::size_t i = 0; i < count; i++)
+    generate(buf.data(), buf.size());
+  auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      Clock::now() - begin).count();
+  std::cout << name << ", " << length << " bytes: "
+    << duration / count << " ns per call" << std::endl;
+}
+
+int main() {
+  const std::size_t count = 10000;
+  // Sizes of an IV, of NTCP padding and of tunnel gateway padding
+  for (std::size_t length : { 16, 64, 1024 }) {
+    benchmark("AutoSeededRandomPool per call", count, length,
+        [](std::uint8_t* data, std::size_t len) {
+          CryptoPP::AutoSeededRandomPool prng;
+          prng.GenerateBlock(data, len);
+        });
+    benchmark("RandBytes", count, length,
+        [](std::uint8_t* data, std::size_t len) {
+          kovri::core::RandBytes(data, len);
+        });
+  }
+  benchmark("RandInRange32", count, 4,
+      [](std::uint8_t*, std::size_t) {
+        kovri::core::RandInRange32(0, 1000);
+      });
+}
@@ -0,0 +1,120 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/router/identity.h"
+#include "core/router/info.h"
+
+typedef std::vector<std::pair<std::string, std::string>> Options;
+
+void AddString(
+    std::vector<std::uint8_t>& buf,
+    const std::string& str) {
+  buf.push_back(str.size());
+  buf.insert(buf.end(), str.begin(), str.end());
+}
+
+void AddOptions(
+    std::vector<std::uint8_t>& buf,
+    const Options& options) {
+  std::size_t size = 0;
+  for (const auto& option : options)
+    size += option.first.size() + option.second.size() + 4;
+  buf.push_back(size >> 8);
+  buf.push_back(size & 0xFF);
+  for (const auto& option : options) {
+    AddString(buf, option.first);
+    buf.push_back('=');
+    AddString(buf, option.second);
+    buf.push_back(';');
+  }
+}
+
+/// @brief Creates a RouterInfo similar to those found on the network:
+///   NTCP and SSU over IPv4 and IPv6, the latter with introducers
+std::vector<std::uint8_t> CreateRouterInfo() {
+  std::vector<std::uint8_t> buf(kovri::core::DEFAULT_IDENTITY_SIZE, 0x42);
+  buf[buf.size() - 3] = buf[buf.size() - 2] = buf[buf.size() - 1] = 0;
+  buf.insert(buf.end(), 8, 0x01);  // published
+  const std::string key(43, 'A');
+  std::vector<std::pair<std::string, Options>> addresses {
+    {"NTCP", {{"host", "203.0.113.7"}, {"port", "23456"}}},
+    {"NTCP", {{"host", "2001:db8::7"}, {"port", "23456"}}},
+    {"SSU", {{"caps", "BC"}, {"host", "203.0.113.7"}, {"key", key + "="},
+             {"mtu", "1484"}, {"port", "23456"}}},
+    {"SSU", {{"caps", "B"}, {"ihost0", "198.51.100.1"},
+             {"ikey0", key + "="}, {"iport0", "12345"},
+             {"itag0", "1234567890"}, {"key", key + "="}, {"mtu", "1472"}}},
+  };
+  buf.push_back(addresses.size());
+  for (const auto& address : addresses) {
+    buf.push_back(address.first == "NTCP" ? 10 : 5);
+    buf.insert(buf.end(), 8, 0);  // expiration
+    AddString(buf, address.first);
+    AddOptions(buf, address.second);
+  }
+  buf.push_back(0);  // peers
+  AddOptions(
+      buf,
+      {{"caps", "OfR"}, {"coreVersion", "0.9.30"}, {"netId", "2"},
+       {"netdb.knownLeaseSets", "120"}, {"netdb.knownRouters", "3200"},
+       {"router.version", "0.9.30"}});
+  buf.insert(buf.end(), 40, 0);  // DSA signature
+  return buf;
+}
+
+int main() {
+  typedef std::chrono::high_resolution_clock Clock;
+  const auto buf = CreateRouterInfo();
+  // Roughly a full netdb load
+  const std::size_t num_parses = 100000;
+  std::size_t num_addresses = 0;
+  auto begin = Clock::now();
+  for (std::size_t i = 0; i < num_parses; i++) {
+    kovri::core::RouterInfo router(buf.data(), buf.size(), false);
+    num_addresses += router.GetAddresses().size();
+  }
+  auto end = Clock::now();
+  auto duration =
+    std::chrono::duration_cast<std::chrono::microseconds>(end - begin);
+  std::cout << "RouterInfo of " << buf.size() << " bytes, "
+    << num_addresses / num_parses << " addresses" << std::endl;
+  std::cout << "Parses per second: "
+    << num_parses * 1000000 / (duration.count() + 1) << std::endl;
+  std::cout << "Megabytes per second: "
+    << num_parses * buf.size() / (duration.count() + 1) << std::endl;
+}
@@ -34,7 +34,11 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <array>
+#include <cstdint>
+
 #include "core/crypto/aes.h"
+#include "core/crypto/rand.h"
 
 BOOST_AUTO_TEST_SUITE(AESTests)
 
@@ -218,4 +222,26 @@ BOOST_FIXTURE_TEST_CASE(AesCbcDecrypt, AesCbcFixture) {
   }
 }
 
+BOOST_FIXTURE_TEST_CASE(AesCbcBulkDecryptInPlace, AesCbcFixture) {
+  // Exercise the AES-NI kernel where available, keys must be set afterwards
+  kovri::core::SetupAESNI();
+  kovri::core::CBCEncryption encryption(kovri::core::AESKey(key), iv);
+  kovri::core::CBCDecryption bulk(kovri::core::AESKey(key), iv);
+  kovri::core::CBCDecryption single(kovri::core::AESKey(key), iv);
+  // Odd number of blocks, to not fit the interleave width
+  std::array<std::uint8_t, 23 * 16> plain, buf, expected;
+  kovri::core::RandBytes(plain.data(), plain.size());
+  encryption.Encrypt(plain.data(), plain.size(), buf.data());
+  // Block by block, as the NTCP receive path used to
+  for (std::size_t i = 0; i < buf.size(); i += 16)
+    single.Decrypt(buf.data() + i, expected.data() + i);
+  // Bulk, in place and split across calls
+  bulk.Decrypt(buf.data(), 9 * 16, buf.data());
+  bulk.Decrypt(buf.data() + 9 * 16, 14 * 16, buf.data() + 9 * 16);
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+      buf.begin(), buf.end(), expected.begin(), expected.end());
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+      buf.begin(), buf.end(), plain.begin(), plain.end());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
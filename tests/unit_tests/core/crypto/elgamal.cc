@@ -32,7 +32,9 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <chrono>
 #include <memory>
+#include <thread>
 
 #include "core/crypto/elgamal.h"
 #include "core/crypto/rand.h"
@@ -114,4 +116,23 @@ BOOST_FIXTURE_TEST_CASE(ElgamalEncryptDecryptZeroPadSmallMessageSuccess, Elgamal
     result, result + key_message_len - key_smaller);
 }
 
+BOOST_FIXTURE_TEST_CASE(ElgamalPrecomputedKeysEncryptDecryptSuccess, ElgamalFixture) {
+  auto& supplier = kovri::core::ElGamalKeysSupplier::Instance();
+  supplier.Start(1);
+  for (int i = 0; i < 100 && !supplier.GetSize(); i++)
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  BOOST_REQUIRE_EQUAL(supplier.GetSize(), 1);
+  kovri::core::ElGamalEncryption pooled_enc(public_key);
+  supplier.Stop();
+  uint8_t plaintext[key_message_len];
+  uint8_t ciphertext[key_ciphertext_len];
+  uint8_t result[key_message_len];
+  kovri::core::RandBytes(plaintext, key_message_len);
+  pooled_enc.Encrypt(plaintext, key_message_len, ciphertext, false);
+  BOOST_CHECK(kovri::core::ElGamalDecrypt(private_key, ciphertext, result, false));
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    plaintext, plaintext + key_message_len,
+    result, result + key_message_len);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -32,9 +32,17 @@
 
 #include <boost/test/unit_test.hpp>
 
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <limits>
 #include <stdexcept>
+#include <thread>
 
 #include "core/crypto/rand.h"
 
@@ -129,3 +137,49 @@ BOOST_AUTO_TEST_CASE(Outer) {
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(RandBytes)
+
+BOOST_AUTO_TEST_CASE(FillsAllBuffers) {
+  std::array<std::uint8_t, 32> key {}, zero {};
+  std::array<std::uint8_t, 16> iv {};
+  kovri::core::RandBytes({{key.data(), key.size()}, {iv.data(), iv.size()}});
+  BOOST_CHECK(key != zero);
+  BOOST_CHECK(std::count(iv.begin(), iv.end(), 0) < 4);
+  // Consecutive calls don't repeat
+  auto previous = key;
+  kovri::core::RandBytes(key.data(), key.size());
+  BOOST_CHECK(key != previous);
+}
+
+BOOST_AUTO_TEST_CASE(DiffersAcrossThreads) {
+  // Each thread is seeded separately
+  std::array<std::uint8_t, 32> first {}, second {};
+  std::thread([&first]() { kovri::core::RandBytes(first.data(), first.size()); }).join();
+  std::thread([&second]() { kovri::core::RandBytes(second.data(), second.size()); }).join();
+  BOOST_CHECK(first != second);
+}
+
+#ifndef _WIN32
+BOOST_AUTO_TEST_CASE(DiffersAcrossFork) {
+  // Parent has keystream buffered, which the child must not replay
+  std::array<std::uint8_t, 32> parent {}, child {};
+  kovri::core::RandBytes(parent.data(), parent.size());
+  int fds[2];
+  BOOST_REQUIRE(!pipe(fds));
+  const pid_t pid = fork();
+  BOOST_REQUIRE(pid >= 0);
+  if (!pid) {
+    kovri::core::RandBytes(child.data(), child.size());
+    _exit(write(fds[1], child.data(), child.size()) != 32);
+  }
+  kovri::core::RandBytes(parent.data(), parent.size());
+  BOOST_REQUIRE_EQUAL(read(fds[0], child.data(), child.size()), 32);
+  waitpid(pid, nullptr, 0);
+  close(fds[0]);
+  close(fds[1]);
+  BOOST_CHECK(parent != child);
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
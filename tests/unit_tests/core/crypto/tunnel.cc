@@ -0,0 +1,133 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "core/crypto/aes.h"
+#include "core/crypto/rand.h"
+#include "core/crypto/tunnel.h"
+
+BOOST_AUTO_TEST_SUITE(TunnelCryptoTests)
+
+struct TunnelCryptoFixture {
+  TunnelCryptoFixture() {
+    // Exercise the AES-NI kernels where available
+    kovri::core::SetupAESNI();
+    kovri::core::RandBytes(layer_key, sizeof(layer_key));
+    kovri::core::RandBytes(iv_key, sizeof(iv_key));
+    encryption.SetKeys(layer_key, iv_key);
+    decryption.SetKeys(layer_key, iv_key);
+    for (auto& msg : msgs)
+      kovri::core::RandBytes(msg.data(), msg.size());
+  }
+
+  static const std::size_t NumMsgs = 7;  // Odd, to not fit any interleave width
+  std::uint8_t layer_key[32], iv_key[32];
+  kovri::core::TunnelEncryption encryption;
+  kovri::core::TunnelDecryption decryption;
+  std::array<std::array<std::uint8_t, 1024>, NumMsgs> msgs;
+};
+
+BOOST_FIXTURE_TEST_CASE(DecryptReversesEncrypt, TunnelCryptoFixture) {
+  for (const auto& msg : msgs) {
+    std::array<std::uint8_t, 1024> encrypted, decrypted;
+    encryption.Encrypt(msg.data(), encrypted.data());
+    decryption.Decrypt(encrypted.data(), decrypted.data());
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        decrypted.begin(), decrypted.end(), msg.begin(), msg.end());
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE(DecryptInPlace, TunnelCryptoFixture) {
+  std::array<std::uint8_t, 1024> expected, buf = msgs[0];
+  decryption.Decrypt(msgs[0].data(), expected.data());
+  decryption.Decrypt(buf.data(), buf.data());
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+      buf.begin(), buf.end(), expected.begin(), expected.end());
+}
+
+BOOST_FIXTURE_TEST_CASE(BatchDecryptMatchesSingle, TunnelCryptoFixture) {
+  std::array<std::array<std::uint8_t, 1024>, NumMsgs> expected, batch;
+  std::vector<const std::uint8_t*> in;
+  std::vector<std::uint8_t*> out;
+  for (std::size_t i = 0; i < NumMsgs; i++) {
+    decryption.Decrypt(msgs[i].data(), expected[i].data());
+    in.push_back(msgs[i].data());
+    out.push_back(batch[i].data());
+  }
+  decryption.Decrypt(in.data(), out.data(), NumMsgs);
+  for (std::size_t i = 0; i < NumMsgs; i++)
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        batch[i].begin(), batch[i].end(),
+        expected[i].begin(), expected[i].end());
+}
+
+BOOST_FIXTURE_TEST_CASE(BatchEncryptMatchesSingle, TunnelCryptoFixture) {
+  // Each message gets its own keys, as when encrypting for many transit tunnels
+  std::array<kovri::core::TunnelEncryption, NumMsgs> encryptions;
+  std::array<std::array<std::uint8_t, 1024>, NumMsgs> expected, batch;
+  std::vector<kovri::core::TunnelEncryption*> ptrs;
+  std::vector<const std::uint8_t*> in;
+  std::vector<std::uint8_t*> out;
+  for (std::size_t i = 0; i < NumMsgs; i++) {
+    std::uint8_t keys[64];
+    kovri::core::RandBytes(keys, sizeof(keys));
+    encryptions[i].SetKeys(keys, keys + 32);
+    encryptions[i].Encrypt(msgs[i].data(), expected[i].data());
+    ptrs.push_back(&encryptions[i]);
+    in.push_back(msgs[i].data());
+    out.push_back(batch[i].data());
+  }
+  kovri::core::TunnelEncryption::Encrypt(
+      ptrs.data(), in.data(), out.data(), NumMsgs);
+  for (std::size_t i = 0; i < NumMsgs; i++)
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        batch[i].begin(), batch[i].end(),
+        expected[i].begin(), expected[i].end());
+  // In place
+  std::vector<std::uint8_t*> in_place;
+  for (auto& msg : msgs)
+    in_place.push_back(msg.data());
+  kovri::core::TunnelEncryption::Encrypt(
+      ptrs.data(), in_place.data(), in_place.data(), NumMsgs);
+  for (std::size_t i = 0; i < NumMsgs; i++)
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        msgs[i].begin(), msgs[i].end(),
+        expected[i].begin(), expected[i].end());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,115 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <cryptopp/adler32.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "core/crypto/rand.h"
+#include "core/crypto/util/checksum.h"
+
+BOOST_AUTO_TEST_SUITE(Adler32Tests)
+
+/// @brief Checks our digest of given input, and every kernel this CPU
+///   supports, against the library's
+void CheckAgainstLibrary(
+    const std::uint8_t* input,
+    std::size_t length) {
+  std::array<std::uint8_t, 4> digest, expected;
+  kovri::core::Adler32().CalculateDigest(digest.data(), input, length);
+  CryptoPP::Adler32().CalculateDigest(expected.data(), input, length);
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+      digest.begin(), digest.end(), expected.begin(), expected.end());
+  const std::uint32_t adler =
+    (expected[0] << 24) | (expected[1] << 16) |
+    (expected[2] << 8) | expected[3];
+  BOOST_CHECK_EQUAL(kovri::core::Adler32Scalar(1, input, length), adler);
+#if defined(__x86_64__) || defined(_M_X64)
+  if (__builtin_cpu_supports("ssse3"))
+    BOOST_CHECK_EQUAL(kovri::core::Adler32SSSE3(1, input, length), adler);
+  if (__builtin_cpu_supports("avx2"))
+    BOOST_CHECK_EQUAL(kovri::core::Adler32AVX2(1, input, length), adler);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(KnownDigest) {
+  const char* input = "Wikipedia";
+  std::array<std::uint8_t, 4> digest;
+  const std::array<std::uint8_t, 4> expected {{ 0x11, 0xE6, 0x03, 0x98 }};
+  kovri::core::Adler32().CalculateDigest(
+      digest.data(),
+      reinterpret_cast<const std::uint8_t*>(input),
+      std::strlen(input));
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+      digest.begin(), digest.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(MatchesLibrary) {
+  // Around the 32 byte SIMD step, and across the 5552 byte reduction interval
+  for (std::size_t length :
+       { 0, 1, 15, 16, 31, 32, 33, 63, 64, 1028, 5551, 5552, 5553, 16410, 40000 }) {
+    std::vector<std::uint8_t> input(length);
+    kovri::core::RandBytes(input.data(), input.size());
+    CheckAgainstLibrary(input.data(), input.size());
+    // All bits set is the worst case for overflow of the sums
+    std::fill(input.begin(), input.end(), 0xFF);
+    CheckAgainstLibrary(input.data(), input.size());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(MatchesLibraryUnaligned) {
+  std::vector<std::uint8_t> buf(1100);
+  kovri::core::RandBytes(buf.data(), buf.size());
+  // Straight into buf, so that the kernels load from unaligned addresses
+  for (std::size_t offset = 1; offset < 32; offset += 7)
+    CheckAgainstLibrary(buf.data() + offset, buf.size() - offset);
+}
+
+BOOST_AUTO_TEST_CASE(VerifyDigest) {
+  std::vector<std::uint8_t> input(1028);
+  kovri::core::RandBytes(input.data(), input.size());
+  std::array<std::uint8_t, 4> digest;
+  kovri::core::Adler32 adler;
+  adler.CalculateDigest(digest.data(), input.data(), input.size());
+  BOOST_CHECK(adler.VerifyDigest(digest.data(), input.data(), input.size()));
+  input[500] ^= 0x01;
+  BOOST_CHECK(!adler.VerifyDigest(digest.data(), input.data(), input.size()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,124 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#include "core/router/i2np.h"
+
+using kovri::core::GrowI2NPMessage;
+using kovri::core::NewI2NPMessage;
+using kovri::core::ToSharedI2NPMessage;
+using kovri::core::I2NP_MAX_MESSAGE_SIZE;
+using kovri::core::I2NP_MAX_SHORT_MESSAGE_SIZE;
+using kovri::core::I2NP_MAX_TUNNEL_DATA_MESSAGE_SIZE;
+using kovri::core::I2NP_MESSAGE_SIZE_CLASS_RESERVE;
+
+BOOST_AUTO_TEST_SUITE(I2NPMessageTests)
+
+BOOST_AUTO_TEST_CASE(PicksSmallestSizeClass) {
+  const std::size_t reserve = I2NP_MESSAGE_SIZE_CLASS_RESERVE;
+  BOOST_CHECK_EQUAL(
+      NewI2NPMessage(0)->max_len,
+      I2NP_MAX_TUNNEL_DATA_MESSAGE_SIZE);
+  BOOST_CHECK_EQUAL(
+      NewI2NPMessage(I2NP_MAX_TUNNEL_DATA_MESSAGE_SIZE - reserve)->max_len,
+      I2NP_MAX_TUNNEL_DATA_MESSAGE_SIZE);
+  BOOST_CHECK_EQUAL(
+      NewI2NPMessage(I2NP_MAX_TUNNEL_DATA_MESSAGE_SIZE - reserve + 1)->max_len,
+      I2NP_MAX_SHORT_MESSAGE_SIZE);
+  BOOST_CHECK_EQUAL(
+      NewI2NPMessage(I2NP_MAX_SHORT_MESSAGE_SIZE - reserve)->max_len,
+      I2NP_MAX_SHORT_MESSAGE_SIZE);
+  BOOST_CHECK_EQUAL(
+      NewI2NPMessage(I2NP_MAX_SHORT_MESSAGE_SIZE - reserve + 1)->max_len,
+      I2NP_MAX_MESSAGE_SIZE);
+  // Larger payloads are refused when written, not here
+  BOOST_CHECK_EQUAL(
+      NewI2NPMessage(I2NP_MAX_MESSAGE_SIZE * 2)->max_len,
+      I2NP_MAX_MESSAGE_SIZE);
+}
+
+BOOST_AUTO_TEST_CASE(GrowKeepsMessageWithRoom) {
+  auto msg = ToSharedI2NPMessage(NewI2NPMessage(100));
+  BOOST_CHECK(GrowI2NPMessage(msg, 100) == msg);
+}
+
+BOOST_AUTO_TEST_CASE(GrowCopiesIntoLargerClass) {
+  auto msg = ToSharedI2NPMessage(NewI2NPMessage(0));
+  msg->offset += 4;
+  msg->len += 4 + 100;
+  std::memset(msg->GetBuffer(), 0xAB, msg->GetLength());
+  auto grown = GrowI2NPMessage(msg, 2000);
+  BOOST_REQUIRE(grown);
+  BOOST_CHECK(grown != msg);
+  BOOST_CHECK_EQUAL(grown->max_len, I2NP_MAX_SHORT_MESSAGE_SIZE);
+  BOOST_CHECK_EQUAL(grown->offset, msg->offset);
+  BOOST_CHECK_EQUAL(grown->len, msg->len);
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+      grown->GetBuffer(), grown->GetBuffer() + grown->GetLength(),
+      msg->GetBuffer(), msg->GetBuffer() + msg->GetLength());
+}
+
+BOOST_AUTO_TEST_CASE(GrowRefusesBeyondLargestClass) {
+  auto msg = ToSharedI2NPMessage(NewI2NPMessage(I2NP_MAX_MESSAGE_SIZE));
+  msg->len = I2NP_MAX_MESSAGE_SIZE - 100;
+  BOOST_CHECK(GrowI2NPMessage(msg, 100) == msg);
+  BOOST_CHECK(!GrowI2NPMessage(msg, 101));
+  auto small = ToSharedI2NPMessage(NewI2NPMessage(0));
+  BOOST_CHECK(!GrowI2NPMessage(small, I2NP_MAX_MESSAGE_SIZE));
+}
+
+BOOST_AUTO_TEST_CASE(ReusesBuffersOfGrownMessage) {
+  auto msg = ToSharedI2NPMessage(NewI2NPMessage(0));
+  const auto* small = msg.get();
+  msg->len += 100;
+  msg = GrowI2NPMessage(msg, 2000);
+  const auto* grown = msg.get();
+  // The outgrown buffer went back to its pool, and is handed out fresh
+  auto reused = NewI2NPMessage(0);
+  BOOST_CHECK_EQUAL(reused.get(), small);
+  BOOST_CHECK_EQUAL(reused->max_len, I2NP_MAX_TUNNEL_DATA_MESSAGE_SIZE);
+  BOOST_CHECK_EQUAL(reused->len, kovri::core::I2NP_HEADER_SIZE + 2);
+  // So is the grown one, once done with
+  msg.reset();
+  auto reused_grown = NewI2NPMessage(2000);
+  BOOST_CHECK_EQUAL(reused_grown.get(), grown);
+  BOOST_CHECK_EQUAL(reused_grown->max_len, I2NP_MAX_SHORT_MESSAGE_SIZE);
+  BOOST_CHECK_EQUAL(reused_grown->offset, 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
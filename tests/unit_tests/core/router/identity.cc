@@ -0,0 +1,111 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <ctime>
+
+#include "core/router/identity.h"
+
+#include "core/util/byte_stream.h"
+
+using kovri::core::CalculateRoutingKey;
+using kovri::core::GetType;
+using kovri::core::IdentHash;
+using kovri::core::RoutingKeyCache;
+using kovri::core::RoutingKeyCacheSize;
+
+struct RoutingKeyFixture {
+  RoutingKeyFixture() {
+    for (std::uint8_t i = 0; i < 32; i++)
+      ident()[i] = i;
+  }
+
+  // 2017-01-01 00:00:00 UTC
+  const std::time_t midnight = 1483228800;
+  IdentHash ident;
+};
+
+BOOST_FIXTURE_TEST_SUITE(RoutingKeyTests, RoutingKeyFixture)
+
+BOOST_AUTO_TEST_CASE(KeyIsHashOfIdentAndDate) {
+  // SHA-256(ident || "20161231") and SHA-256(ident || "20170101")
+  const std::uint8_t before[32] {
+    0xe8, 0x5d, 0x45, 0xe8, 0x47, 0xb0, 0x01, 0x04,
+    0xab, 0x12, 0xe8, 0xb1, 0x02, 0x7f, 0x92, 0x4b,
+    0xbb, 0xfd, 0x0c, 0x95, 0xaa, 0xe3, 0xb7, 0x51,
+    0x92, 0x8f, 0x3a, 0x65, 0x91, 0xce, 0x5f, 0x1f
+  };
+  IdentHash zero;
+  memset(zero(), 0, 32);
+  const std::uint8_t after_zero[32] {
+    0xbe, 0x5a, 0x6b, 0xe6, 0x74, 0xc1, 0x7e, 0x7d,
+    0xab, 0xcf, 0x55, 0x63, 0x2b, 0x58, 0x7b, 0xa1,
+    0x0e, 0xf4, 0x84, 0x05, 0x5d, 0x24, 0x78, 0xed,
+    0xd4, 0x08, 0xbf, 0x01, 0x41, 0x65, 0xba, 0x18
+  };
+  BOOST_CHECK(CalculateRoutingKey(ident, midnight - 1) == IdentHash(before));
+  BOOST_CHECK(
+      CalculateRoutingKey(zero, midnight + 86399) == IdentHash(after_zero));
+}
+
+BOOST_AUTO_TEST_CASE(CacheMatchesCalculation) {
+  RoutingKeyCache cache;
+  auto key = cache.Get(ident, midnight + 60);
+  BOOST_CHECK(key == CalculateRoutingKey(ident, midnight));
+  BOOST_CHECK(cache.Get(ident, midnight + 86399) == key);
+  BOOST_CHECK_EQUAL(cache.GetSize(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(CacheExpiresAtMidnight) {
+  RoutingKeyCache cache;
+  auto before = cache.Get(ident, midnight - 1);
+  auto after = cache.Get(ident, midnight);
+  BOOST_CHECK(!(before == after));
+  BOOST_CHECK(after == CalculateRoutingKey(ident, midnight));
+  BOOST_CHECK_EQUAL(cache.GetSize(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(CacheIsBounded) {
+  RoutingKeyCache cache;
+  for (std::size_t i = 0;
+       i <= GetType(RoutingKeyCacheSize::MaxEntries);
+       i++) {
+    memcpy(ident(), &i, sizeof(i));
+    cache.Get(ident, midnight);
+  }
+  BOOST_CHECK_LE(cache.GetSize(), GetType(RoutingKeyCacheSize::MaxEntries));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,189 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/router/identity.h"
+#include "core/router/info.h"
+
+using kovri::core::RouterInfo;
+
+struct RouterInfoFixture {
+  RouterInfoFixture() {
+    // Identity: ElGamal and DSA keys, NULL certificate
+    buf.resize(kovri::core::DEFAULT_IDENTITY_SIZE, 0x42);
+    buf[buf.size() - 3] = 0;
+    buf[buf.size() - 2] = 0;
+    buf[buf.size() - 1] = 0;
+    // Published
+    for (std::uint8_t byte : {0x00, 0x00, 0x01, 0x5a, 0x3b, 0x2c, 0x1d, 0x00})
+      buf.push_back(byte);
+    buf.push_back(2);  // addresses
+    AddAddress(10, "NTCP", {{"host", "127.0.0.1"}, {"port", "9111"}});
+    AddAddress(
+        5,
+        "SSU",
+        {{"caps", "BC"},
+         {"host", "::1"},
+         {"key", std::string(43, 'A') + "="},
+         {"mtu", "1472"},
+         {"port", "9112"}});
+    buf.push_back(0);  // peers
+    AddOptions({{"caps", "fR"}, {"netId", "2"}});
+    buf.insert(buf.end(), 40, 0);  // DSA signature
+  }
+
+  void AddString(
+      const std::string& str) {
+    buf.push_back(str.size());
+    buf.insert(buf.end(), str.begin(), str.end());
+  }
+
+  void AddOptions(
+      const std::vector<std::pair<std::string, std::string>>& options) {
+    std::size_t size = 0;
+    for (const auto& option : options)
+      size += option.first.size() + option.second.size() + 4;
+    buf.push_back(size >> 8);
+    buf.push_back(size & 0xFF);
+    for (const auto& option : options) {
+      AddString(option.first);
+      buf.push_back('=');
+      AddString(option.second);
+      buf.push_back(';');
+    }
+  }
+
+  void AddAddress(
+      std::uint8_t cost,
+      const std::string& transport,
+      const std::vector<std::pair<std::string, std::string>>& options) {
+    buf.push_back(cost);
+    buf.insert(buf.end(), 8, 0);  // expiration
+    AddString(transport);
+    AddOptions(options);
+  }
+
+  std::vector<std::uint8_t> buf;
+};
+
+BOOST_FIXTURE_TEST_SUITE(RouterInfoTests, RouterInfoFixture)
+
+BOOST_AUTO_TEST_CASE(ParsesFields) {
+  RouterInfo router(buf.data(), buf.size(), false);
+  BOOST_CHECK(!router.IsUnreachable());
+  BOOST_CHECK_EQUAL(router.GetTimestamp(), 0x15a3b2c1d00ULL);
+  BOOST_CHECK(router.IsFloodfill());
+  BOOST_CHECK(router.IsNTCP());
+  BOOST_CHECK(!router.IsSSU());
+  BOOST_CHECK(router.IsSSU(false));
+  BOOST_CHECK(router.IsIntroducer());
+  BOOST_CHECK(router.IsPeerTesting());
+  const auto* ntcp = router.GetNTCPAddress();
+  BOOST_REQUIRE(ntcp);
+  BOOST_CHECK_EQUAL(ntcp->port, 9111);
+  BOOST_CHECK_EQUAL(ntcp->cost, 10);
+  BOOST_CHECK_EQUAL(ntcp->host.to_string(), "127.0.0.1");
+  const auto* ssu = router.GetSSUV6Address();
+  BOOST_REQUIRE(ssu);
+  BOOST_CHECK_EQUAL(ssu->port, 9112);
+  BOOST_CHECK_EQUAL(ssu->mtu, 1472);
+  // Buffer is kept by caller
+  BOOST_CHECK(!router.GetBuffer());
+}
+
+BOOST_AUTO_TEST_CASE(InvalidPortDropsAddress) {
+  buf.resize(kovri::core::DEFAULT_IDENTITY_SIZE + 8);
+  buf.push_back(1);
+  AddAddress(10, "NTCP", {{"host", "127.0.0.1"}, {"port", "91x1"}});
+  buf.push_back(0);
+  AddOptions({});
+  RouterInfo router(buf.data(), buf.size(), false);
+  BOOST_CHECK(!router.GetNTCPAddress());
+  BOOST_CHECK(router.IsUnreachable());
+}
+
+BOOST_AUTO_TEST_CASE(OutOfRangePortDropsAddress) {
+  buf.resize(kovri::core::DEFAULT_IDENTITY_SIZE + 8);
+  buf.push_back(1);
+  AddAddress(10, "NTCP", {{"host", "127.0.0.1"}, {"port", "70000"}});
+  buf.push_back(0);
+  AddOptions({});
+  RouterInfo router(buf.data(), buf.size(), false);
+  BOOST_CHECK(!router.GetNTCPAddress());
+  BOOST_CHECK(router.IsUnreachable());
+}
+
+BOOST_AUTO_TEST_CASE(SkipsUnknownIntroducerKey) {
+  buf.resize(kovri::core::DEFAULT_IDENTITY_SIZE + 8);
+  buf.push_back(1);
+  AddAddress(
+      10,
+      "NTCP",
+      {{"host", "127.0.0.1"}, {"ifuture", "1"}, {"port", "9111"}});
+  buf.push_back(0);
+  AddOptions({});
+  RouterInfo router(buf.data(), buf.size(), false);
+  const auto* ntcp = router.GetNTCPAddress();
+  BOOST_REQUIRE(ntcp);
+  BOOST_CHECK_EQUAL(ntcp->port, 9111);
+  BOOST_CHECK(ntcp->introducers.empty());
+}
+
+BOOST_AUTO_TEST_CASE(TruncatedIsUnreachable) {
+  // Every truncation must be rejected without reading past the buffer
+  for (std::size_t len = 0; len < buf.size() - 40; len++) {
+    std::vector<std::uint8_t> truncated(buf.begin(), buf.begin() + len);
+    RouterInfo router(truncated.data(), truncated.size(), false);
+    BOOST_CHECK(router.IsUnreachable());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(SurvivesMutations) {
+  std::mt19937 rng(2017);
+  std::uniform_int_distribution<std::size_t> position(
+      kovri::core::DEFAULT_IDENTITY_SIZE, buf.size() - 1);
+  for (std::size_t i = 0; i < 10000; i++) {
+    auto mutated = buf;
+    for (std::size_t j = 0; j < 1 + i % 4; j++)
+      mutated[position(rng)] = rng();
+    BOOST_CHECK_NO_THROW(RouterInfo(mutated.data(), mutated.size(), false));
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,261 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "core/crypto/rand.h"
+#include "core/router/identity.h"
+#include "core/router/info.h"
+#include "core/router/net_db/index.h"
+
+using kovri::core::FloodfillIndex;
+using kovri::core::IdentHash;
+using kovri::core::IdentityEx;
+using kovri::core::RouterIndex;
+using kovri::core::RouterIndexSet;
+using kovri::core::RouterInfo;
+
+struct RouterIndexFixture {
+  std::shared_ptr<RouterInfo> CreateRouter(
+      std::uint8_t caps,
+      bool ntcp = true,
+      bool ssu = false) {
+    auto router = std::make_shared<RouterInfo>();
+    if (ntcp)
+      router->AddNTCPAddress("127.0.0.1", 9111);
+    if (ssu) {
+      std::uint8_t key[32] {};
+      router->AddSSUAddress("127.0.0.1", 9111, key);
+    }
+    router->SetCaps(caps);
+    return router;
+  }
+
+  RouterIndex index;
+};
+
+BOOST_FIXTURE_TEST_SUITE(RouterIndexTests, RouterIndexFixture)
+
+BOOST_AUTO_TEST_CASE(IndexesByCaps) {
+  index.Add(CreateRouter(RouterInfo::eHighBandwidth));
+  index.Add(CreateRouter(RouterInfo::eSSUIntroducer, false, true));
+  index.Add(CreateRouter(RouterInfo::eHighBandwidth | RouterInfo::eHidden));
+  BOOST_CHECK_EQUAL(index.GetSize(RouterIndexSet::Reachable), 2);
+  BOOST_CHECK_EQUAL(index.GetSize(RouterIndexSet::HighBandwidth), 1);
+  BOOST_CHECK_EQUAL(index.GetSize(RouterIndexSet::Introducer), 1);
+  BOOST_CHECK_EQUAL(index.GetSize(RouterIndexSet::PeerTesting), 0);
+  BOOST_CHECK_EQUAL(index.GetSize(RouterIndexSet::NTCP), 1);
+  BOOST_CHECK_EQUAL(index.GetSize(RouterIndexSet::SSU), 1);
+}
+
+BOOST_AUTO_TEST_CASE(ReindexesChangedCaps) {
+  auto router = CreateRouter(RouterInfo::eHighBandwidth);
+  index.Add(router);
+  index.Add(router);
+  BOOST_CHECK_EQUAL(index.GetSize(RouterIndexSet::Reachable), 1);
+  router->SetCaps(RouterInfo::eSSUTesting);
+  index.Add(router);
+  BOOST_CHECK_EQUAL(index.GetSize(RouterIndexSet::Reachable), 1);
+  BOOST_CHECK_EQUAL(index.GetSize(RouterIndexSet::HighBandwidth), 0);
+  BOOST_CHECK_EQUAL(index.GetSize(RouterIndexSet::PeerTesting), 1);
+  router->SetCaps(RouterInfo::eHidden);
+  index.Add(router);
+  BOOST_CHECK_EQUAL(index.GetSize(RouterIndexSet::Reachable), 0);
+}
+
+BOOST_AUTO_TEST_CASE(RemoveKeepsOthersReachable) {
+  std::vector<std::shared_ptr<RouterInfo>> routers;
+  for (std::size_t i = 0; i < 10; i++) {
+    routers.push_back(CreateRouter(RouterInfo::eHighBandwidth));
+    index.Add(routers.back());
+  }
+  // Remove from the front, middle and back of the sets
+  index.Remove(routers[0]);
+  index.Remove(routers[5]);
+  index.Remove(routers[9]);
+  index.Remove(routers[9]);
+  BOOST_CHECK_EQUAL(index.GetSize(RouterIndexSet::Reachable), 7);
+  BOOST_CHECK_EQUAL(index.GetSize(RouterIndexSet::HighBandwidth), 7);
+  std::set<std::shared_ptr<RouterInfo>> seen;
+  for (std::size_t i = 0; i < 1000; i++)
+    seen.insert(
+        index.GetRandom(
+            RouterIndexSet::HighBandwidth,
+            [](const std::shared_ptr<RouterInfo>&) { return true; }));
+  BOOST_CHECK_EQUAL(seen.size(), 7);
+  BOOST_CHECK(!seen.count(routers[0]));
+  BOOST_CHECK(!seen.count(routers[5]));
+  BOOST_CHECK(!seen.count(routers[9]));
+}
+
+BOOST_AUTO_TEST_CASE(FindsRareMatch) {
+  std::vector<std::shared_ptr<RouterInfo>> routers;
+  for (std::size_t i = 0; i < 1000; i++) {
+    routers.push_back(CreateRouter(0));
+    index.Add(routers.back());
+  }
+  // Far too rare for rejection sampling alone
+  auto wanted = routers[123];
+  for (std::size_t i = 0; i < 10; i++)
+    BOOST_CHECK_EQUAL(
+        index.GetRandom(
+            RouterIndexSet::Reachable,
+            [wanted](const std::shared_ptr<RouterInfo>& router) {
+              return router == wanted;
+            }),
+        wanted);
+  BOOST_CHECK(
+      !index.GetRandom(
+          RouterIndexSet::Reachable,
+          [](const std::shared_ptr<RouterInfo>&) { return false; }));
+  index.Clear();
+  BOOST_CHECK(
+      !index.GetRandom(
+          RouterIndexSet::Reachable,
+          [](const std::shared_ptr<RouterInfo>&) { return true; }));
+}
+
+BOOST_AUTO_TEST_CASE(CompatibleSet) {
+  BOOST_CHECK(
+      RouterIndex::GetCompatibleSet(*CreateRouter(0, true, false))
+      == RouterIndexSet::NTCP);
+  BOOST_CHECK(
+      RouterIndex::GetCompatibleSet(*CreateRouter(0, false, true))
+      == RouterIndexSet::SSU);
+  BOOST_CHECK(
+      RouterIndex::GetCompatibleSet(*CreateRouter(0, true, true))
+      == RouterIndexSet::Reachable);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+struct FloodfillIndexFixture {
+  FloodfillIndexFixture() {
+    for (std::size_t i = 0; i < 300; i++) {
+      // Random keys give a random ident hash
+      std::uint8_t public_key[256], signing_key[128];
+      kovri::core::RandBytes(public_key, sizeof(public_key));
+      kovri::core::RandBytes(signing_key, sizeof(signing_key));
+      auto floodfill = std::make_shared<RouterInfo>();
+      floodfill->SetRouterIdentity(IdentityEx(public_key, signing_key));
+      floodfill->SetCaps(RouterInfo::eFloodfill);
+      floodfills.push_back(floodfill);
+      index.Add(floodfill);
+    }
+  }
+
+  /// @brief Reference result: sort every floodfill by distance
+  std::vector<std::shared_ptr<RouterInfo>> GetClosest(
+      const IdentHash& key,
+      std::size_t num,
+      const std::set<IdentHash>& excluded) {
+    std::vector<std::shared_ptr<RouterInfo>> sorted;
+    for (const auto& floodfill : floodfills)
+      if (!excluded.count(floodfill->GetIdentHash()))
+        sorted.push_back(floodfill);
+    std::sort(
+        sorted.begin(),
+        sorted.end(),
+        [&key](
+            const std::shared_ptr<RouterInfo>& a,
+            const std::shared_ptr<RouterInfo>& b) {
+          return (key ^ a->GetIdentHash()) < (key ^ b->GetIdentHash());
+        });
+    if (sorted.size() > num)
+      sorted.resize(num);
+    return sorted;
+  }
+
+  std::vector<std::shared_ptr<RouterInfo>> floodfills;
+  FloodfillIndex index;
+};
+
+BOOST_FIXTURE_TEST_SUITE(FloodfillIndexTests, FloodfillIndexFixture)
+
+BOOST_AUTO_TEST_CASE(MatchesLinearScan) {
+  for (std::size_t i = 0; i < 100; i++) {
+    IdentHash key;
+    kovri::core::RandBytes(key, 32);
+    std::set<IdentHash> excluded;
+    // Exclude some of the closest so that the index has to skip them
+    for (const auto& floodfill : GetClosest(key, i % 4, excluded))
+      excluded.insert(floodfill->GetIdentHash());
+    auto closest = index.GetClosest(
+        key,
+        i % 10,
+        [&excluded](const std::shared_ptr<RouterInfo>& floodfill) {
+          return !excluded.count(floodfill->GetIdentHash());
+        });
+    auto expected = GetClosest(key, i % 10, excluded);
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+        closest.begin(), closest.end(), expected.begin(), expected.end());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ExactMatchIsClosest) {
+  const auto& key = floodfills[42]->GetIdentHash();
+  auto closest = index.GetClosest(
+      key,
+      1,
+      [](const std::shared_ptr<RouterInfo>&) { return true; });
+  BOOST_REQUIRE_EQUAL(closest.size(), 1);
+  BOOST_CHECK_EQUAL(closest[0], floodfills[42]);
+}
+
+BOOST_AUTO_TEST_CASE(AddRemove) {
+  index.Add(floodfills[0]);
+  BOOST_CHECK_EQUAL(index.GetSize(), floodfills.size());
+  index.Remove(floodfills[0]);
+  index.Remove(floodfills[0]);
+  BOOST_CHECK_EQUAL(index.GetSize(), floodfills.size() - 1);
+  auto all = index.GetClosest(
+      floodfills[0]->GetIdentHash(),
+      floodfills.size(),
+      [](const std::shared_ptr<RouterInfo>&) { return true; });
+  BOOST_CHECK_EQUAL(all.size(), floodfills.size() - 1);
+  BOOST_CHECK(std::find(all.begin(), all.end(), floodfills[0]) == all.end());
+  index.Clear();
+  BOOST_CHECK(
+      index.GetClosest(
+          floodfills[0]->GetIdentHash(),
+          1,
+          [](const std::shared_ptr<RouterInfo>&) { return true; }).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,257 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+#include "core/router/identity.h"
+#include "core/router/net_db/store.h"
+
+#include "core/util/byte_stream.h"
+
+using kovri::core::GetType;
+using kovri::core::IdentHash;
+using kovri::core::NetDbStore;
+using kovri::core::NetDbStoreSize;
+
+struct NetDbStoreFixture {
+  NetDbStoreFixture()
+      : path(
+            boost::filesystem::temp_directory_path()
+            / boost::filesystem::unique_path("kovri-netdb-%%%%-%%%%.dat")) {
+    for (std::uint8_t i = 0; i < 3; i++) {
+      IdentHash ident;
+      memset(ident(), i, 32);
+      idents.push_back(ident);
+      payloads.push_back(std::vector<std::uint8_t>(100 + i, i));
+    }
+  }
+
+  ~NetDbStoreFixture() {
+    store.Close();
+    boost::filesystem::remove(path);
+    boost::filesystem::remove(path.string() + ".tmp");
+    boost::filesystem::remove(path.string() + ".bad");
+  }
+
+  /// @brief Overwrites bytes of the store file at given offset
+  void Corrupt(
+      std::size_t offset,
+      const std::vector<std::uint8_t>& bytes) {
+    std::fstream f(
+        path.string(),
+        std::fstream::binary | std::fstream::in | std::fstream::out);
+    f.seekp(offset);
+    f.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+  }
+
+  /// @return Offset of the i'th record written by PutAll()
+  std::size_t GetOffset(
+      std::size_t i) const {
+    std::size_t offset = GetType(NetDbStoreSize::FileHeader);
+    for (std::size_t j = 0; j < i; j++)
+      offset += GetType(NetDbStoreSize::RecordHeader) + payloads[j].size();
+    return offset;
+  }
+
+  void PutAll() {
+    for (std::size_t i = 0; i < idents.size(); i++)
+      store.Put(idents[i], payloads[i].data(), payloads[i].size());
+  }
+
+  boost::filesystem::path path;
+  std::vector<IdentHash> idents;
+  std::vector<std::vector<std::uint8_t>> payloads;
+  NetDbStore store;
+};
+
+BOOST_FIXTURE_TEST_SUITE(NetDbStoreTests, NetDbStoreFixture)
+
+BOOST_AUTO_TEST_CASE(PutIsBatchedUntilFlush) {
+  BOOST_REQUIRE(store.Open(path));
+  BOOST_CHECK_EQUAL(store.GetSize(), 0);
+  PutAll();
+  BOOST_CHECK_EQUAL(store.GetSize(), 0);
+  BOOST_CHECK(store.Get(idents[0]).empty());
+  BOOST_REQUIRE(store.Flush());
+  BOOST_CHECK_EQUAL(store.GetSize(), idents.size());
+  BOOST_CHECK(store.Get(idents[1]) == payloads[1]);
+}
+
+BOOST_AUTO_TEST_CASE(Reopen) {
+  BOOST_REQUIRE(store.Open(path));
+  PutAll();
+  store.Erase(idents[0]);
+  // Latest record wins
+  store.Put(idents[2], payloads[1].data(), payloads[1].size());
+  store.Close();
+  NetDbStore reopened;
+  BOOST_REQUIRE(reopened.Open(path));
+  BOOST_CHECK_EQUAL(reopened.GetSize(), 2);
+  BOOST_CHECK(reopened.Get(idents[0]).empty());
+  BOOST_CHECK(reopened.Get(idents[1]) == payloads[1]);
+  BOOST_CHECK(reopened.Get(idents[2]) == payloads[1]);
+  std::size_t count = 0;
+  reopened.ForEach([&count](const std::uint8_t*, std::size_t len) {
+    BOOST_CHECK_EQUAL(len, 101);
+    count++;
+  });
+  BOOST_CHECK_EQUAL(count, 2);
+}
+
+BOOST_AUTO_TEST_CASE(TornTailIsDropped) {
+  BOOST_REQUIRE(store.Open(path));
+  PutAll();
+  store.Close();
+  const auto size = boost::filesystem::file_size(path);
+  // A crash in the middle of an append
+  boost::filesystem::resize_file(path, size - 10);
+  BOOST_REQUIRE(store.Open(path));
+  BOOST_CHECK_EQUAL(store.GetSize(), 2);
+  BOOST_CHECK(store.Get(idents[2]).empty());
+  BOOST_CHECK_EQUAL(
+      boost::filesystem::file_size(path),
+      size - payloads[2].size() - GetType(NetDbStoreSize::RecordHeader));
+  // Appends continue from the last valid record
+  store.Put(idents[2], payloads[2].data(), payloads[2].size());
+  BOOST_REQUIRE(store.Flush());
+  store.Close();
+  BOOST_REQUIRE(store.Open(path));
+  BOOST_CHECK(store.Get(idents[2]) == payloads[2]);
+}
+
+BOOST_AUTO_TEST_CASE(CorruptRecordIsDropped) {
+  BOOST_REQUIRE(store.Open(path));
+  PutAll();
+  store.Close();
+  {
+    // Flip a byte in the payload of the last record
+    std::fstream f(
+        path.string(),
+        std::fstream::binary | std::fstream::in | std::fstream::out);
+    f.seekp(-1, std::ios::end);
+    f.put(0x55);
+  }
+  BOOST_REQUIRE(store.Open(path));
+  BOOST_CHECK_EQUAL(store.GetSize(), 2);
+  BOOST_CHECK(store.Get(idents[2]).empty());
+}
+
+BOOST_AUTO_TEST_CASE(CorruptRecordIsSkipped) {
+  BOOST_REQUIRE(store.Open(path));
+  PutAll();
+  store.Close();
+  const auto size = boost::filesystem::file_size(path);
+  // Flip a byte in the payload of the first record
+  Corrupt(GetOffset(1) - 1, {0x55});
+  BOOST_REQUIRE(store.Open(path));
+  BOOST_CHECK_EQUAL(store.GetSize(), 2);
+  BOOST_CHECK(store.Get(idents[0]).empty());
+  BOOST_CHECK(store.Get(idents[1]) == payloads[1]);
+  BOOST_CHECK(store.Get(idents[2]) == payloads[2]);
+  BOOST_CHECK_EQUAL(boost::filesystem::file_size(path), size);
+}
+
+BOOST_AUTO_TEST_CASE(CorruptLengthIsSkipped) {
+  BOOST_REQUIRE(store.Open(path));
+  PutAll();
+  store.Close();
+  const auto size = boost::filesystem::file_size(path);
+  // Length of the first record out of range, then past the end of file
+  for (const std::vector<std::uint8_t>& len
+       : {std::vector<std::uint8_t>{0xFF, 0x00, 0x00, 0x00},
+          std::vector<std::uint8_t>{0x00, 0x00, 0x07, 0xFF}}) {
+    Corrupt(GetOffset(0), len);
+    BOOST_REQUIRE(store.Open(path));
+    BOOST_CHECK_EQUAL(store.GetSize(), 2);
+    BOOST_CHECK(store.Get(idents[1]) == payloads[1]);
+    BOOST_CHECK(store.Get(idents[2]) == payloads[2]);
+    BOOST_CHECK_EQUAL(boost::filesystem::file_size(path), size);
+    store.Close();
+  }
+}
+
+BOOST_AUTO_TEST_CASE(NotAStoreIsMovedAside) {
+  {
+    std::ofstream f(path.string(), std::ofstream::binary);
+    f << "not a netdb store";
+  }
+  BOOST_REQUIRE(store.Open(path));
+  BOOST_CHECK_EQUAL(store.GetSize(), 0);
+  BOOST_CHECK_EQUAL(
+      store.GetFileSize(),
+      GetType(NetDbStoreSize::FileHeader));
+  BOOST_CHECK(boost::filesystem::exists(path.string() + ".bad"));
+  PutAll();
+  BOOST_REQUIRE(store.Flush());
+  BOOST_CHECK_EQUAL(store.GetSize(), idents.size());
+}
+
+BOOST_AUTO_TEST_CASE(Compact) {
+  BOOST_REQUIRE(store.Open(path));
+  // Many updates of the same RouterInfos
+  for (std::size_t i = 0; i < 100; i++)
+    PutAll();
+  BOOST_REQUIRE(store.Flush());
+  const auto size = store.GetFileSize();
+  BOOST_REQUIRE(store.Compact());
+  BOOST_CHECK_LT(store.GetFileSize(), size / 50);
+  BOOST_CHECK_EQUAL(store.GetSize(), idents.size());
+  for (std::size_t i = 0; i < idents.size(); i++)
+    BOOST_CHECK(store.Get(idents[i]) == payloads[i]);
+  store.Close();
+  BOOST_REQUIRE(store.Open(path));
+  BOOST_CHECK_EQUAL(store.GetSize(), idents.size());
+}
+
+BOOST_AUTO_TEST_CASE(FlushCompactsStaleFile) {
+  BOOST_REQUIRE(store.Open(path));
+  std::vector<std::uint8_t> payload(
+      GetType(NetDbStoreSize::MaxPayload), 0xAA);
+  // Enough rewrites of one RouterInfo to exceed the compaction threshold
+  const std::size_t num =
+    GetType(NetDbStoreSize::MinCompaction) / payload.size() + 1;
+  for (std::size_t i = 0; i < num; i++)
+    store.Put(idents[0], payload.data(), payload.size());
+  BOOST_REQUIRE(store.Flush());
+  BOOST_CHECK_EQUAL(
+      store.GetFileSize(),
+      GetType(NetDbStoreSize::FileHeader)
+      + GetType(NetDbStoreSize::RecordHeader) + payload.size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
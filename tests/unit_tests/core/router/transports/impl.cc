@@ -0,0 +1,98 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/asio.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <future>
+#include <memory>
+
+#include "core/router/context.h"
+#include "core/router/transports/impl.h"
+
+/// @brief Transports running sessions on their own threads, without servers
+struct TransportsFixture {
+  TransportsFixture() {
+    kovri::context.SetOptionTransportThreads(NumThreads);
+  }
+
+  ~TransportsFixture() {
+    kovri::context.SetOptionTransportThreads(1);
+  }
+
+  /// @return Whether a handler posted to the given service runs
+  bool RunsHandler(
+      boost::asio::io_service& service) {
+    auto ran = std::make_shared<std::promise<void>>();
+    service.post([ran]() { ran->set_value(); });
+    return ran->get_future().wait_for(std::chrono::seconds(5))
+        == std::future_status::ready;
+  }
+
+  /// @return Whether handlers run on the transports and all session services
+  bool RunsAllServices() {
+    if (!RunsHandler(transports.GetService()))
+      return false;
+    for (std::size_t i = 0; i < NumThreads; i++)
+      if (!RunsHandler(transports.GetSessionService()))
+        return false;
+    return true;
+  }
+
+  static const std::size_t NumThreads = 3;
+  kovri::core::Transports transports;
+};
+
+BOOST_FIXTURE_TEST_SUITE(TransportsTests, TransportsFixture)
+
+BOOST_AUTO_TEST_CASE(StartsAndStops) {
+  transports.Start();
+  BOOST_CHECK(RunsAllServices());
+  transports.Stop();
+}
+
+BOOST_AUTO_TEST_CASE(Restarts) {
+  transports.Start();
+  transports.Stop();
+  transports.Start();
+  BOOST_CHECK(RunsAllServices());
+  transports.Stop();
+}
+
+BOOST_AUTO_TEST_CASE(StopsWithoutStart) {
+  transports.Stop();
+  transports.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,106 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+
+#include "core/router/transports/ssu/congestion.h"
+
+#include "core/util/byte_stream.h"
+
+using kovri::core::GetType;
+using kovri::core::SSUCongestion;
+using kovri::core::SSUCongestionControl;
+
+BOOST_AUTO_TEST_SUITE(SSUCongestionTests)
+
+BOOST_AUTO_TEST_CASE(InitialState) {
+  SSUCongestionControl congestion;
+  BOOST_CHECK_EQUAL(congestion.GetRTT(), 0);
+  BOOST_CHECK_EQUAL(congestion.GetRTO(), GetType(SSUCongestion::InitialRTO));
+  BOOST_CHECK_EQUAL(
+      congestion.GetWindow(), GetType(SSUCongestion::InitialWindow));
+  BOOST_CHECK(congestion.CanSend(GetType(SSUCongestion::InitialWindow) - 1));
+  BOOST_CHECK(!congestion.CanSend(GetType(SSUCongestion::InitialWindow)));
+}
+
+BOOST_AUTO_TEST_CASE(RTOFollowsSamples) {
+  SSUCongestionControl congestion;
+  // RTO = SRTT + 4 * RTTVAR = 200 + 4 * 100
+  congestion.UpdateRTT(200);
+  BOOST_CHECK_EQUAL(congestion.GetRTT(), 200);
+  BOOST_CHECK_EQUAL(congestion.GetRTO(), 600);
+  // Steady samples converge towards RTT, down to the minimum
+  for (int i = 0; i < 100; i++)
+    congestion.UpdateRTT(20);
+  BOOST_CHECK_EQUAL(congestion.GetRTT(), 20);
+  BOOST_CHECK_EQUAL(congestion.GetRTO(), GetType(SSUCongestion::MinRTO));
+  // Huge samples are capped
+  congestion.UpdateRTT(60000);
+  BOOST_CHECK_EQUAL(congestion.GetRTO(), GetType(SSUCongestion::MaxRTO));
+}
+
+BOOST_AUTO_TEST_CASE(TimeoutBacksOff) {
+  SSUCongestionControl congestion;
+  congestion.UpdateRTT(200);
+  congestion.OnACK(12);  // slow start: 4 + 12
+  BOOST_CHECK_EQUAL(congestion.GetWindow(), 16);
+  congestion.OnTimeout();
+  BOOST_CHECK_EQUAL(congestion.GetWindow(), 8);
+  BOOST_CHECK_EQUAL(congestion.GetRTO(), 1200);
+  congestion.OnTimeout();
+  BOOST_CHECK_EQUAL(congestion.GetWindow(), 4);
+  BOOST_CHECK_EQUAL(congestion.GetRTO(), 2400);
+  for (int i = 0; i < 10; i++)
+    congestion.OnTimeout();
+  BOOST_CHECK_EQUAL(congestion.GetWindow(), GetType(SSUCongestion::MinWindow));
+  BOOST_CHECK_EQUAL(congestion.GetRTO(), GetType(SSUCongestion::MaxRTO));
+  // A new sample resets backoff
+  congestion.UpdateRTT(200);
+  BOOST_CHECK_LT(congestion.GetRTO(), GetType(SSUCongestion::MaxRTO));
+}
+
+BOOST_AUTO_TEST_CASE(CongestionAvoidanceIsLinear) {
+  SSUCongestionControl congestion;
+  congestion.OnACK(12);
+  congestion.OnTimeout();  // window and threshold are now 8
+  congestion.OnACK(7);
+  BOOST_CHECK_EQUAL(congestion.GetWindow(), 8);
+  congestion.OnACK(1);  // a window's worth of ACKs
+  BOOST_CHECK_EQUAL(congestion.GetWindow(), 9);
+  congestion.OnACK(1000000);
+  BOOST_CHECK_LE(congestion.GetWindow(), GetType(SSUCongestion::MaxWindow));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
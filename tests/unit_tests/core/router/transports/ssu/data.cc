@@ -0,0 +1,287 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/asio.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "core/router/i2np.h"
+#include "core/router/transports/ssu/data.h"
+#include "core/router/transports/ssu/server.h"
+#include "core/router/transports/ssu/session.h"
+
+#include "core/util/i2p_endian.h"
+
+using kovri::core::GetType;
+using kovri::core::SSUCongestion;
+using kovri::core::SSUData;
+using kovri::core::SSUDuration;
+using kovri::core::SSUFlag;
+
+/// @brief Two SSUData linked by a simulated network, on a simulated clock
+struct SSUDataFixture {
+  typedef std::vector<std::uint8_t> Payload;
+
+  struct Packet {
+    std::uint64_t delivery_time;
+    SSUData* to;
+    Payload payload;
+  };
+
+  SSUDataFixture()
+      : server(service, 0),
+        endpoint(boost::asio::ip::address_v4::loopback(), 0),
+        sender_session(
+            std::make_shared<kovri::core::SSUSession>(
+                server, service, endpoint)),
+        receiver_session(
+            std::make_shared<kovri::core::SSUSession>(
+                server, service, endpoint)),
+        sender(*sender_session),
+        receiver(*receiver_session),
+        now(1000000),
+        delay(20),
+        loss_rate(0),
+        random(1) {  // Deterministic losses
+    auto clock = [this]() { return now; };
+    sender.SetClock(clock);
+    receiver.SetClock(clock);
+    sender.SetPayloadHandler(
+        [this](std::uint8_t* buf, std::size_t len) {
+          Transmit(&receiver, Payload(buf, buf + len));
+        });
+    receiver.SetPayloadHandler(
+        [this](std::uint8_t* buf, std::size_t len) {
+          ReadACKs(buf);
+          Transmit(&sender, Payload(buf, buf + len));
+        });
+  }
+
+  ~SSUDataFixture() {
+    sender.Stop();
+    receiver.Stop();
+    // Aborted timers release their sessions
+    service.poll();
+  }
+
+  std::shared_ptr<kovri::core::I2NPMessage> CreateMessage(
+      std::size_t len) {
+    std::vector<std::uint8_t> buf(len, 0xAB);
+    return kovri::core::ToSharedI2NPMessage(
+        kovri::core::CreateI2NPMessage(
+            kovri::core::I2NPData, buf.data(), buf.size()));
+  }
+
+  /// @brief Puts payload on the link, unless it is lost
+  void Transmit(
+      SSUData* to,
+      Payload payload) {
+    std::bernoulli_distribution is_lost(loss_rate);
+    if (!is_lost(random))
+      link.push_back({now + delay, to, payload});
+  }
+
+  /// @brief Collects message IDs ACKed explicitly by receiver
+  void ReadACKs(
+      const std::uint8_t* buf) {
+    if (!(buf[0] & GetType(SSUFlag::DataExplicitACKsIncluded)))
+      return;
+    for (std::size_t i = 0; i < buf[1]; i++)
+      acked.insert(bufbe32toh(buf + 2 + i * 4));
+  }
+
+  /// @brief Advances clock by a millisecond, firing due timers and packets
+  void Tick() {
+    now++;
+    while (!link.empty() && link.front().delivery_time <= now) {
+      auto packet = link.front();
+      link.pop_front();
+      packet.to->ProcessMessage(packet.payload.data(), packet.payload.size());
+    }
+    if (!(now % GetType(SSUDuration::PackDelay)))
+      sender.FlushPacket();
+    if (!(now % GetType(SSUDuration::ACKDelay)))
+      receiver.SendPendingACKs();
+    const auto resend_time = sender.GetNextResendTime();
+    if (resend_time && now >= resend_time)
+      sender.Resend();
+  }
+
+  /// @brief Sends given number of messages, then runs the link until
+  ///   sender has nothing left to send or timeout
+  void Transfer(
+      std::size_t num_messages,
+      std::size_t len,
+      std::uint64_t timeout) {
+    for (std::size_t i = 0; i < num_messages; i++) {
+      auto msg = CreateMessage(len);
+      msg_ids.insert(msg->GetMsgID());
+      sender.Send(msg);
+    }
+    sender.FlushPacket();
+    const auto deadline = now + timeout;
+    while ((sender.GetNumSentMessages() || sender.GetNumQueuedMessages())
+           && now < deadline)
+      Tick();
+  }
+
+  /// @brief Hands sender an ACK bitfield of one message
+  void ReceiveBitfields(
+      std::uint32_t msg_id,
+      const std::vector<std::uint8_t>& bitfields) {
+    Payload payload {GetType(SSUFlag::DataACKBitfieldsIncluded), 1, 0, 0, 0, 0};
+    htobe32buf(payload.data() + 2, msg_id);
+    payload.insert(payload.end(), bitfields.begin(), bitfields.end());
+    payload.push_back(0);  // no fragments
+    sender.ProcessMessage(payload.data(), payload.size());
+  }
+
+  boost::asio::io_service service;
+  kovri::core::SSUServer server;
+  boost::asio::ip::udp::endpoint endpoint;
+  std::shared_ptr<kovri::core::SSUSession> sender_session, receiver_session;
+  SSUData sender, receiver;
+  std::uint64_t now, delay;
+  double loss_rate;
+  std::mt19937 random;
+  std::deque<Packet> link;
+  std::set<std::uint32_t> msg_ids, acked;
+};
+
+BOOST_FIXTURE_TEST_SUITE(SSUDataTests, SSUDataFixture)
+
+BOOST_AUTO_TEST_CASE(LosslessTransferOpensWindow) {
+  // 3 fragments each, far more than the initial window
+  Transfer(50, 3000, 10000);
+  BOOST_CHECK(acked == msg_ids);
+  BOOST_CHECK_EQUAL(sender.GetNumSentMessages(), 0);
+  BOOST_CHECK_EQUAL(sender.GetNumQueuedMessages(), 0);
+  BOOST_CHECK_EQUAL(sender.GetNumInFlight(), 0);
+  BOOST_CHECK_EQUAL(sender.GetNumRetransmits(), 0);
+  BOOST_CHECK_GT(
+      sender.GetCongestionWindow(),
+      GetType(SSUCongestion::InitialWindow));
+  // Round trip plus ACK delay
+  BOOST_CHECK_GE(sender.GetRTT(), 2 * delay);
+  BOOST_CHECK_LE(sender.GetRTT(), 2 * delay + GetType(SSUDuration::ACKDelay));
+}
+
+BOOST_AUTO_TEST_CASE(WindowLimitsFragmentsInFlight) {
+  for (std::size_t i = 0; i < 10; i++)
+    sender.Send(CreateMessage(3000));
+  BOOST_CHECK_LE(
+      sender.GetNumInFlight(),
+      GetType(SSUCongestion::InitialWindow) + 2);  // Last message may overlap
+  BOOST_CHECK_GT(sender.GetNumQueuedMessages(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(LossyTransferRecovers) {
+  loss_rate = 0.1;
+  Transfer(100, 3000, 1000 * GetType(SSUDuration::MessageLifetime));
+  // Nothing was given up on
+  BOOST_CHECK(acked == msg_ids);
+  BOOST_CHECK_EQUAL(sender.GetNumSentMessages(), 0);
+  BOOST_CHECK_EQUAL(sender.GetNumInFlight(), 0);
+  BOOST_CHECK_GT(sender.GetNumRetransmits(), 0);
+  BOOST_CHECK_GE(
+      sender.GetCongestionWindow(),
+      GetType(SSUCongestion::MinWindow));
+}
+
+BOOST_AUTO_TEST_CASE(KarnsRuleSkipsResentMessages) {
+  loss_rate = 1;
+  Transfer(1, 100, GetType(SSUCongestion::InitialRTO) + 1);
+  BOOST_REQUIRE_EQUAL(sender.GetNumRetransmits(), 1);
+  // ACK of a resent message doesn't give an RTT sample
+  loss_rate = 0;
+  Transfer(0, 0, 10000);
+  BOOST_CHECK_EQUAL(sender.GetNumSentMessages(), 0);
+  BOOST_CHECK_EQUAL(sender.GetRTT(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(BitfieldACKedMessageDoesNotTimeOut) {
+  loss_rate = 1;
+  auto msg = CreateMessage(3000);
+  const auto msg_id = msg->GetMsgID();
+  sender.Send(msg);
+  sender.FlushPacket();
+  BOOST_REQUIRE_EQUAL(sender.GetNumInFlight(), 3);
+  ReceiveBitfields(msg_id, {0x07});
+  BOOST_CHECK_EQUAL(sender.GetNumInFlight(), 0);
+  BOOST_CHECK_EQUAL(sender.GetNumSentMessages(), 0);
+  const auto window = sender.GetCongestionWindow();
+  now += GetType(SSUCongestion::InitialRTO);
+  sender.Resend();
+  BOOST_CHECK_EQUAL(sender.GetCongestionWindow(), window);
+  BOOST_CHECK_EQUAL(sender.GetNumRetransmits(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(EmptyBitfieldBytesCountFragments) {
+  loss_rate = 1;
+  // More than 7 fragments
+  auto msg = CreateMessage(12000);
+  const auto msg_id = msg->GetMsgID();
+  sender.Send(msg);
+  sender.FlushPacket();
+  const auto num_fragments = sender.GetNumInFlight();
+  BOOST_REQUIRE_GT(num_fragments, 8);
+  // Fragments 0 to 6 not received, fragment 7 received
+  ReceiveBitfields(msg_id, {GetType(SSUFlag::DataACKBitFieldHasNext), 0x01});
+  BOOST_CHECK_EQUAL(sender.GetNumInFlight(), num_fragments - 1);
+  // Fragment 0 is still unACKed
+  ReceiveBitfields(msg_id, {0x01});
+  BOOST_CHECK_EQUAL(sender.GetNumInFlight(), num_fragments - 2);
+  now += GetType(SSUCongestion::InitialRTO);
+  sender.Resend();
+  BOOST_CHECK_EQUAL(sender.GetNumRetransmits(), num_fragments - 2);
+}
+
+BOOST_AUTO_TEST_CASE(MessageIsGivenUpAfterLifetime) {
+  loss_rate = 1;
+  const std::uint64_t lifetime =
+    1000 * GetType(SSUDuration::MessageLifetime);
+  Transfer(1, 3000, lifetime - 1);
+  BOOST_CHECK_EQUAL(sender.GetNumSentMessages(), 1);
+  BOOST_CHECK_GT(sender.GetNumRetransmits(), 0);
+  Transfer(0, 0, 2);
+  BOOST_CHECK_EQUAL(sender.GetNumSentMessages(), 0);
+  BOOST_CHECK_EQUAL(sender.GetNumInFlight(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
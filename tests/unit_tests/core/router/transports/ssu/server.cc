@@ -0,0 +1,154 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/asio.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "core/router/context.h"
+#include "core/router/transports/ssu/server.h"
+
+// Shards share a port through SO_REUSEPORT, without it there is only one
+#if defined(__linux__) && defined(SO_REUSEPORT)
+
+using boost::asio::ip::udp;
+
+/// @brief Server with two shards, bound to ephemeral ports so that each
+///   test picks the shard receiving a packet, and two peers sending to it
+struct SSUServerFixture {
+  struct ShardsOption {
+    ShardsOption() {
+      kovri::context.SetOptionSSUShards(2);
+    }
+
+    ~ShardsOption() {
+      kovri::context.SetOptionSSUShards(1);
+    }
+  };
+
+  SSUServerFixture()
+      : server(service, 0),
+        peer(peer_service, udp::endpoint(udp::v4(), 0)),
+        other_peer(peer_service, udp::endpoint(udp::v4(), 0)) {
+    server.Start();
+  }
+
+  ~SSUServerFixture() {
+    server.Stop();
+  }
+
+  /// @brief Sends a datagram of given length from peer to shard
+  void Send(
+      udp::socket& from,
+      std::size_t shard,
+      std::size_t len) {
+    const std::vector<std::uint8_t> buf(len, 0xAB);
+    from.send_to(
+        boost::asio::buffer(buf),
+        udp::endpoint(
+            boost::asio::ip::address_v4::loopback(),
+            server.GetShardEndpoint(shard).port()));
+  }
+
+  /// @return Endpoint which the server sees packets from peer come from
+  udp::endpoint GetEndpoint(
+      const udp::socket& of) const {
+    return udp::endpoint(
+        boost::asio::ip::address_v4::loopback(),
+        of.local_endpoint().port());
+  }
+
+  /// @brief Runs the first shard until condition holds
+  /// @return False on timeout
+  template <typename Condition>
+  bool RunUntil(
+      Condition condition) {
+    const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition()) {
+      if (std::chrono::steady_clock::now() > deadline)
+        return false;
+      service.poll();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+  }
+
+  ShardsOption option;
+  boost::asio::io_service service, peer_service;
+  kovri::core::SSUServer server;
+  udp::socket peer, other_peer;
+};
+
+BOOST_FIXTURE_TEST_SUITE(SSUServerTests, SSUServerFixture)
+
+BOOST_AUTO_TEST_CASE(RoutesPacketsToReceivingShard) {
+  BOOST_REQUIRE_EQUAL(server.GetNumShards(), 2);
+  Send(peer, 0, 100);
+  Send(other_peer, 1, 100);
+  BOOST_REQUIRE(
+      RunUntil([this]() {
+        return server.GetNumSessions() == 2;
+      }));
+  auto session = server.FindSession(GetEndpoint(peer));
+  auto other_session = server.FindSession(GetEndpoint(other_peer));
+  BOOST_REQUIRE(session && other_session);
+  // The first shard runs on the given service, the second on its own
+  BOOST_CHECK(&session->GetService() == &service);
+  BOOST_CHECK(&other_session->GetService() != &service);
+}
+
+BOOST_AUTO_TEST_CASE(ForwardsPacketsToOwningShard) {
+  BOOST_REQUIRE_EQUAL(server.GetNumShards(), 2);
+  Send(peer, 0, 100);
+  BOOST_REQUIRE(
+      RunUntil([this]() {
+        return server.FindSession(GetEndpoint(peer)) != nullptr;
+      }));
+  auto session = server.FindSession(GetEndpoint(peer));
+  // Arrives on the second shard, which hands it to the session on the first
+  Send(peer, 1, 200);
+  BOOST_CHECK(
+      RunUntil([&session]() {
+        return session->GetNumReceivedBytes() == 300;
+      }));
+  BOOST_CHECK_EQUAL(server.GetNumSessions(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif
@@ -0,0 +1,111 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "core/crypto/rand.h"
+#include "core/util/bloom_filter.h"
+
+BOOST_AUTO_TEST_SUITE(BloomFilterTests)
+
+struct BloomFilterFixture {
+  BloomFilterFixture()
+      : filter(Capacity, 0.001, std::chrono::seconds(3600)),
+        records(2 * Capacity * RecordSize) {
+    kovri::core::RandBytes(records.data(), records.size());
+  }
+
+  const std::uint8_t* GetRecord(std::size_t i) const {
+    return records.data() + i * RecordSize;
+  }
+
+  static const std::size_t Capacity = 10000, RecordSize = 512;
+  kovri::core::RotatingBloomFilter filter;
+  std::vector<std::uint8_t> records;
+};
+
+BOOST_FIXTURE_TEST_CASE(DetectsReplays, BloomFilterFixture) {
+  for (std::size_t i = 0; i < Capacity; i++)
+    filter.CheckAndInsert(GetRecord(i), RecordSize);
+  // No false negatives
+  for (std::size_t i = 0; i < Capacity; i++)
+    BOOST_CHECK(filter.CheckAndInsert(GetRecord(i), RecordSize));
+}
+
+BOOST_FIXTURE_TEST_CASE(BoundsFalsePositiveRate, BloomFilterFixture) {
+  for (std::size_t i = 0; i < Capacity; i++)
+    filter.CheckAndInsert(GetRecord(i), RecordSize);
+  std::size_t false_positives = 0;
+  for (std::size_t i = Capacity; i < 2 * Capacity; i++)
+    if (filter.Contains(GetRecord(i), RecordSize))
+      false_positives++;
+  // Expected 10 at 0.1%, allow for variance
+  BOOST_CHECK_LT(false_positives, 40);
+}
+
+BOOST_FIXTURE_TEST_CASE(ForgetsAfterTwoGenerations, BloomFilterFixture) {
+  filter.CheckAndInsert(GetRecord(0), RecordSize);
+  filter.Rotate();
+  BOOST_CHECK(filter.Contains(GetRecord(0), RecordSize));
+  filter.Rotate();
+  BOOST_CHECK(!filter.Contains(GetRecord(0), RecordSize));
+}
+
+BOOST_FIXTURE_TEST_CASE(RotatesWhenFull, BloomFilterFixture) {
+  // A flood past capacity must not saturate the filter
+  for (std::size_t i = 0; i < 2 * Capacity; i++)
+    filter.CheckAndInsert(GetRecord(i), RecordSize);
+  std::vector<std::uint8_t> unseen(RecordSize);
+  std::size_t false_positives = 0;
+  for (std::size_t i = 0; i < Capacity; i++) {
+    kovri::core::RandBytes(unseen.data(), unseen.size());
+    if (filter.Contains(unseen.data(), unseen.size()))
+      false_positives++;
+  }
+  // Two full generations, so up to twice the target rate
+  BOOST_CHECK_LT(false_positives, 80);
+}
+
+BOOST_AUTO_TEST_CASE(ExpiresOverTime) {
+  kovri::core::RotatingBloomFilter filter(
+      100, 0.001, std::chrono::seconds(0));
+  const std::uint8_t record[4] = { 1, 2, 3, 4 };
+  filter.CheckAndInsert(record, sizeof(record));
+  BOOST_CHECK(!filter.Contains(record, sizeof(record)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,85 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+#include <vector>
+
+#include "core/util/memory_pool.h"
+
+BOOST_AUTO_TEST_SUITE(MemoryPoolTests)
+
+// Odd block sizes so that no other user of the pools interferes
+BOOST_AUTO_TEST_CASE(RecyclesFreedBlocks) {
+  auto& pool = kovri::core::MemoryPool<1031>::Instance();
+  auto block = pool.Allocate();
+  BOOST_CHECK_EQUAL(pool.GetMisses(), 1);
+  BOOST_CHECK_EQUAL(pool.GetInUse(), 1);
+  pool.Free(block);
+  BOOST_CHECK_EQUAL(pool.GetInUse(), 0);
+  BOOST_CHECK_EQUAL(pool.Allocate(), block);
+  BOOST_CHECK_EQUAL(pool.GetHits(), 1);
+  BOOST_CHECK_EQUAL(pool.GetMisses(), 1);
+  pool.Free(block);
+}
+
+BOOST_AUTO_TEST_CASE(TracksHighWaterMark) {
+  auto& pool = kovri::core::MemoryPool<1033>::Instance();
+  std::vector<void*> blocks;
+  for (int i = 0; i < 10; i++)
+    blocks.push_back(pool.Allocate());
+  for (auto block : blocks)
+    pool.Free(block);
+  BOOST_CHECK_EQUAL(pool.GetInUse(), 0);
+  BOOST_CHECK_EQUAL(pool.GetHighWaterMark(), 10);
+  auto block = pool.Allocate();
+  BOOST_CHECK_EQUAL(pool.GetHighWaterMark(), 10);
+  pool.Free(block);
+}
+
+BOOST_AUTO_TEST_CASE(RecyclesAcrossThreads) {
+  auto& pool = kovri::core::MemoryPool<1039>::Instance();
+  void* block = nullptr;
+  std::thread([&pool, &block]() { block = pool.Allocate(); }).join();
+  // Freed here, then handed back through the shared list at thread exit
+  std::thread([&pool, block]() { pool.Free(block); }).join();
+  std::thread([&pool, block]() {
+    BOOST_CHECK_EQUAL(pool.Allocate(), block);
+  }).join();
+  BOOST_CHECK_EQUAL(pool.GetHits(), 1);
+  BOOST_CHECK_EQUAL(pool.GetMisses(), 1);
+  pool.Free(block);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,99 @@
+/**                                                                                           //
+ * Copyright (c) 2013-2017, The Kovri I2P Router Project                                      //
+ *                                                                                            //
+ * All rights reserved.                                                                       //
+ *                                                                                            //
+ * Redistribution and use in source and binary forms, with or without modification, are       //
+ * permitted provided that the following conditions are met:                                  //
+ *                                                                                            //
+ * 1. Redistributions of source code must retain the above copyright notice, this list of     //
+ *    conditions and the following disclaimer.                                                //
+ *                                                                                            //
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list     //
+ *    of conditions and the following disclaimer in the documentation and/or other            //
+ *    materials provided with the distribution.                                               //
+ *                                                                                            //
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be       //
+ *    used to endorse or promote products derived from this software without specific         //
+ *    prior written permission.                                                               //
+ *                                                                                            //
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY        //
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF    //
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL     //
+ * THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,       //
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,               //
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS    //
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,          //
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF    //
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.               //
+ *                                                                                            //
+ */
+
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "core/util/queue.h"
+
+BOOST_AUTO_TEST_SUITE(MPSCQueueTests)
+
+struct MPSCQueueFixture {
+  std::shared_ptr<int> Make(int i) {
+    return std::make_shared<int>(i);
+  }
+
+  kovri::core::MPSCQueue<std::shared_ptr<int> > queue;
+};
+
+BOOST_FIXTURE_TEST_CASE(KeepsOrder, MPSCQueueFixture) {
+  BOOST_CHECK(queue.IsEmpty());
+  BOOST_CHECK(!queue.Get());
+  queue.Put(Make(1));
+  queue.Put({ Make(2), Make(3), Make(4) });
+  BOOST_CHECK_EQUAL(queue.GetSize(), 4);
+  BOOST_CHECK_EQUAL(*queue.Get(), 1);
+  std::vector<std::shared_ptr<int> > batch;
+  BOOST_CHECK_EQUAL(queue.Get(batch, 2), 2);
+  BOOST_CHECK_EQUAL(*batch.at(0), 2);
+  BOOST_CHECK_EQUAL(*batch.at(1), 3);
+  BOOST_CHECK_EQUAL(*queue.GetNextWithTimeout(0), 4);
+  BOOST_CHECK(queue.IsEmpty());
+  BOOST_CHECK_EQUAL(queue.GetSize(), 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(WakeUpWithoutElement, MPSCQueueFixture) {
+  std::thread consumer([this]() { BOOST_CHECK(!queue.GetNext()); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  queue.WakeUp();
+  consumer.join();
+}
+
+BOOST_FIXTURE_TEST_CASE(ManyProducers, MPSCQueueFixture) {
+  const int num_producers = 4, num_elements = 100000;
+  std::vector<std::thread> producers;
+  for (int p = 0; p < num_producers; p++)
+    producers.emplace_back([this, p]() {
+      for (int i = 0; i < num_elements; i += 2) {
+        queue.Put(Make(p * num_elements + i));
+        queue.Put({ Make(p * num_elements + i + 1) });
+      }
+    });
+  // Every producer's elements arrive once, in order
+  std::vector<int> next(num_producers, 0);
+  for (int received = 0; received < num_producers * num_elements; received++) {
+    auto el = queue.GetNextWithTimeout(1000);
+    BOOST_REQUIRE(el);
+    int p = *el / num_elements;
+    BOOST_REQUIRE_EQUAL(*el % num_elements, next.at(p)++);
+  }
+  for (auto& producer : producers)
+    producer.join();
+  BOOST_CHECK(queue.IsEmpty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()